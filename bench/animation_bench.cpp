@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_animation.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kTrackCount = 64;
+static constexpr uint32_t kKeyCount = 121;
+static constexpr float kFrameTime = 1.f / 30.f;
+static constexpr float kPlaybackStep = 1.f / 60.f;
+
+namespace {
+
+struct Translation {
+  vector_t value;
+};
+
+// Uncompressed reference representation: one time, quaternion and translation
+// per key, sampled by binary search and Slerp.
+struct RawTrack {
+  std::vector<float> times;
+  std::vector<CQuaternion> rotations;
+  std::vector<Translation> translations;
+
+  void Sample(float time, CQuaternion &rotation, vector_t &translation) const {
+    auto next = std::upper_bound(times.begin(), times.end(), time);
+    if (next == times.begin()) {
+      next = times.begin() + 1;
+    } else if (next == times.end()) {
+      next = times.end() - 1;
+    }
+    auto index = static_cast<uint32_t>(next - times.begin());
+    float alpha = (time - times[index - 1]) / (times[index] - times[index - 1]);
+    alpha = std::min(1.f, std::max(0.f, alpha));
+
+    rotation = Slerp(rotations[index - 1], rotations[index], alpha);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      const float from = translations[index - 1].value[axis];
+      const float to = translations[index].value[axis];
+      translation[axis] = from + (to - from) * alpha;
+    }
+    translation[3] = 1.f;
+  }
+};
+
+}  // namespace
+
+static void BuildTracks(std::vector<RawTrack> &raw_tracks,
+                        CAnimationClip &clip) {
+  raw_tracks.resize(kTrackCount);
+  for (uint32_t track = 0; track < kTrackCount; ++track) {
+    RawTrack &raw = raw_tracks[track];
+    raw.times.resize(kKeyCount);
+    raw.rotations.resize(kKeyCount);
+    raw.translations.resize(kKeyCount);
+    for (uint32_t key = 0; key < kKeyCount; ++key) {
+      const float t = static_cast<float>(key) * kFrameTime;
+      raw.times[key] = t;
+      raw.rotations[key].SetEuler(90.f * sinf(t + track), 45.f * cosf(t * 2.f),
+                                  10.f * track * t);
+      VectorSetVector(raw.translations[key].value, sinf(t) * track, 1.f + t,
+                      cosf(t * 3.f));
+    }
+    clip.AddTrack(raw.times.data(), raw.rotations.data(),
+                  &raw.translations.data()->value, kKeyCount);
+  }
+}
+
+BENCHMARK(animation_clip_sampling) {
+  std::vector<RawTrack> raw_tracks;
+  CAnimationClip clip;
+  BuildTracks(raw_tracks, clip);
+
+  size_t raw_bytes = 0;
+  for (const auto &raw : raw_tracks) {
+    raw_bytes += raw.times.capacity() * sizeof(float) +
+                 raw.rotations.capacity() * sizeof(CQuaternion) +
+                 raw.translations.capacity() * sizeof(Translation);
+  }
+  BenchmarkReport("raw clip memory", static_cast<double>(raw_bytes), "bytes");
+  BenchmarkReport("compressed clip memory",
+                  static_cast<double>(clip.GetMemoryUsage()), "bytes");
+
+  static constexpr uint32_t kFrames = 20000;
+  const float duration = clip.GetDuration();
+  CQuaternion rotations[kTrackCount];
+  vector_t translations[kTrackCount];
+
+  double raw_seconds = TimeIterations(kFrames, [&](uint32_t frame) {
+    const float time = fmodf(frame * kPlaybackStep, duration);
+    for (uint32_t track = 0; track < kTrackCount; ++track) {
+      raw_tracks[track].Sample(time, rotations[track], translations[track]);
+    }
+    DoNotOptimize(rotations);
+    DoNotOptimize(translations);
+  });
+
+  animationcursor_t cursors[kTrackCount];
+  for (auto &cursor : cursors) {
+    AnimationCursorReset(cursor);
+  }
+  double clip_seconds = TimeIterations(kFrames, [&](uint32_t frame) {
+    const float time = fmodf(frame * kPlaybackStep, duration);
+    clip.SampleAllTracks(time, cursors, rotations, translations);
+    DoNotOptimize(rotations);
+    DoNotOptimize(translations);
+  });
+
+  const double samples = static_cast<double>(kFrames) * kTrackCount;
+  BenchmarkReport("raw binary search + Slerp", samples / raw_seconds,
+                  "samples/s");
+  BenchmarkReport("compressed SampleAllTracks", samples / clip_seconds,
+                  "samples/s");
+}
@@ -0,0 +1,30 @@
+#include <cstring>
+
+#include "benchmark.h"
+
+namespace XboxMathBenchmark {
+
+static BenchmarkRegistration *registrations = nullptr;
+
+BenchmarkRegistration::BenchmarkRegistration(const char *name,
+                                             BenchmarkFunction function)
+    : name(name), function(function), next(registrations) {
+  registrations = this;
+}
+
+void RunBenchmarks(const char *filter) {
+  for (auto entry = registrations; entry; entry = entry->next) {
+    if (filter && !strstr(entry->name, filter)) {
+      continue;
+    }
+    printf("%s\n", entry->name);
+    entry->function();
+  }
+}
+
+}  // namespace XboxMathBenchmark
+
+int main(int argc, char **argv) {
+  XboxMathBenchmark::RunBenchmarks(argc > 1 ? argv[1] : nullptr);
+  return 0;
+}
@@ -0,0 +1,93 @@
+#ifndef XBOX_MATH_BENCHMARK_H_
+#define XBOX_MATH_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//! Minimal self-registering benchmark harness.
+//!
+//! BENCHMARK(name) { ... } defines a benchmark that is run by bench_main.cpp.
+//! Benchmarks report their own results via BenchmarkReport.
+namespace XboxMathBenchmark {
+
+typedef void (*BenchmarkFunction)();
+
+struct BenchmarkRegistration {
+  BenchmarkRegistration(const char *name, BenchmarkFunction function);
+
+  const char *name;
+  BenchmarkFunction function;
+  BenchmarkRegistration *next;
+};
+
+//! Runs every registered benchmark whose name contains `filter` (or all of
+//! them if `filter` is null).
+void RunBenchmarks(const char *filter);
+
+//! Returns the number of seconds taken to run `body` `iterations` times.
+template <typename Body>
+double TimeIterations(uint32_t iterations, Body body) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    body(i);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+//! Prevents the compiler from discarding a computed value.
+template <typename T>
+inline void DoNotOptimize(const T &value) {
+#if defined(_MSC_VER)
+  volatile char sink = *reinterpret_cast<const volatile char *>(&value);
+  (void)sink;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+//! A linear congruential generator, so that benchmarks run on the same data
+//! with every compiler and standard library.
+class CRandom {
+ public:
+  explicit CRandom(uint32_t seed) : m_seed(seed) {}
+
+  //! Advances the generator and returns its state. The high bits are the most
+  //! random.
+  uint32_t NextBits() {
+    m_seed = m_seed * 1664525u + 1013904223u;
+    return m_seed;
+  }
+
+  //! Returns a value in [`low`, `high`).
+  float operator()(float low, float high) {
+    return low +
+           (high - low) * static_cast<float>(NextBits() >> 8) / 16777216.f;
+  }
+
+ private:
+  uint32_t m_seed;
+};
+
+//! Prints a single named measurement.
+inline void BenchmarkReport(const char *label, double value,
+                            const char *units) {
+  printf("  %-48s %14.6g %s\n", label, value, units);
+}
+
+}  // namespace XboxMathBenchmark
+
+#define BENCHMARK(name)                                                \
+  static void name();                                                  \
+  static XboxMathBenchmark::BenchmarkRegistration name##_registration( \
+      #name, name);                                                    \
+  static void name()
+
+#endif  // XBOX_MATH_BENCHMARK_H_
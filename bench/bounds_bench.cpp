@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_bounds.h"
+#include "xbox_math_matrix.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kObjectCount = 10000;
+static constexpr uint32_t kIterations = 200;
+
+namespace {
+
+struct Matrix {
+  matrix4_t value;
+};
+
+// The per object code callers wrote before: VectorMultMatrix for the center
+// and the eight corners of each box.
+void TransformScalar(const boundingsphere_t &sphere, const aabb_t &box,
+                     const matrix4_t &matrix, float *sphere_ret,
+                     float *box_ret) {
+  vector_t center;
+  VectorMultMatrix(sphere.m_centerPt, matrix, center);
+  float scale = 0.f;
+  for (uint32_t row = 0; row < 3; ++row) {
+    scale = std::max(scale, sqrtf(matrix[row][0] * matrix[row][0] +
+                                  matrix[row][1] * matrix[row][1] +
+                                  matrix[row][2] * matrix[row][2]));
+  }
+  sphere_ret[0] = center[0];
+  sphere_ret[1] = center[1];
+  sphere_ret[2] = center[2];
+  sphere_ret[3] = sphere.m_radius * scale;
+
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    box_ret[axis] = 1e30f;
+    box_ret[axis + 3] = -1e30f;
+  }
+  for (uint32_t corner = 0; corner < 8; ++corner) {
+    const vector_t point = {corner & 1 ? box.m_maxPt[0] : box.m_minPt[0],
+                            corner & 2 ? box.m_maxPt[1] : box.m_minPt[1],
+                            corner & 4 ? box.m_maxPt[2] : box.m_minPt[2], 1.f};
+    vector_t transformed;
+    VectorMultMatrix(point, matrix, transformed);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      box_ret[axis] = std::min(box_ret[axis], transformed[axis]);
+      box_ret[axis + 3] = std::max(box_ret[axis + 3], transformed[axis]);
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(transform_bounds) {
+  std::vector<boundingsphere_t> spheres(kObjectCount);
+  std::vector<aabb_t> boxes(kObjectCount);
+  std::vector<Matrix> matrices(kObjectCount);
+  CRandom random(31);
+  for (uint32_t i = 0; i < kObjectCount; ++i) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      spheres[i].m_centerPt[axis] = random(-1.f, 1.f);
+      boxes[i].m_minPt[axis] = random(-2.f, -1.f);
+      boxes[i].m_maxPt[axis] = random(1.f, 2.f);
+    }
+    spheres[i].m_centerPt[3] = boxes[i].m_minPt[3] = boxes[i].m_maxPt[3] = 1.f;
+    spheres[i].m_radius = random(1.f, 3.f);
+    MatrixSetIdentity(matrices[i].value);
+    const vector_t rotation = {random(-3.f, 3.f), random(-3.f, 3.f),
+                               random(-3.f, 3.f), 1.f};
+    const vector_t translation = {random(-100.f, 100.f), random(-100.f, 100.f),
+                                  random(-100.f, 100.f), 1.f};
+    MatrixRotate(matrices[i].value, rotation);
+    MatrixTranslate(matrices[i].value, translation);
+  }
+  const auto *matrix_array = reinterpret_cast<const matrix4_t *>(
+      &matrices[0].value);
+
+  std::vector<float> aos(kObjectCount * 10);
+  double scalar_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+      TransformScalar(spheres[i], boxes[i], matrices[i].value, &aos[i * 10],
+                      &aos[i * 10 + 4]);
+    }
+    DoNotOptimize(aos[0]);
+  });
+
+  std::vector<float> soa(kObjectCount * 10);
+  boundingspheresoa_t sphere_ret;
+  sphere_ret.m_centerX = &soa[0];
+  sphere_ret.m_centerY = &soa[kObjectCount];
+  sphere_ret.m_centerZ = &soa[kObjectCount * 2];
+  sphere_ret.m_radius = &soa[kObjectCount * 3];
+  aabbsoa_t box_ret;
+  box_ret.m_minX = &soa[kObjectCount * 4];
+  box_ret.m_minY = &soa[kObjectCount * 5];
+  box_ret.m_minZ = &soa[kObjectCount * 6];
+  box_ret.m_maxX = &soa[kObjectCount * 7];
+  box_ret.m_maxY = &soa[kObjectCount * 8];
+  box_ret.m_maxZ = &soa[kObjectCount * 9];
+  double batch_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    TransformBoundingSpheres(spheres.data(), kObjectCount, matrix_array,
+                             sphere_ret);
+    TransformAABBs(boxes.data(), kObjectCount, matrix_array, box_ret);
+    DoNotOptimize(soa[0]);
+  });
+  double shared_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    TransformBoundingSpheres(spheres.data(), kObjectCount, matrix_array[0],
+                             sphere_ret);
+    TransformAABBs(boxes.data(), kObjectCount, matrix_array[0], box_ret);
+    DoNotOptimize(soa[0]);
+  });
+
+  const double objects = static_cast<double>(kObjectCount) * kIterations;
+  BenchmarkReport("per object, sphere and box corners",
+                  objects / scalar_seconds, "objects/s");
+  BenchmarkReport("batch, per object matrices", objects / batch_seconds,
+                  "objects/s");
+  BenchmarkReport("batch, shared matrix", objects / shared_seconds,
+                  "objects/s");
+  BenchmarkReport("speedup, per object matrices",
+                  scalar_seconds / batch_seconds, "x");
+}
+
+static constexpr uint32_t kPointCount = 100000;
+static constexpr uint32_t kSphereIterations = 50;
+
+BENCHMARK(bounding_sphere_from_points) {
+  // A lumpy ellipsoid with a thin arm held out to one side, like a character
+  // mesh, so most points are far from the minimum sphere's center.
+  std::vector<float> storage;
+  storage.reserve(kPointCount * 4);
+  CRandom random(77);
+  for (uint32_t i = 0; i < kPointCount; ++i) {
+    const float z = random(-1.f, 1.f);
+    const float angle = random(0.f, 6.2831853f);
+    if (i % 10 == 0) {
+      storage.insert(storage.end(), {random(0.f, 1.5f), 1.5f + 0.05f * z,
+                                     0.05f * cosf(angle), 1.f});
+      continue;
+    }
+    const float r = sqrtf(1.f - z * z) * random(0.9f, 1.f);
+    storage.insert(storage.end(),
+                   {0.4f * r * cosf(angle), 0.9f + 0.9f * z,
+                    0.25f * r * sinf(angle), 1.f});
+  }
+  const auto *points = reinterpret_cast<const vertex_t *>(storage.data());
+
+  // The centroid and farthest point loop this replaces.
+  boundingsphere_t naive = {{0.f, 0.f, 0.f, 1.f}, 0.f};
+  double naive_seconds = TimeIterations(kSphereIterations, [&](uint32_t) {
+    vector_t centroid = {0.f, 0.f, 0.f, 1.f};
+    for (uint32_t i = 0; i < kPointCount; ++i) {
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        centroid[axis] += points[i][axis] / kPointCount;
+      }
+    }
+    float radius = 0.f;
+    for (uint32_t i = 0; i < kPointCount; ++i) {
+      radius = std::max(radius, PointDistancePoint(centroid, points[i]));
+    }
+    std::copy_n(centroid, 4, naive.m_centerPt);
+    naive.m_radius = radius;
+    DoNotOptimize(naive.m_radius);
+  });
+  boundingsphere_t ritter;
+  double ritter_seconds = TimeIterations(kSphereIterations, [&](uint32_t) {
+    BoundingSphereFromPointsRitter(points, kPointCount, ritter);
+    DoNotOptimize(ritter.m_radius);
+  });
+  boundingsphere_t epos;
+  double epos_seconds = TimeIterations(kSphereIterations, [&](uint32_t) {
+    BoundingSphereFromPointsEPOS(points, kPointCount, epos);
+    DoNotOptimize(epos.m_radius);
+  });
+
+  const double processed = static_cast<double>(kPointCount) * kSphereIterations;
+  BenchmarkReport("centroid and farthest point", processed / naive_seconds,
+                  "points/s");
+  BenchmarkReport("Ritter", processed / ritter_seconds, "points/s");
+  BenchmarkReport("EPOS with refinement", processed / epos_seconds,
+                  "points/s");
+  BenchmarkReport("centroid sphere radius", naive.m_radius, "");
+  BenchmarkReport("Ritter radius", ritter.m_radius, "");
+  BenchmarkReport("EPOS radius", epos.m_radius, "");
+}
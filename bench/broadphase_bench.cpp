@@ -0,0 +1,75 @@
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_broadphase.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kSphereCount = 10000;
+static constexpr uint32_t kFrames = 100;
+static constexpr float kExtent = 200.f;
+
+BENCHMARK(sweep_and_prune) {
+  std::vector<boundingsphere_t> spheres(kSphereCount);
+  std::vector<float> velocities(kSphereCount * 3);
+  CRandom random(8);
+  for (uint32_t i = 0; i < kSphereCount; ++i) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      spheres[i].m_centerPt[axis] = random(0.f, kExtent);
+      velocities[i * 3 + axis] = random(-0.2f, 0.2f);
+    }
+    spheres[i].m_centerPt[3] = 1.f;
+    spheres[i].m_radius = random(0.5f, 2.f);
+  }
+
+  CSweepAndPrune broadphase;
+  for (const auto &sphere : spheres) {
+    broadphase.Add(sphere);
+  }
+  std::vector<broadphasepair_t> pairs;
+  // The first sort starts from insertion order.
+  double first_seconds =
+      TimeIterations(1, [&](uint32_t) { broadphase.FindPairs(pairs); });
+
+  uint64_t pair_count = 0;
+  double update_seconds = 0.0;
+  double find_seconds = 0.0;
+  for (uint32_t frame = 0; frame < kFrames; ++frame) {
+    update_seconds += TimeIterations(1, [&](uint32_t) {
+      for (uint32_t i = 0; i < kSphereCount; ++i) {
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+          spheres[i].m_centerPt[axis] += velocities[i * 3 + axis];
+        }
+        broadphase.Update(i, spheres[i]);
+      }
+    });
+    find_seconds += TimeIterations(1, [&](uint32_t) {
+      pair_count += broadphase.FindPairs(pairs);
+    });
+  }
+
+  // Every pair, as the broadphase this replaces did.
+  uint32_t brute_count = 0;
+  double brute_seconds = TimeIterations(1, [&](uint32_t) {
+    for (uint32_t i = 0; i < kSphereCount; ++i) {
+      for (uint32_t j = i + 1; j < kSphereCount; ++j) {
+        const float reach = spheres[i].m_radius + spheres[j].m_radius;
+        brute_count += PointDistanceSquaredPoint(spheres[i].m_centerPt,
+                                                 spheres[j].m_centerPt) <=
+                       reach * reach;
+      }
+    }
+  });
+  DoNotOptimize(brute_count);
+
+  const double frames = kFrames;
+  BenchmarkReport("spheres", kSphereCount, "");
+  BenchmarkReport("overlapping pairs per frame", pair_count / frames, "pairs");
+  BenchmarkReport("first sort and sweep", first_seconds * 1e3, "ms");
+  BenchmarkReport("update", update_seconds / frames * 1e3, "ms/frame");
+  BenchmarkReport("sort and sweep", find_seconds / frames * 1e3, "ms/frame");
+  BenchmarkReport("pairs found", pair_count / find_seconds, "pairs/s");
+  BenchmarkReport("every pair tested", brute_seconds * 1e3, "ms/frame");
+  BenchmarkReport("speedup", brute_seconds / (find_seconds / frames), "x");
+}
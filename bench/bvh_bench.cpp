@@ -0,0 +1,105 @@
+#include <cmath>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_bvh.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+// A 160 x 160 cell height field, i.e. 51200 triangles.
+static constexpr uint32_t kGridCells = 160;
+static constexpr uint32_t kRayCount = 4096;
+static constexpr uint32_t kBuildIterations = 10;
+static constexpr uint32_t kBruteForceRays = 64;
+
+namespace {
+
+struct Ray {
+  ray_t value;
+};
+
+}  // namespace
+
+static void BuildHeightField(std::vector<float> &vertices,
+                             std::vector<uint32_t> &indices) {
+  const uint32_t side = kGridCells + 1;
+  for (uint32_t z = 0; z < side; ++z) {
+    for (uint32_t x = 0; x < side; ++x) {
+      const float fx = static_cast<float>(x);
+      const float fz = static_cast<float>(z);
+      vertices.push_back(fx);
+      vertices.push_back(4.f * sinf(fx * 0.11f) * cosf(fz * 0.07f));
+      vertices.push_back(fz);
+      vertices.push_back(1.f);
+    }
+  }
+  for (uint32_t z = 0; z < kGridCells; ++z) {
+    for (uint32_t x = 0; x < kGridCells; ++x) {
+      const uint32_t corner = z * side + x;
+      indices.insert(indices.end(), {corner, corner + side, corner + 1});
+      indices.insert(indices.end(),
+                     {corner + 1, corner + side, corner + side + 1});
+    }
+  }
+}
+
+BENCHMARK(triangle_bvh) {
+  std::vector<float> vertex_data;
+  std::vector<uint32_t> indices;
+  BuildHeightField(vertex_data, indices);
+  const vertex_t *vertices =
+      reinterpret_cast<const vertex_t *>(vertex_data.data());
+  const uint32_t vertex_count = static_cast<uint32_t>(vertex_data.size() / 4);
+  const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+
+  CTriangleBVH bvh;
+  double build_seconds = TimeIterations(kBuildIterations, [&](uint32_t) {
+    bvh.Build(vertices, vertex_count, indices.data(), triangle_count);
+  });
+  BenchmarkReport("triangles", triangle_count, "");
+  BenchmarkReport("build time", build_seconds * 1000.0 / kBuildIterations,
+                  "ms");
+  BenchmarkReport("nodes", bvh.GetNodeCount(), "");
+  BenchmarkReport("memory", static_cast<double>(bvh.GetMemoryUsage()),
+                  "bytes");
+
+  // Picking-style rays from above the height field at an angle.
+  std::vector<Ray> rays(kRayCount);
+  CRandom random(1);
+  for (Ray &ray : rays) {
+    VectorSetVector(ray.value.m_origin, random(0.f, kGridCells), 30.f,
+                    random(0.f, kGridCells));
+    VectorSetVector(ray.value.m_direction, random(-1.f, 1.f), -1.f,
+                    random(-1.f, 1.f), 0.f);
+    VectorNormalize(ray.value.m_direction);
+    ray.value.m_direction[3] = 0.f;
+  }
+
+  uint32_t hits = 0;
+  double closest_seconds = TimeIterations(kRayCount, [&](uint32_t i) {
+    rayhit_t hit;
+    RayHitReset(hit);
+    hits += bvh.IntersectRay(rays[i].value, hit) ? 1 : 0;
+  });
+  DoNotOptimize(hits);
+  double any_seconds = TimeIterations(kRayCount, [&](uint32_t i) {
+    hits += bvh.IntersectRayAny(rays[i].value, FLT_MAX) ? 1 : 0;
+  });
+  DoNotOptimize(hits);
+  double brute_force_seconds = TimeIterations(kBruteForceRays, [&](uint32_t i) {
+    rayhit_t hit;
+    RayHitReset(hit);
+    hits += RayIntersectTriangles(rays[i].value, vertices, indices.data(),
+                                  triangle_count, hit)
+                ? 1
+                : 0;
+  });
+  DoNotOptimize(hits);
+
+  BenchmarkReport("brute force closest hit",
+                  kBruteForceRays / brute_force_seconds, "rays/s");
+  BenchmarkReport("BVH closest hit", kRayCount / closest_seconds, "rays/s");
+  BenchmarkReport("BVH any hit", kRayCount / any_seconds, "rays/s");
+}
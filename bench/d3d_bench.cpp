@@ -0,0 +1,73 @@
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kObjectCount = 1024;
+static constexpr uint32_t kIterations = 2000;
+
+namespace {
+
+struct Transform {
+  vector_t translation;
+  vector_t rotation;
+};
+
+struct Matrix {
+  matrix4_t value;
+};
+
+}  // namespace
+
+// The original CreateWorldView: a translation followed by three rotations,
+// each applied with a full matrix multiply.
+static void CreateWorldViewByMultiplication(const vector_t &translation,
+                                            const vector_t &rotation,
+                                            matrix4_t &ret) {
+  vector_t inv_translation = {-translation[0], -translation[1], -translation[2],
+                              translation[3]};
+  vector_t inv_rotation = {-rotation[0], -rotation[1], -rotation[2],
+                           rotation[3]};
+
+  MatrixSetIdentity(ret);
+  matrix4_t temp;
+  MatrixTranslate(ret, inv_translation, temp);
+  MatrixRotate(temp, inv_rotation, ret);
+}
+
+BENCHMARK(create_world_view) {
+  std::vector<Transform> transforms(kObjectCount);
+  for (uint32_t i = 0; i < kObjectCount; ++i) {
+    const float f = static_cast<float>(i);
+    VectorSetVector(transforms[i].translation, f * 0.5f, -f, f * 2.f);
+    VectorSetVector(transforms[i].rotation, f * 0.01f, f * -0.02f, f * 0.03f,
+                    0.f);
+  }
+  std::vector<Matrix> results(kObjectCount);
+
+  double multiply_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+      CreateWorldViewByMultiplication(transforms[i].translation,
+                                      transforms[i].rotation,
+                                      results[i].value);
+    }
+    DoNotOptimize(results.data());
+  });
+  double closed_form_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+      CreateWorldView(transforms[i].translation, transforms[i].rotation,
+                      results[i].value);
+    }
+    DoNotOptimize(results.data());
+  });
+
+  const double count = static_cast<double>(kObjectCount) * kIterations;
+  BenchmarkReport("translate + rotate multiplies", count / multiply_seconds,
+                  "matrices/s");
+  BenchmarkReport("closed-form CreateWorldView", count / closed_form_seconds,
+                  "matrices/s");
+}
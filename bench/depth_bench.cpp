@@ -0,0 +1,104 @@
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_depth.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_util.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kWidth = 640;
+static constexpr uint32_t kHeight = 480;
+static constexpr uint32_t kIterations = 20;
+
+static const struct {
+  DepthBufferFormat format;
+  const char *encode_label;
+  const char *decode_label;
+} kFormats[] = {
+    {kDepthBuffer16Bit, "encode 16-bit", "decode 16-bit"},
+    {kDepthBuffer16BitFloat, "encode 16-bit float", "decode 16-bit float"},
+    {kDepthBuffer24Bit, "encode 24-bit", "decode 24-bit"},
+    {kDepthBuffer24BitFloat, "encode 24-bit float", "decode 24-bit float"},
+};
+
+BENCHMARK(depth_encode_decode) {
+  constexpr uint32_t count = kWidth * kHeight;
+  std::vector<float> screen_z(count);
+  std::vector<uint32_t> raw(count);
+
+  for (const auto &entry : kFormats) {
+    const float max_value = DepthBufferMaxValue(entry.format);
+    for (uint32_t i = 0; i < count; ++i) {
+      screen_z[i] = max_value * static_cast<float>(i) / count;
+    }
+
+    double encode_seconds = TimeIterations(kIterations, [&](uint32_t) {
+      EncodeDepthValues(entry.format, screen_z.data(), count, raw.data());
+      DoNotOptimize(raw.data());
+    });
+    double decode_seconds = TimeIterations(kIterations, [&](uint32_t) {
+      DecodeDepthValues(entry.format, raw.data(), count, screen_z.data());
+      DoNotOptimize(screen_z.data());
+    });
+
+    const double values = static_cast<double>(count) * kIterations;
+    BenchmarkReport(entry.encode_label, values / encode_seconds, "values/s");
+    BenchmarkReport(entry.decode_label, values / decode_seconds, "values/s");
+  }
+}
+
+BENCHMARK(depth_buffer_to_world_positions) {
+  vector_t eye{2.f, 3.f, -8.f, 1.f};
+  vector_t at{0.f, 0.5f, 0.f, 1.f};
+  vector_t up{0.f, 1.f, 0.f, 1.f};
+  matrix4_t view;
+  CreateD3DLookAtLH(view, eye, at, up);
+  matrix4_t projection;
+  CreateD3DPerspectiveFOVLH(projection, M_PI * 0.25f,
+                            static_cast<float>(kWidth) / kHeight, 1.f, 200.f);
+  matrix4_t viewport;
+  CreateD3DStandardViewport24Bit(viewport, kWidth, kHeight);
+  matrix4_t projection_viewport;
+  MatrixMultMatrix(projection, viewport, projection_viewport);
+  matrix4_t composite;
+  BuildCompositeMatrix(view, projection_viewport, composite);
+  matrix4_t inverse_composite;
+  BuildInverseCompositeMatrix(composite, inverse_composite);
+
+  constexpr uint32_t count = kWidth * kHeight;
+  std::vector<uint32_t> depth_buffer(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    depth_buffer[i] = ((i * 2654435761u) >> 8) << 8;
+  }
+  std::vector<float> positions(count * 4);
+  auto *position_vectors = reinterpret_cast<vector_t *>(positions.data());
+
+  double unproject_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t y = 0; y < kHeight; ++y) {
+      for (uint32_t x = 0; x < kWidth; ++x) {
+        const uint32_t index = y * kWidth + x;
+        vector_t screen_point{static_cast<float>(x), static_cast<float>(y),
+                              static_cast<float>(depth_buffer[index] >> 8),
+                              1.f};
+        UnprojectPoint(screen_point, inverse_composite,
+                       position_vectors[index]);
+      }
+    }
+    DoNotOptimize(positions.data());
+  });
+  double fused_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    DepthBufferToWorldPositions(depth_buffer.data(), kWidth * sizeof(uint32_t),
+                                kDepthBuffer24Bit, kWidth, kHeight,
+                                inverse_composite, position_vectors);
+    DoNotOptimize(positions.data());
+  });
+
+  const double pixels = static_cast<double>(count) * kIterations;
+  BenchmarkReport("per pixel UnprojectPoint", pixels / unproject_seconds,
+                  "pixels/s");
+  BenchmarkReport("DepthBufferToWorldPositions", pixels / fused_seconds,
+                  "pixels/s");
+}
@@ -0,0 +1,74 @@
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_distance.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kEntityCount = 10000;
+static constexpr uint32_t kListenerCount = 64;
+static constexpr uint32_t kIterations = 200;
+
+namespace {
+
+// PointDistancePoint as it was before, computed in double precision with pow.
+float PowPointDistancePoint(const vertex_t &a, const vertex_t &b) {
+  return (float)sqrt(pow(b[0] - a[0], 2.0f) + pow(b[1] - a[1], 2.0f) +
+                     pow(b[2] - a[2], 2.0f));
+}
+
+}  // namespace
+
+BENCHMARK(point_distances) {
+  std::vector<float> storage(kEntityCount * 4);
+  CRandom random(11);
+  for (float &value : storage) {
+    value = random(0.f, 1000.f);
+  }
+  const auto *entities = reinterpret_cast<const vertex_t *>(storage.data());
+  const auto *listeners = entities + kEntityCount - kListenerCount;
+  std::vector<float> distances(kEntityCount * kListenerCount);
+  std::vector<uint32_t> mask(PointsWithinRadiusMaskWords(kEntityCount) *
+                             kListenerCount);
+
+  double pow_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kEntityCount; ++i) {
+      distances[i] = PowPointDistancePoint(listeners[0], entities[i]);
+    }
+    DoNotOptimize(distances[0]);
+  });
+  double scalar_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kEntityCount; ++i) {
+      distances[i] = PointDistancePoint(listeners[0], entities[i]);
+    }
+    DoNotOptimize(distances[0]);
+  });
+  double batch_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    PointDistancesPoints(listeners[0], entities, kEntityCount,
+                         distances.data());
+    DoNotOptimize(distances[0]);
+  });
+  double many_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    PointDistancesSquaredPoints(listeners, kListenerCount, entities,
+                                kEntityCount, distances.data());
+    DoNotOptimize(distances[0]);
+  });
+  uint32_t within = 0;
+  double radius_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    within = PointsWithinRadius(listeners, kListenerCount, entities,
+                                kEntityCount, 100.f, mask.data());
+    DoNotOptimize(within);
+  });
+
+  const double one = static_cast<double>(kEntityCount) * kIterations;
+  const double many = one * kListenerCount;
+  BenchmarkReport("pow PointDistancePoint", one / pow_seconds, "distances/s");
+  BenchmarkReport("PointDistancePoint", one / scalar_seconds, "distances/s");
+  BenchmarkReport("PointDistancesPoints, one to many", one / batch_seconds,
+                  "distances/s");
+  BenchmarkReport("PointDistancesSquaredPoints, many to many",
+                  many / many_seconds, "distances/s");
+  BenchmarkReport("PointsWithinRadius, many to many", many / radius_seconds,
+                  "pairs/s");
+}
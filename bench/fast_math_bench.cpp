@@ -0,0 +1,144 @@
+#include <cmath>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_fast_math.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kValueCount = 4096;
+static constexpr uint32_t kIterations = 2000;
+
+// Reports the maximum absolute and relative error of `approximation` against
+// the double precision libm `reference` over [low, high].
+template <typename Approximation, typename Reference>
+static void ReportAccuracy(const char *name, float low, float high,
+                           Approximation approximation, Reference reference) {
+  static constexpr uint32_t kSamples = 2000000;
+  double max_absolute = 0.0;
+  double max_relative = 0.0;
+  for (uint32_t i = 0; i <= kSamples; ++i) {
+    const float x = low + (high - low) * static_cast<float>(i) / kSamples;
+    const double expected = reference(static_cast<double>(x));
+    const double error = fabs(approximation(x) - expected);
+    max_absolute = std::max(max_absolute, error);
+    if (fabs(expected) > 1e-3) {
+      max_relative = std::max(max_relative, error / fabs(expected));
+    }
+  }
+
+  char label[128];
+  snprintf(label, sizeof(label), "%s max abs error [%g, %g]", name, low, high);
+  BenchmarkReport(label, max_absolute, "");
+  snprintf(label, sizeof(label), "%s max rel error [%g, %g]", name, low, high);
+  BenchmarkReport(label, max_relative, "");
+}
+
+static void FillValues(std::vector<float> &values, float low, float high) {
+  values.resize(kValueCount);
+  for (uint32_t i = 0; i < kValueCount; ++i) {
+    values[i] = low + (high - low) * static_cast<float>(i) / kValueCount;
+  }
+}
+
+// Reports the throughput of a scalar function and its 4-wide counterpart
+// alongside the libm equivalent.
+template <typename Libm, typename Scalar, typename Wide>
+static void ReportThroughput(const char *name, const std::vector<float> &values,
+                             Libm libm, Scalar scalar, Wide wide) {
+  std::vector<float> results(kValueCount);
+  const double count = static_cast<double>(kValueCount) * kIterations;
+
+  double libm_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kValueCount; ++i) {
+      results[i] = libm(values[i]);
+    }
+    DoNotOptimize(results.data());
+  });
+  double scalar_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kValueCount; ++i) {
+      results[i] = scalar(values[i]);
+    }
+    DoNotOptimize(results.data());
+  });
+  double wide_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kValueCount; i += 4) {
+      Simd::StoreUnaligned(&results[i],
+                           wide(Simd::LoadUnaligned(&values[i])));
+    }
+    DoNotOptimize(results.data());
+  });
+
+  char label[128];
+  snprintf(label, sizeof(label), "%s libm", name);
+  BenchmarkReport(label, count / libm_seconds, "values/s");
+  snprintf(label, sizeof(label), "%s fast scalar", name);
+  BenchmarkReport(label, count / scalar_seconds, "values/s");
+  snprintf(label, sizeof(label), "%s fast 4-wide", name);
+  BenchmarkReport(label, count / wide_seconds, "values/s");
+}
+
+BENCHMARK(fast_math_accuracy) {
+  auto fast_sin = [](float x) {
+    float s, c;
+    FastSinCos(x, s, c);
+    return s;
+  };
+  auto fast_cos = [](float x) {
+    float s, c;
+    FastSinCos(x, s, c);
+    return c;
+  };
+  auto ref_sin = [](double x) { return sin(x); };
+  auto ref_cos = [](double x) { return cos(x); };
+  auto ref_tan = [](double x) { return tan(x); };
+  auto ref_acos = [](double x) { return acos(x); };
+  auto fast_tan = [](float x) { return FastTan(x); };
+  auto fast_acos = [](float x) { return FastAcos(x); };
+
+  ReportAccuracy("FastSinCos sin", -3.2f, 3.2f, fast_sin, ref_sin);
+  ReportAccuracy("FastSinCos cos", -3.2f, 3.2f, fast_cos, ref_cos);
+  ReportAccuracy("FastSinCos sin", -8192.f, 8192.f, fast_sin, ref_sin);
+  ReportAccuracy("FastSinCos cos", -8192.f, 8192.f, fast_cos, ref_cos);
+  ReportAccuracy("FastTan", -1.5f, 1.5f, fast_tan, ref_tan);
+  ReportAccuracy("FastTan", -100.f, 100.f, fast_tan, ref_tan);
+  ReportAccuracy("FastAcos", -1.f, 1.f, fast_acos, ref_acos);
+
+  auto libm_sin = [](float x) { return sinf(x); };
+  auto libm_cos = [](float x) { return cosf(x); };
+  ReportAccuracy("libm sinf", -8192.f, 8192.f, libm_sin, ref_sin);
+  ReportAccuracy("libm cosf", -8192.f, 8192.f, libm_cos, ref_cos);
+}
+
+BENCHMARK(fast_math_throughput) {
+  std::vector<float> angles;
+  FillValues(angles, -10.f, 10.f);
+
+  ReportThroughput(
+      "sin+cos", angles, [](float x) { return sinf(x) + cosf(x); },
+      [](float x) {
+        float s, c;
+        FastSinCos(x, s, c);
+        return s + c;
+      },
+      [](Simd::float4 x) {
+        Simd::float4 s, c;
+        FastSinCos(x, s, c);
+        return Simd::Add(s, c);
+      });
+
+  std::vector<float> tan_angles;
+  FillValues(tan_angles, -1.5f, 1.5f);
+  ReportThroughput(
+      "tan", tan_angles, [](float x) { return tanf(x); },
+      [](float x) { return FastTan(x); },
+      [](Simd::float4 x) { return FastTan(x); });
+
+  std::vector<float> cosines;
+  FillValues(cosines, -1.f, 1.f);
+  ReportThroughput(
+      "acos", cosines, [](float x) { return acosf(x); },
+      [](float x) { return FastAcos(x); },
+      [](Simd::float4 x) { return FastAcos(x); });
+}
@@ -0,0 +1,63 @@
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_lod.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kObjectCount = 10000;
+static constexpr uint32_t kTableCount = 16;
+static constexpr uint32_t kIterations = 500;
+
+BENCHMARK(lod_selection) {
+  std::vector<boundingsphere_t> spheres(kObjectCount);
+  std::vector<uint32_t> table_indices(kObjectCount);
+  std::vector<lodthresholds_t> tables(kTableCount);
+  CRandom random(5);
+  for (uint32_t i = 0; i < kObjectCount; ++i) {
+    spheres[i].m_centerPt[0] = random(-500.f, 500.f);
+    spheres[i].m_centerPt[1] = random(0.f, 20.f);
+    spheres[i].m_centerPt[2] = random(-500.f, 500.f);
+    spheres[i].m_centerPt[3] = 1.f;
+    spheres[i].m_radius = random(0.5f, 5.f);
+    table_indices[i] = i % kTableCount;
+  }
+  for (auto &table : tables) {
+    float radius = random(100.f, 200.f);
+    for (float &threshold : table.m_screenRadius) {
+      threshold = radius;
+      radius *= 0.5f;
+    }
+  }
+  const vector_t camera{0.f, 2.f, 0.f, 1.f};
+  const float scale = 360.f;
+  std::vector<uint32_t> lods(kObjectCount);
+
+  // One object at a time, with PointDistancePoint.
+  double scalar_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kObjectCount; ++i) {
+      const lodthresholds_t &table = tables[table_indices[i]];
+      const float projected =
+          spheres[i].m_radius * scale /
+          PointDistancePoint(camera, spheres[i].m_centerPt);
+      uint32_t lod = 0;
+      while (lod < kMaxLodCount - 1 && projected < table.m_screenRadius[lod]) {
+        ++lod;
+      }
+      lods[i] = lod;
+    }
+    DoNotOptimize(lods[0]);
+  });
+  double batch_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    SelectLods(spheres.data(), kObjectCount, camera, scale, tables.data(),
+               table_indices.data(), lods.data());
+    DoNotOptimize(lods[0]);
+  });
+
+  const double objects = static_cast<double>(kObjectCount) * kIterations;
+  BenchmarkReport("per object, PointDistancePoint", objects / scalar_seconds,
+                  "objects/s");
+  BenchmarkReport("SelectLods", objects / batch_seconds, "objects/s");
+  BenchmarkReport("speedup", scalar_seconds / batch_seconds, "x");
+}
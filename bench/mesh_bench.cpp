@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_mesh.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kGridSize = 256;
+static constexpr uint32_t kIterations = 100;
+
+namespace {
+
+// A bumpy grid, two triangles per quad.
+struct GridMesh {
+  std::vector<float> vertices;  // 4 floats per vertex.
+  std::vector<uint32_t> indices;
+
+  GridMesh() {
+    for (uint32_t z = 0; z < kGridSize; ++z) {
+      for (uint32_t x = 0; x < kGridSize; ++x) {
+        const auto fx = static_cast<float>(x);
+        const auto fz = static_cast<float>(z);
+        vertices.insert(vertices.end(),
+                        {fx, sinf(fx * 0.1f) * cosf(fz * 0.07f), fz, 1.f});
+      }
+    }
+    for (uint32_t z = 0; z + 1 < kGridSize; ++z) {
+      for (uint32_t x = 0; x + 1 < kGridSize; ++x) {
+        const uint32_t corner = z * kGridSize + x;
+        indices.insert(indices.end(),
+                       {corner, corner + kGridSize, corner + 1, corner + 1,
+                        corner + kGridSize, corner + kGridSize + 1});
+      }
+    }
+  }
+
+  [[nodiscard]] const vertex_t *Vertices() const {
+    return reinterpret_cast<const vertex_t *>(vertices.data());
+  }
+  [[nodiscard]] uint32_t VertexCount() const {
+    return static_cast<uint32_t>(vertices.size() / 4);
+  }
+  [[nodiscard]] uint32_t TriangleCount() const {
+    return static_cast<uint32_t>(indices.size() / 3);
+  }
+};
+
+}  // namespace
+
+BENCHMARK(face_normals) {
+  const GridMesh mesh;
+  const uint32_t count = mesh.TriangleCount();
+  std::vector<float> storage(count * 4);
+  auto *normals = reinterpret_cast<vector_t *>(storage.data());
+
+  double scalar_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < count; ++i) {
+      const uint32_t *triangle = &mesh.indices[i * 3];
+      PlaneFindNormalizedNormal(mesh.Vertices()[triangle[0]],
+                                mesh.Vertices()[triangle[1]],
+                                mesh.Vertices()[triangle[2]], normals[i]);
+    }
+    DoNotOptimize(normals[0][0]);
+  });
+  double batch_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    ComputeFaceNormals(mesh.Vertices(), mesh.VertexCount(),
+                       mesh.indices.data(), count, true, normals);
+    DoNotOptimize(normals[0][0]);
+  });
+
+  const double triangles = static_cast<double>(count) * kIterations;
+  BenchmarkReport("triangles", count, "");
+  BenchmarkReport("PlaneFindNormalizedNormal", triangles / scalar_seconds,
+                  "triangles/s");
+  BenchmarkReport("ComputeFaceNormals", triangles / batch_seconds,
+                  "triangles/s");
+  BenchmarkReport("speedup", scalar_seconds / batch_seconds, "x");
+}
+
+BENCHMARK(vertex_normals) {
+  const GridMesh mesh;
+  const uint32_t triangle_count = mesh.TriangleCount();
+  const uint32_t vertex_count = mesh.VertexCount();
+  std::vector<float> face_storage(triangle_count * 4);
+  auto *face_normals = reinterpret_cast<vector_t *>(face_storage.data());
+  ComputeFaceNormals(mesh.Vertices(), vertex_count, mesh.indices.data(),
+                     triangle_count, false, face_normals);
+  std::vector<float> storage(mesh.vertices.size());
+  auto *normals = reinterpret_cast<vector_t *>(storage.data());
+
+  // Scattering each face normal to its three corners.
+  double scatter_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+      VectorSetVector(normals[v], 0.f, 0.f, 0.f);
+    }
+    for (uint32_t i = 0; i < triangle_count; ++i) {
+      const uint32_t *triangle = &mesh.indices[i * 3];
+      for (uint32_t corner = 0; corner < 3; ++corner) {
+        VectorAddVector(normals[triangle[corner]], face_normals[i]);
+      }
+    }
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+      VectorNormalize(normals[v]);
+    }
+    DoNotOptimize(normals[0][0]);
+  });
+
+  double angle_scatter_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+      VectorSetVector(normals[v], 0.f, 0.f, 0.f);
+    }
+    for (uint32_t i = 0; i < triangle_count; ++i) {
+      const uint32_t *triangle = &mesh.indices[i * 3];
+      vector_t unit_normal;
+      VectorNormalize(face_normals[i], unit_normal);
+      for (uint32_t corner = 0; corner < 3; ++corner) {
+        const vertex_t &at = mesh.Vertices()[triangle[corner]];
+        vector_t a, b, weighted;
+        VectorSubtractVector(mesh.Vertices()[triangle[(corner + 1) % 3]], at,
+                             a);
+        VectorSubtractVector(mesh.Vertices()[triangle[(corner + 2) % 3]], at,
+                             b);
+        const float angle = acosf(VectorDotVector(a, b) /
+                                  (VectorLength(a) * VectorLength(b)));
+        ScalarMultVector(unit_normal, angle, weighted);
+        VectorAddVector(normals[triangle[corner]], weighted);
+      }
+    }
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+      VectorNormalize(normals[v]);
+    }
+    DoNotOptimize(normals[0][0]);
+  });
+
+  vertexadjacency_t adjacency;
+  double adjacency_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    BuildVertexAdjacency(mesh.indices.data(), triangle_count, vertex_count,
+                         adjacency);
+    DoNotOptimize(adjacency.m_corners[0]);
+  });
+
+  const uint32_t thread_count =
+      std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+  const uint32_t vertices_per_thread =
+      (vertex_count + thread_count - 1) / thread_count;
+  std::vector<std::thread> threads;
+  auto time_gather = [&](VertexNormalWeighting weighting, bool threaded) {
+    return TimeIterations(kIterations, [&](uint32_t) {
+      if (!threaded) {
+        ComputeVertexNormals(mesh.Vertices(), mesh.indices.data(),
+                             face_normals, adjacency, weighting, 0,
+                             vertex_count, normals);
+        DoNotOptimize(normals[0][0]);
+        return;
+      }
+      threads.clear();
+      for (uint32_t i = 0; i < thread_count; ++i) {
+        const uint32_t first = std::min(i * vertices_per_thread, vertex_count);
+        const uint32_t count =
+            std::min(vertices_per_thread, vertex_count - first);
+        threads.emplace_back([&, weighting, first, count] {
+          ComputeVertexNormals(mesh.Vertices(), mesh.indices.data(),
+                               face_normals, adjacency, weighting, first,
+                               count, normals);
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      DoNotOptimize(normals[0][0]);
+    });
+  };
+  double area_seconds = time_gather(kVertexNormalWeightArea, false);
+  double angle_seconds = time_gather(kVertexNormalWeightAngle, false);
+  double threaded_area_seconds = time_gather(kVertexNormalWeightArea, true);
+  double threaded_angle_seconds = time_gather(kVertexNormalWeightAngle, true);
+
+  const double vertices = static_cast<double>(vertex_count) * kIterations;
+  BenchmarkReport("vertices", vertex_count, "");
+  BenchmarkReport("scatter, area weighted", vertices / scatter_seconds,
+                  "vertices/s");
+  BenchmarkReport("scatter, angle weighted", vertices / angle_scatter_seconds,
+                  "vertices/s");
+  BenchmarkReport("BuildVertexAdjacency (once per topology)",
+                  vertices / adjacency_seconds, "vertices/s");
+  BenchmarkReport("gather, area weighted", vertices / area_seconds,
+                  "vertices/s");
+  BenchmarkReport("gather, angle weighted", vertices / angle_seconds,
+                  "vertices/s");
+  BenchmarkReport("gather, threads by vertex range", thread_count, "threads");
+  BenchmarkReport("gather, area weighted, threaded (incl. thread launch)",
+                  vertices / threaded_area_seconds, "vertices/s");
+  BenchmarkReport("gather, angle weighted, threaded (incl. thread launch)",
+                  vertices / threaded_angle_seconds, "vertices/s");
+  BenchmarkReport("speedup, angle weighted gather vs scatter",
+                  angle_scatter_seconds / angle_seconds, "x");
+  BenchmarkReport("speedup, area weighted threaded vs scatter",
+                  scatter_seconds / threaded_area_seconds, "x");
+}
+
+BENCHMARK(vertex_tangents) {
+  const GridMesh mesh;
+  const uint32_t triangle_count = mesh.TriangleCount();
+  const uint32_t vertex_count = mesh.VertexCount();
+  std::vector<float> face_storage(triangle_count * 4);
+  auto *face_normals = reinterpret_cast<vector_t *>(face_storage.data());
+  ComputeFaceNormals(mesh.Vertices(), vertex_count, mesh.indices.data(),
+                     triangle_count, false, face_normals);
+  vertexadjacency_t adjacency;
+  BuildVertexAdjacency(mesh.indices.data(), triangle_count, vertex_count,
+                       adjacency);
+  std::vector<float> normal_storage(mesh.vertices.size());
+  auto *normals = reinterpret_cast<vector_t *>(normal_storage.data());
+  ComputeVertexNormals(mesh.Vertices(), mesh.indices.data(), face_normals,
+                       adjacency, kVertexNormalWeightArea, 0, vertex_count,
+                       normals);
+  std::vector<texcoord_t> texcoords(vertex_count);
+  for (uint32_t i = 0; i < vertex_count; ++i) {
+    texcoords[i][0] = mesh.Vertices()[i][0] / kGridSize;
+    texcoords[i][1] = mesh.Vertices()[i][2] / kGridSize;
+    texcoords[i][2] = 0.f;
+  }
+  std::vector<float> storage(mesh.vertices.size());
+  auto *tangents = reinterpret_cast<vector_t *>(storage.data());
+
+  // Scattering each triangle's tangent and bitangent to its corners, then
+  // orthogonalizing.
+  std::vector<float> bitangent_storage(mesh.vertices.size());
+  auto *bitangents = reinterpret_cast<vector_t *>(bitangent_storage.data());
+  double scatter_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+      VectorSetVector(tangents[v], 0.f, 0.f, 0.f);
+      VectorSetVector(bitangents[v], 0.f, 0.f, 0.f);
+    }
+    for (uint32_t i = 0; i < triangle_count; ++i) {
+      const uint32_t *triangle = &mesh.indices[i * 3];
+      vector_t e1, e2;
+      VectorSubtractVector(mesh.Vertices()[triangle[1]],
+                           mesh.Vertices()[triangle[0]], e1);
+      VectorSubtractVector(mesh.Vertices()[triangle[2]],
+                           mesh.Vertices()[triangle[0]], e2);
+      const float du1 = texcoords[triangle[1]][0] - texcoords[triangle[0]][0];
+      const float dv1 = texcoords[triangle[1]][1] - texcoords[triangle[0]][1];
+      const float du2 = texcoords[triangle[2]][0] - texcoords[triangle[0]][0];
+      const float dv2 = texcoords[triangle[2]][1] - texcoords[triangle[0]][1];
+      const float r = 1.f / (du1 * dv2 - du2 * dv1);
+      vector_t tangent, bitangent, scaled;
+      ScalarMultVector(e1, dv2 * r, tangent);
+      ScalarMultVector(e2, dv1 * r, scaled);
+      VectorSubtractVector(tangent, scaled);
+      ScalarMultVector(e2, du1 * r, bitangent);
+      ScalarMultVector(e1, du2 * r, scaled);
+      VectorSubtractVector(bitangent, scaled);
+      for (uint32_t corner = 0; corner < 3; ++corner) {
+        VectorAddVector(tangents[triangle[corner]], tangent);
+        VectorAddVector(bitangents[triangle[corner]], bitangent);
+      }
+    }
+    for (uint32_t v = 0; v < vertex_count; ++v) {
+      vector_t projection, cross;
+      ScalarMultVector(normals[v], VectorDotVector(normals[v], tangents[v]),
+                       projection);
+      VectorSubtractVector(tangents[v], projection);
+      VectorNormalize(tangents[v]);
+      VectorCrossVector(normals[v], tangents[v], cross);
+      tangents[v][3] =
+          VectorDotVector(cross, bitangents[v]) < 0.f ? -1.f : 1.f;
+    }
+    DoNotOptimize(tangents[0][0]);
+  });
+
+  const uint32_t thread_count =
+      std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+  const uint32_t vertices_per_thread =
+      (vertex_count + thread_count - 1) / thread_count;
+  std::vector<std::thread> threads;
+  double gather_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    ComputeVertexTangents(mesh.Vertices(), texcoords.data(),
+                          mesh.indices.data(), normals, adjacency, true, 0,
+                          vertex_count, tangents);
+    DoNotOptimize(tangents[0][0]);
+  });
+  double threaded_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    threads.clear();
+    for (uint32_t i = 0; i < thread_count; ++i) {
+      const uint32_t first = std::min(i * vertices_per_thread, vertex_count);
+      const uint32_t count =
+          std::min(vertices_per_thread, vertex_count - first);
+      threads.emplace_back([&, first, count] {
+        ComputeVertexTangents(mesh.Vertices(), texcoords.data(),
+                              mesh.indices.data(), normals, adjacency, true,
+                              first, count, tangents);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    DoNotOptimize(tangents[0][0]);
+  });
+
+  const double vertices = static_cast<double>(vertex_count) * kIterations;
+  BenchmarkReport("vertices", vertex_count, "");
+  BenchmarkReport("scatter", vertices / scatter_seconds, "vertices/s");
+  BenchmarkReport("ComputeVertexTangents", vertices / gather_seconds,
+                  "vertices/s");
+  BenchmarkReport("threads by vertex range", thread_count, "threads");
+  BenchmarkReport("threaded (incl. thread launch)",
+                  vertices / threaded_seconds, "vertices/s");
+  BenchmarkReport("speedup, 1 thread", scatter_seconds / gather_seconds, "x");
+  BenchmarkReport("speedup, threaded", scatter_seconds / threaded_seconds,
+                  "x");
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_camera.h"
+#include "xbox_math_occlusion.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kBufferWidth = 256;
+static constexpr uint32_t kBufferHeight = 128;
+static constexpr uint32_t kBlocksPerSide = 12;
+static constexpr float kBlockSpacing = 20.f;
+static constexpr float kBuildingHalfWidth = 6.f;
+static constexpr uint32_t kObjectCount = 20000;
+static constexpr uint32_t kFrames = 200;
+
+namespace {
+
+// A grid of box shaped buildings separated by streets, with small objects
+// scattered over the whole area.
+struct City {
+  std::vector<float> vertices;  // 4 floats per vertex.
+  std::vector<uint32_t> indices;
+  std::vector<boundingsphere_t> objects;
+  CRandom random{4242};
+
+  void AddBox(float x, float z, float half_width, float height) {
+    const auto first = static_cast<uint32_t>(vertices.size() / 4);
+    for (uint32_t corner = 0; corner < 8; ++corner) {
+      vertices.push_back(x + (corner & 1 ? half_width : -half_width));
+      vertices.push_back(corner & 2 ? height : 0.f);
+      vertices.push_back(z + (corner & 4 ? half_width : -half_width));
+      vertices.push_back(1.f);
+    }
+    static const uint32_t kBoxIndices[36] = {
+        0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+        2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+    for (uint32_t index : kBoxIndices) {
+      indices.push_back(first + index);
+    }
+  }
+
+  City() {
+    for (uint32_t i = 0; i < kBlocksPerSide; ++i) {
+      for (uint32_t j = 0; j < kBlocksPerSide; ++j) {
+        AddBox(static_cast<float>(i) * kBlockSpacing,
+               static_cast<float>(j) * kBlockSpacing, kBuildingHalfWidth,
+               random(10.f, 40.f));
+      }
+    }
+    const float extent = kBlocksPerSide * kBlockSpacing;
+    objects.resize(kObjectCount);
+    for (auto &object : objects) {
+      object.m_centerPt[0] = random(-10.f, extent);
+      object.m_centerPt[1] = random(0.5f, 4.f);
+      object.m_centerPt[2] = random(-10.f, extent);
+      object.m_centerPt[3] = 1.f;
+      object.m_radius = random(0.5f, 1.5f);
+    }
+  }
+
+  [[nodiscard]] uint32_t VertexCount() const {
+    return static_cast<uint32_t>(vertices.size() / 4);
+  }
+  [[nodiscard]] uint32_t TriangleCount() const {
+    return static_cast<uint32_t>(indices.size() / 3);
+  }
+};
+
+}  // namespace
+
+BENCHMARK(occlusion_culling) {
+  City city;
+  const auto *vertices =
+      reinterpret_cast<const vertex_t *>(city.vertices.data());
+
+  // Standing in a street, looking along it.
+  CCamera camera;
+  vector_t eye{kBlockSpacing * 0.5f, 2.f, -20.f, 1.f};
+  vector_t at{kBlockSpacing * 0.5f, 2.f, 200.f, 1.f};
+  vector_t up{0.f, 1.f, 0.f, 1.f};
+  camera.SetLookAt(eye, at, up);
+  camera.SetPerspective(M_PI * 0.3f, 2.f, 0.5f, 500.f);
+
+  COcclusionBuffer buffer(kBufferWidth, kBufferHeight);
+  buffer.SetViewProjection(camera.GetView(), camera.GetProjection());
+
+  double setup_seconds = TimeIterations(kFrames, [&](uint32_t) {
+    buffer.Clear();
+    buffer.AddOccluders(vertices, city.VertexCount(), city.indices.data(),
+                        city.TriangleCount());
+  });
+  double raster_seconds = TimeIterations(kFrames, [&](uint32_t) {
+    buffer.Rasterize();
+    DoNotOptimize(buffer.GetDepth(0, 0));
+  });
+
+  const uint32_t thread_count =
+      std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+  const uint32_t tiles_per_thread =
+      (buffer.GetTileCount() + thread_count - 1) / thread_count;
+  std::vector<std::thread> threads;
+  double threaded_raster_seconds = TimeIterations(kFrames, [&](uint32_t) {
+    threads.clear();
+    for (uint32_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back([&buffer, i, tiles_per_thread] {
+        buffer.RasterizeTiles(i * tiles_per_thread, tiles_per_thread);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    DoNotOptimize(buffer.GetDepth(0, 0));
+  });
+
+  // Frustum culling first, as the renderer would, then occlusion culling of
+  // the survivors.
+  const frustum_t &frustum = camera.GetFrustum();
+  std::vector<boundingsphere_t> in_frustum;
+  for (const auto &object : city.objects) {
+    if (frustum.SphereInFrustum(object)) {
+      in_frustum.push_back(object);
+    }
+  }
+  const auto in_frustum_count = static_cast<uint32_t>(in_frustum.size());
+  std::vector<uint8_t> occluded(in_frustum_count);
+  uint32_t occluded_count = 0;
+  double test_seconds = TimeIterations(kFrames, [&](uint32_t) {
+    occluded_count = 0;
+    for (uint32_t i = 0; i < in_frustum_count; ++i) {
+      occluded[i] = buffer.IsSphereOccluded(in_frustum[i]);
+      occluded_count += occluded[i];
+    }
+    DoNotOptimize(occluded_count);
+  });
+  std::unique_ptr<bool[]> batch_occluded(new bool[in_frustum_count]);
+  uint32_t batch_occluded_count = 0;
+  double batch_test_seconds = TimeIterations(kFrames, [&](uint32_t) {
+    batch_occluded_count = buffer.TestSpheres(
+        in_frustum.data(), in_frustum_count, batch_occluded.get());
+    DoNotOptimize(batch_occluded_count);
+  });
+
+  const double frames = kFrames;
+  BenchmarkReport("occluder triangles", city.TriangleCount(), "triangles");
+  BenchmarkReport("occluder setup and binning", setup_seconds / frames * 1e3,
+                  "ms/frame");
+  BenchmarkReport("raster, 1 thread", raster_seconds / frames * 1e3,
+                  "ms/frame");
+  BenchmarkReport("raster, threads by tile", thread_count, "threads");
+  BenchmarkReport("raster, threaded (incl. thread launch)",
+                  threaded_raster_seconds / frames * 1e3, "ms/frame");
+  BenchmarkReport("occludee tests", in_frustum_count * frames / test_seconds,
+                  "spheres/s");
+  BenchmarkReport("occludee tests, TestSpheres",
+                  in_frustum_count * frames / batch_test_seconds, "spheres/s");
+  BenchmarkReport("draw calls after frustum culling", in_frustum_count,
+                  "draws");
+  BenchmarkReport("draw calls after occlusion culling",
+                  in_frustum_count - occluded_count, "draws");
+  BenchmarkReport("draw call reduction",
+                  100.0 * occluded_count / std::max(1u, in_frustum_count),
+                  "%");
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_spatial_hash.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+// One point per 8 cubic units, so about 30 points within the query radius.
+static constexpr float kDensity = 1.f / 8.f;
+static constexpr float kQueryRadius = 4.f;
+static constexpr float kCellSize = kQueryRadius;
+static constexpr uint32_t kQueryCount = 2000;
+static constexpr uint32_t kNearestCount = 8;
+
+BENCHMARK(spatial_hash) {
+  for (uint32_t point_count : {1000u, 10000u, 100000u, 1000000u}) {
+    const float extent = cbrtf(static_cast<float>(point_count) / kDensity);
+    std::vector<float> storage(point_count * 4);
+    CRandom random(3);
+    for (float &value : storage) {
+      value = random(0.f, extent);
+    }
+    const auto *points = reinterpret_cast<const vertex_t *>(storage.data());
+    const auto *queries = points;
+
+    CSpatialHashGrid grid(kCellSize, point_count * 2);
+    double insert_seconds = TimeIterations(1, [&](uint32_t) {
+      for (uint32_t i = 0; i < point_count; ++i) {
+        grid.Insert(points[i]);
+      }
+    });
+    // Small steps, as from one frame to the next.
+    double move_seconds = TimeIterations(1, [&](uint32_t) {
+      for (uint32_t i = 0; i < point_count; ++i) {
+        const vertex_t moved{points[i][0] + 0.1f, points[i][1],
+                             points[i][2] - 0.1f, 1.f};
+        grid.Move(i, moved);
+      }
+    });
+
+    std::vector<uint32_t> results;
+    uint32_t grid_found = 0;
+    double radius_seconds = TimeIterations(kQueryCount, [&](uint32_t i) {
+      grid_found += grid.QueryRadius(queries[i], kQueryRadius, results);
+    });
+    double nearest_seconds = TimeIterations(kQueryCount, [&](uint32_t i) {
+      DoNotOptimize(grid.QueryNearest(queries[i], kNearestCount, results));
+    });
+
+    // The loop the grid replaces, over fewer queries for large counts.
+    const uint32_t brute_queries =
+        std::max(10u, std::min(kQueryCount, 100000000u / point_count));
+    uint32_t brute_found = 0;
+    double brute_seconds = TimeIterations(brute_queries, [&](uint32_t i) {
+      for (uint32_t j = 0; j < point_count; ++j) {
+        brute_found +=
+            PointDistancePoint(queries[i], points[j]) <= kQueryRadius;
+      }
+    });
+    DoNotOptimize(grid_found + brute_found);
+
+    const std::string label = std::to_string(point_count) + " points, ";
+    auto report = [&label](const char *name, double value, const char *units) {
+      BenchmarkReport((label + name).c_str(), value, units);
+    };
+    report("insert", point_count / insert_seconds, "points/s");
+    report("move", point_count / move_seconds, "points/s");
+    report("radius query", kQueryCount / radius_seconds, "queries/s");
+    report("8 nearest query", kQueryCount / nearest_seconds, "queries/s");
+    report("brute force radius query", brute_queries / brute_seconds,
+           "queries/s");
+    report("radius query speedup",
+           (brute_seconds / brute_queries) / (radius_seconds / kQueryCount),
+           "x");
+  }
+}
@@ -0,0 +1,58 @@
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_util.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kSphereCount = 4096;
+static constexpr uint32_t kIterations = 500;
+
+BENCHMARK(sphere_screen_rects) {
+  vector_t eye{0.f, 5.f, -20.f, 1.f};
+  vector_t at{0.f, 0.f, 50.f, 1.f};
+  vector_t up{0.f, 1.f, 0.f, 1.f};
+  matrix4_t view;
+  CreateD3DLookAtLH(view, eye, at, up);
+  matrix4_t projection;
+  CreateD3DPerspectiveFOVLH(projection, M_PI * 0.3f, 16.f / 9.f, 0.5f, 500.f);
+  matrix4_t viewport;
+  CreateD3DViewport(viewport, 1280, 720, 1.f, 0.f, 1.f);
+  matrix4_t projection_viewport;
+  MatrixMultMatrix(projection, viewport, projection_viewport);
+  matrix4_t composite;
+  BuildCompositeMatrix(view, projection_viewport, composite);
+
+  std::vector<boundingsphere_t> spheres(kSphereCount);
+  CRandom random(17);
+  for (auto &sphere : spheres) {
+    sphere.m_centerPt[0] = random(-50.f, 50.f);
+    sphere.m_centerPt[1] = random(-10.f, 10.f);
+    sphere.m_centerPt[2] = random(0.f, 150.f);
+    sphere.m_centerPt[3] = 1.f;
+    sphere.m_radius = random(0.5f, 3.f);
+  }
+  std::vector<screenrect_t> rects(kSphereCount);
+
+  double box_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kSphereCount; ++i) {
+      BoundingSphereScreenRect(spheres[i], composite, rects[i]);
+    }
+    DoNotOptimize(rects[0].m_minX);
+  });
+  double analytic_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    BoundingSphereScreenRectsPerspective(spheres.data(), kSphereCount, view,
+                                         projection, viewport, rects.data());
+    DoNotOptimize(rects[0].m_minX);
+  });
+
+  const double spheres_tested = static_cast<double>(kSphereCount) * kIterations;
+  BenchmarkReport("bounding box corners", spheres_tested / box_seconds,
+                  "spheres/s");
+  BenchmarkReport("analytic, 4 wide", spheres_tested / analytic_seconds,
+                  "spheres/s");
+  BenchmarkReport("speedup", box_seconds / analytic_seconds, "x");
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_vector.h"
+#include "xbox_math_vector_stream.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kVectorCount = 1024;
+static constexpr uint32_t kIterations = 5000;
+
+BENCHMARK(vector_normalize) {
+  std::vector<float> storage(kVectorCount * 4);
+  CRandom random(31);
+  for (uint32_t i = 0; i < kVectorCount * 4; ++i) {
+    const float value = random(0.f, 2.f);
+    storage[i] = i % 4 == 3 ? 1.f : value;
+  }
+  const auto *vectors = reinterpret_cast<const vector_t *>(storage.data());
+  std::vector<float> ret_storage(storage.size());
+  auto *ret = reinterpret_cast<vector_t *>(ret_storage.data());
+
+  double exact_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kVectorCount; ++i) {
+      VectorNormalize(vectors[i], ret[i]);
+    }
+    DoNotOptimize(ret[0][0]);
+  });
+  double fast_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kVectorCount; ++i) {
+      VectorNormalizeFast(vectors[i], ret[i]);
+    }
+    DoNotOptimize(ret[0][0]);
+  });
+  double safe_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kVectorCount; ++i) {
+      VectorNormalizeFastSafe(vectors[i], ret[i]);
+    }
+    DoNotOptimize(ret[0][0]);
+  });
+  double batch_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    VectorsNormalizeFast(vectors, kVectorCount, ret);
+    DoNotOptimize(ret[0][0]);
+  });
+
+  CVectorStream stream, stream_ret;
+  stream.SetVectors(vectors, kVectorCount);
+  double stream_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    VectorsNormalize(stream, stream_ret);
+    DoNotOptimize(stream_ret.GetX()[0]);
+  });
+  double stream_fast_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    VectorsNormalizeFast(stream, stream_ret);
+    DoNotOptimize(stream_ret.GetX()[0]);
+  });
+
+  // Each normalization depending on the last, as when building look-at axes,
+  // exposes latency rather than throughput.
+  vector_t chain = {0.3f, 0.4f, 0.5f, 1.f};
+  double exact_latency_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kVectorCount; ++i) {
+      VectorNormalize(chain);
+      chain[i % 3] += 0.5f;
+    }
+    DoNotOptimize(chain[0]);
+  });
+  double fast_latency_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    for (uint32_t i = 0; i < kVectorCount; ++i) {
+      VectorNormalizeFast(chain);
+      chain[i % 3] += 0.5f;
+    }
+    DoNotOptimize(chain[0]);
+  });
+
+  // Largest component error against double precision.
+  double max_error = 0.0;
+  for (uint32_t i = 0; i < kVectorCount; ++i) {
+    const vector_t &v = vectors[i];
+    const double length =
+        sqrt(static_cast<double>(v[0]) * v[0] +
+             static_cast<double>(v[1]) * v[1] +
+             static_cast<double>(v[2]) * v[2]);
+    vector_t fast;
+    VectorNormalizeFast(v, fast);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      max_error = std::max(max_error, fabs(fast[axis] - v[axis] / length));
+    }
+  }
+
+  const double count = static_cast<double>(kVectorCount) * kIterations;
+  BenchmarkReport("VectorNormalize", count / exact_seconds, "vectors/s");
+  BenchmarkReport("VectorNormalizeFast", count / fast_seconds, "vectors/s");
+  BenchmarkReport("VectorNormalizeFastSafe", count / safe_seconds,
+                  "vectors/s");
+  BenchmarkReport("VectorsNormalizeFast, vector_t array",
+                  count / batch_seconds, "vectors/s");
+  BenchmarkReport("VectorsNormalize, stream", count / stream_seconds,
+                  "vectors/s");
+  BenchmarkReport("VectorsNormalizeFast, stream", count / stream_fast_seconds,
+                  "vectors/s");
+  BenchmarkReport("VectorNormalize, dependent chain",
+                  exact_latency_seconds / count * 1e9, "ns/vector");
+  BenchmarkReport("VectorNormalizeFast, dependent chain",
+                  fast_latency_seconds / count * 1e9, "ns/vector");
+  BenchmarkReport("speedup, VectorNormalizeFast",
+                  exact_seconds / fast_seconds, "x");
+  BenchmarkReport("speedup, VectorNormalizeFast dependent chain",
+                  exact_latency_seconds / fast_latency_seconds, "x");
+  BenchmarkReport("speedup, VectorsNormalizeFast array",
+                  exact_seconds / batch_seconds, "x");
+  BenchmarkReport("VectorNormalizeFast max error", max_error, "");
+  BenchmarkReport("VectorNormalizeFast max error, log2", log2(max_error), "");
+}
@@ -0,0 +1,112 @@
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "xbox_math_vector.h"
+#include "xbox_math_vector_stream.h"
+
+using namespace XboxMath;
+using namespace XboxMathBenchmark;
+
+static constexpr uint32_t kVectorCount = 1024;
+static constexpr uint32_t kIterations = 5000;
+
+BENCHMARK(vector_stream) {
+  std::vector<float> a_storage(kVectorCount * 4);
+  std::vector<float> b_storage(kVectorCount * 4);
+  CRandom random(23);
+  for (uint32_t i = 0; i < kVectorCount * 4; ++i) {
+    const float a = random(0.f, 2.f);
+    const float b = random(0.f, 2.f);
+    a_storage[i] = i % 4 == 3 ? 1.f : a;
+    b_storage[i] = i % 4 == 3 ? 1.f : b;
+  }
+  const auto *a_vectors = reinterpret_cast<const vector_t *>(a_storage.data());
+  const auto *b_vectors = reinterpret_cast<const vector_t *>(b_storage.data());
+  std::vector<float> ret_storage(kVectorCount * 4);
+  auto *ret_vectors = reinterpret_cast<vector_t *>(ret_storage.data());
+  std::vector<float> values(kVectorCount);
+
+  CVectorStream a, b, ret;
+  a.SetVectors(a_vectors, kVectorCount);
+  b.SetVectors(b_vectors, kVectorCount);
+  ret.Resize(kVectorCount);
+
+  const double vectors = static_cast<double>(kVectorCount) * kIterations;
+  auto report = [&](const std::string &name, double scalar_seconds,
+                    double stream_seconds) {
+    BenchmarkReport((name + ", scalar").c_str(), vectors / scalar_seconds,
+                    "vectors/s");
+    BenchmarkReport((name + ", stream").c_str(), vectors / stream_seconds,
+                    "vectors/s");
+    BenchmarkReport((name + ", speedup").c_str(),
+                    scalar_seconds / stream_seconds, "x");
+  };
+
+  report("add",
+         TimeIterations(kIterations,
+                        [&](uint32_t) {
+                          for (uint32_t i = 0; i < kVectorCount; ++i) {
+                            VectorAddVector(a_vectors[i], b_vectors[i],
+                                            ret_vectors[i]);
+                          }
+                          DoNotOptimize(ret_vectors[0][0]);
+                        }),
+         TimeIterations(kIterations, [&](uint32_t) {
+           VectorsAddVectors(a, b, ret);
+           DoNotOptimize(ret.GetX()[0]);
+         }));
+
+  report("cross",
+         TimeIterations(kIterations,
+                        [&](uint32_t) {
+                          for (uint32_t i = 0; i < kVectorCount; ++i) {
+                            VectorCrossVector(a_vectors[i], b_vectors[i],
+                                              ret_vectors[i]);
+                          }
+                          DoNotOptimize(ret_vectors[0][0]);
+                        }),
+         TimeIterations(kIterations, [&](uint32_t) {
+           VectorsCrossVectors(a, b, ret);
+           DoNotOptimize(ret.GetX()[0]);
+         }));
+
+  report("dot",
+         TimeIterations(kIterations,
+                        [&](uint32_t) {
+                          for (uint32_t i = 0; i < kVectorCount; ++i) {
+                            values[i] =
+                                VectorDotVector(a_vectors[i], b_vectors[i]);
+                          }
+                          DoNotOptimize(values[0]);
+                        }),
+         TimeIterations(kIterations, [&](uint32_t) {
+           VectorsDotVectors(a, b, values.data());
+           DoNotOptimize(values[0]);
+         }));
+
+  report("normalize",
+         TimeIterations(kIterations,
+                        [&](uint32_t) {
+                          for (uint32_t i = 0; i < kVectorCount; ++i) {
+                            VectorNormalize(a_vectors[i], ret_vectors[i]);
+                          }
+                          DoNotOptimize(ret_vectors[0][0]);
+                        }),
+         TimeIterations(kIterations, [&](uint32_t) {
+           VectorsNormalize(a, ret);
+           DoNotOptimize(ret.GetX()[0]);
+         }));
+
+  // The cost of moving data in and out of the stream layout.
+  double to_stream_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    ret.SetVectors(a_vectors, kVectorCount);
+    DoNotOptimize(ret.GetX()[0]);
+  });
+  double from_stream_seconds = TimeIterations(kIterations, [&](uint32_t) {
+    a.GetVectors(ret_vectors);
+    DoNotOptimize(ret_vectors[0][0]);
+  });
+  BenchmarkReport("AoS to SoA", vectors / to_stream_seconds, "vectors/s");
+  BenchmarkReport("SoA to AoS", vectors / from_stream_seconds, "vectors/s");
+}
@@ -0,0 +1,265 @@
+#include "xbox_math_animation.h"
+
+#include <cassert>
+
+namespace XboxMath {
+
+// Components other than the largest lie within [-1/sqrt(2), 1/sqrt(2)].
+static constexpr float kSmallestThreeRange = 0.70710678118f;
+static constexpr float kSmallestThreeMaxValue = 32767.f;
+static constexpr float kKeyTimeMaxValue = 65535.f;
+static constexpr float kTranslationMaxValue = 65535.f;
+
+// Number of keys the cursor will step forward before falling back to a binary
+// search (e.g., when playback skips ahead).
+static constexpr uint32_t kMaxLinearCursorSteps = 4;
+
+static inline uint16_t QuantizeUnsigned(float value, float max_value) {
+  if (value <= 0.f) {
+    return 0;
+  }
+  if (value >= max_value) {
+    return static_cast<uint16_t>(max_value);
+  }
+  return static_cast<uint16_t>(value + 0.5f);
+}
+
+void QuaternionPackSmallestThree(const CQuaternion &q, uint16_t (&ret)[3]) {
+  uint32_t largest = 0;
+  float largest_magnitude = fabsf(q[0]);
+  for (uint32_t i = 1; i < 4; ++i) {
+    float magnitude = fabsf(q[i]);
+    if (magnitude > largest_magnitude) {
+      largest = i;
+      largest_magnitude = magnitude;
+    }
+  }
+
+  // q and -q describe the same rotation, so flip the quaternion as needed to
+  // make the implied component positive.
+  const float sign = q[largest] < 0.f ? -1.f : 1.f;
+  const float inv_length = sign / q.GetLength();
+  const float scale = kSmallestThreeMaxValue * 0.5f / kSmallestThreeRange;
+
+  uint32_t out = 0;
+  for (uint32_t i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+    float value = q[i] * inv_length * scale + kSmallestThreeMaxValue * 0.5f;
+    ret[out++] = QuantizeUnsigned(value, kSmallestThreeMaxValue);
+  }
+
+  ret[0] |= static_cast<uint16_t>((largest & 0x01) << 15);
+  ret[1] |= static_cast<uint16_t>((largest & 0x02) << 14);
+}
+
+void QuaternionUnpackSmallestThree(const uint16_t (&packed)[3],
+                                   CQuaternion &ret) {
+  const uint32_t largest = (packed[0] >> 15) | ((packed[1] >> 15) << 1);
+  const float scale = 2.f * kSmallestThreeRange / kSmallestThreeMaxValue;
+
+  float components[3];
+  float sum_squares = 0.f;
+  for (uint32_t i = 0; i < 3; ++i) {
+    components[i] =
+        static_cast<float>(packed[i] & 0x7FFF) * scale - kSmallestThreeRange;
+    sum_squares += components[i] * components[i];
+  }
+
+  float implied = 1.f - sum_squares;
+  implied = implied > 0.f ? sqrtf(implied) : 0.f;
+
+  uint32_t in = 0;
+  for (uint32_t i = 0; i < 4; ++i) {
+    ret[i] = i == largest ? implied : components[in++];
+  }
+}
+
+bool CAnimationClip::AddTrack(const float *times, const CQuaternion *rotations,
+                              const vector_t *translations,
+                              uint32_t key_count) {
+  if (!key_count) {
+    return false;
+  }
+  for (uint32_t i = 1; i < key_count; ++i) {
+    if (times[i] <= times[i - 1]) {
+      return false;
+    }
+  }
+
+  animationtrack_t track;
+  track.m_firstKey = static_cast<uint32_t>(m_keys.size());
+  track.m_keyCount = key_count;
+  track.m_startTime = times[0];
+
+  const float track_duration = times[key_count - 1] - times[0];
+  track.m_timeScale =
+      track_duration > 0.f ? kKeyTimeMaxValue / track_duration : 0.f;
+
+  float translation_max[3];
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    track.m_translationMin[axis] = translations[0][axis];
+    translation_max[axis] = translations[0][axis];
+  }
+  for (uint32_t i = 1; i < key_count; ++i) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      const float value = translations[i][axis];
+      if (value < track.m_translationMin[axis]) {
+        track.m_translationMin[axis] = value;
+      }
+      if (value > translation_max[axis]) {
+        translation_max[axis] = value;
+      }
+    }
+  }
+
+  float inv_translation_scale[3];
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    const float extent = translation_max[axis] - track.m_translationMin[axis];
+    track.m_translationScale[axis] = extent / kTranslationMaxValue;
+    inv_translation_scale[axis] =
+        extent > 0.f ? kTranslationMaxValue / extent : 0.f;
+  }
+
+  m_keys.reserve(m_keys.size() + key_count);
+  for (uint32_t i = 0; i < key_count; ++i) {
+    animationkey_t key;
+    key.m_time = QuantizeUnsigned((times[i] - track.m_startTime) *
+                                      track.m_timeScale,
+                                  kKeyTimeMaxValue);
+
+    // Keys that collapse onto the same quantized time cannot be interpolated.
+    if (i && key.m_time <= m_keys.back().m_time) {
+      m_keys.resize(track.m_firstKey);
+      return false;
+    }
+
+    QuaternionPackSmallestThree(rotations[i], key.m_rotation);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      key.m_translation[axis] = QuantizeUnsigned(
+          (translations[i][axis] - track.m_translationMin[axis]) *
+              inv_translation_scale[axis],
+          kTranslationMaxValue);
+    }
+    m_keys.push_back(key);
+  }
+
+  m_tracks.push_back(track);
+  if (times[key_count - 1] > m_duration) {
+    m_duration = times[key_count - 1];
+  }
+  return true;
+}
+
+void CAnimationClip::Clear() {
+  m_tracks.clear();
+  m_keys.clear();
+  m_duration = 0.f;
+}
+
+size_t CAnimationClip::GetMemoryUsage() const {
+  return sizeof(*this) + m_tracks.capacity() * sizeof(animationtrack_t) +
+         m_keys.capacity() * sizeof(animationkey_t);
+}
+
+void CAnimationClip::SampleTrack(uint32_t track_index, float time,
+                                 animationcursor_t &cursor,
+                                 CQuaternion &rotation,
+                                 vector_t &translation) const {
+  assert(track_index < m_tracks.size());
+  const animationtrack_t &track = m_tracks[track_index];
+  const animationkey_t *keys = &m_keys[track.m_firstKey];
+  const uint32_t last_key = track.m_keyCount - 1;
+
+  const float t = (time - track.m_startTime) * track.m_timeScale;
+  // Times that round to a key's quantized time are treated as that key so that
+  // sampling exactly at a key reproduces it.
+  const float search_t = t + 0.5f;
+
+  uint32_t key = cursor.m_key;
+  float alpha = 0.f;
+  if (t <= 0.f || !last_key) {
+    key = 0;
+  } else if (search_t >= keys[last_key].m_time) {
+    key = last_key;
+  } else {
+    // Playback is usually sequential, so the cached key or one shortly after
+    // it is almost always the active one.
+    if (key >= last_key || keys[key].m_time > search_t) {
+      key = 0;
+    }
+    uint32_t steps = 0;
+    while (keys[key + 1].m_time <= search_t && steps < kMaxLinearCursorSteps) {
+      ++key;
+      ++steps;
+    }
+
+    if (keys[key + 1].m_time <= search_t) {
+      uint32_t low = key + 1;
+      uint32_t high = last_key;
+      while (high - low > 1) {
+        const uint32_t mid = low + (high - low) / 2;
+        if (keys[mid].m_time <= search_t) {
+          low = mid;
+        } else {
+          high = mid;
+        }
+      }
+      key = low;
+    }
+
+    const float start = keys[key].m_time;
+    alpha = (t - start) / (static_cast<float>(keys[key + 1].m_time) - start);
+  }
+  cursor.m_key = key;
+
+  const animationkey_t &from = keys[key];
+  CQuaternion from_rotation;
+  QuaternionUnpackSmallestThree(from.m_rotation, from_rotation);
+
+  if (alpha <= 0.f) {
+    rotation = from_rotation;
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      translation[axis] =
+          track.m_translationMin[axis] +
+          track.m_translationScale[axis] * from.m_translation[axis];
+    }
+    translation[3] = 1.f;
+    return;
+  }
+
+  const animationkey_t &to = keys[key + 1];
+  CQuaternion to_rotation;
+  QuaternionUnpackSmallestThree(to.m_rotation, to_rotation);
+
+  // Normalized linear interpolation along the shortest arc. Keys are densely
+  // sampled, so the difference from Slerp is negligible.
+  float to_weight = alpha;
+  if (QuaternionDotQuaternion(from_rotation, to_rotation) < 0.f) {
+    to_weight = -alpha;
+  }
+  rotation = (1.f - alpha) * from_rotation + to_weight * to_rotation;
+  rotation.Normalize();
+
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    const float from_value = from.m_translation[axis];
+    const float to_value = to.m_translation[axis];
+    translation[axis] =
+        track.m_translationMin[axis] +
+        track.m_translationScale[axis] *
+            (from_value + (to_value - from_value) * alpha);
+  }
+  translation[3] = 1.f;
+}
+
+void CAnimationClip::SampleAllTracks(float time, animationcursor_t *cursors,
+                                     CQuaternion *rotations,
+                                     vector_t *translations) const {
+  const uint32_t track_count = GetTrackCount();
+  for (uint32_t i = 0; i < track_count; ++i) {
+    SampleTrack(i, time, cursors[i], rotations[i], translations[i]);
+  }
+}
+
+}  // namespace XboxMath
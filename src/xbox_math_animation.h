@@ -0,0 +1,86 @@
+#ifndef XBOX_MATH_ANIMATION_H_
+#define XBOX_MATH_ANIMATION_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "xbox_math_quaternion.h"
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! Packs the given unit quaternion into 48 bits using the "smallest three"
+//! encoding: the index of the largest component is stored in two bits and the
+//! remaining three components are quantized to 15 bits each.
+void QuaternionPackSmallestThree(const CQuaternion &q, uint16_t (&ret)[3]);
+
+//! Reconstructs a unit quaternion from a value produced by
+//! QuaternionPackSmallestThree.
+void QuaternionUnpackSmallestThree(const uint16_t (&packed)[3],
+                                   CQuaternion &ret);
+
+//! Caches the playback position within a single animation track so that
+//! sequential sampling does not need to search for the active key.
+typedef struct animationcursor_t {
+  uint32_t m_key;  // Index of the key at or before the last sampled time.
+} animationcursor_t;
+
+inline void AnimationCursorReset(animationcursor_t &cursor) {
+  cursor.m_key = 0;
+}
+
+//! A set of compressed rotation + translation tracks (e.g., one per bone of a
+//! skeleton) sharing a single contiguous key buffer.
+class CAnimationClip {
+ public:
+  //! Quantizes and appends a track. `times` must be strictly increasing.
+  //! \return false if the keys are empty or out of order.
+  bool AddTrack(const float *times, const CQuaternion *rotations,
+                const vector_t *translations, uint32_t key_count);
+
+  void Clear();
+
+  [[nodiscard]] uint32_t GetTrackCount() const {
+    return static_cast<uint32_t>(m_tracks.size());
+  }
+
+  //! Returns the latest key time across all tracks.
+  [[nodiscard]] float GetDuration() const { return m_duration; }
+
+  //! Returns the number of bytes used to hold the clip's tracks and keys.
+  [[nodiscard]] size_t GetMemoryUsage() const;
+
+  //! Samples a single track at `time`, updating `cursor`. Times outside of the
+  //! track's key range are clamped to the first/last key.
+  void SampleTrack(uint32_t track, float time, animationcursor_t &cursor,
+                   CQuaternion &rotation, vector_t &translation) const;
+
+  //! Samples every track at `time`. `cursors`, `rotations` and `translations`
+  //! must each hold GetTrackCount() entries.
+  void SampleAllTracks(float time, animationcursor_t *cursors,
+                       CQuaternion *rotations, vector_t *translations) const;
+
+ private:
+  typedef struct animationkey_t {
+    uint16_t m_time;  // Normalized over the owning track's time range.
+    uint16_t m_rotation[3];
+    uint16_t m_translation[3];
+  } animationkey_t;
+
+  typedef struct animationtrack_t {
+    uint32_t m_firstKey;
+    uint32_t m_keyCount;
+    float m_startTime;
+    float m_timeScale;  // Converts seconds to quantized key time.
+    float m_translationMin[3];
+    float m_translationScale[3];  // Converts quantized values to units.
+  } animationtrack_t;
+
+  std::vector<animationtrack_t> m_tracks;
+  std::vector<animationkey_t> m_keys;
+  float m_duration{0.f};
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_ANIMATION_H_
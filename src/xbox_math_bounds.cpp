@@ -0,0 +1,411 @@
+#include "xbox_math_bounds.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+namespace {
+
+using Simd::float4;
+
+// Stores the first `lanes` values of `values` at `ret`.
+inline void StoreLanes(float *ret, uint32_t lanes, float4 values) {
+  if (lanes == 4) {
+    Simd::StoreUnaligned(ret, values);
+    return;
+  }
+  float buffer[4];
+  Simd::StoreUnaligned(buffer, values);
+  for (uint32_t lane = 0; lane < lanes; ++lane) {
+    ret[lane] = buffer[lane];
+  }
+}
+
+// The rows of an affine matrix, as loaded for transforming points.
+struct AffineRows {
+  float4 m_rows[4];
+
+  explicit AffineRows(const matrix4_t &matrix) {
+    for (uint32_t i = 0; i < 4; ++i) {
+      m_rows[i] = Simd::LoadUnaligned(matrix[i]);
+    }
+  }
+
+  // `point` * matrix, with the point's w taken as 1.
+  [[nodiscard]] float4 TransformPoint(const float *point) const {
+    using namespace Simd;
+    float4 ret = MulAdd(Set1(point[0]), m_rows[0], m_rows[3]);
+    ret = MulAdd(Set1(point[1]), m_rows[1], ret);
+    return MulAdd(Set1(point[2]), m_rows[2], ret);
+  }
+};
+
+// The x, y and z of `a` dotted with those of `b`, for four vectors in SoA
+// layout.
+inline float4 Dot3(const float4 *a, const float4 *b) {
+  using namespace Simd;
+  return MulAdd(a[2], b[2], MulAdd(a[1], b[1], Mul(a[0], b[0])));
+}
+
+// How much each of four matrices can grow a sphere's radius.
+//
+// That is at most the largest singular value of the upper 3x3, the square root
+// of the largest eigenvalue of its rows' Gram matrix G. By Gershgorin's
+// theorem that eigenvalue is at most the largest G[i][i] + |G[i][j]| +
+// |G[i][k]|, which is exact for rotations with uniform scale and conservative
+// for any other scale or shear.
+float4 RadiusScales(const matrix4_t &m0, const matrix4_t &m1,
+                    const matrix4_t &m2, const matrix4_t &m3) {
+  using namespace Simd;
+  float4 rows[3][4];  // Row, then component, across the four matrices.
+  for (uint32_t row = 0; row < 3; ++row) {
+    rows[row][0] = LoadUnaligned(m0[row]);
+    rows[row][1] = LoadUnaligned(m1[row]);
+    rows[row][2] = LoadUnaligned(m2[row]);
+    rows[row][3] = LoadUnaligned(m3[row]);
+    Transpose(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+  }
+  const float4 g00 = Dot3(rows[0], rows[0]);
+  const float4 g11 = Dot3(rows[1], rows[1]);
+  const float4 g22 = Dot3(rows[2], rows[2]);
+  const float4 g01 = Abs(Dot3(rows[0], rows[1]));
+  const float4 g02 = Abs(Dot3(rows[0], rows[2]));
+  const float4 g12 = Abs(Dot3(rows[1], rows[2]));
+  return Sqrt(Max(Max(Add(g00, Add(g01, g02)), Add(g11, Add(g01, g12))),
+                  Add(g22, Add(g02, g12))));
+}
+
+// Calls `matrix_at(i)` for the matrix of each sphere, and
+// `scales_at(indices)` for the RadiusScales of four of them.
+template <typename MatrixAt, typename ScalesAt>
+void TransformSpheres(const boundingsphere_t *spheres, uint32_t count,
+                      MatrixAt matrix_at, ScalesAt scales_at,
+                      boundingspheresoa_t &ret) {
+  using namespace Simd;
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t lanes = count - first < 4 ? count - first : 4;
+    uint32_t indices[4];
+    float4 centers[4];
+    float radii[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      const uint32_t i = first + (lane < lanes ? lane : lanes - 1);
+      indices[lane] = i;
+      centers[lane] =
+          AffineRows(matrix_at(i)).TransformPoint(spheres[i].m_centerPt);
+      radii[lane] = spheres[i].m_radius;
+    }
+    Transpose(centers[0], centers[1], centers[2], centers[3]);
+
+    StoreLanes(ret.m_centerX + first, lanes, centers[0]);
+    StoreLanes(ret.m_centerY + first, lanes, centers[1]);
+    StoreLanes(ret.m_centerZ + first, lanes, centers[2]);
+    StoreLanes(ret.m_radius + first, lanes,
+               Mul(Set(radii[0], radii[1], radii[2], radii[3]),
+                   scales_at(indices)));
+  }
+}
+
+// Calls `matrix_at(i)` for the matrix of each box.
+template <typename MatrixAt>
+void TransformBoxes(const aabb_t *boxes, uint32_t count, MatrixAt matrix_at,
+                    aabbsoa_t &ret) {
+  using namespace Simd;
+  const float4 half = Set1(0.5f);
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t lanes = count - first < 4 ? count - first : 4;
+    float4 mins[4];
+    float4 maxs[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      const uint32_t i = first + (lane < lanes ? lane : lanes - 1);
+      const AffineRows rows(matrix_at(i));
+      const float4 box_min = LoadUnaligned(boxes[i].m_minPt);
+      const float4 box_max = LoadUnaligned(boxes[i].m_maxPt);
+      float center[4];
+      float extent[4];
+      StoreUnaligned(center, Mul(Add(box_min, box_max), half));
+      StoreUnaligned(extent, Mul(Sub(box_max, box_min), half));
+
+      // Each world axis extends by the absolute matrix entries times the
+      // local extents.
+      const float4 world_center = rows.TransformPoint(center);
+      float4 world_extent = Mul(Set1(extent[0]), Abs(rows.m_rows[0]));
+      world_extent = MulAdd(Set1(extent[1]), Abs(rows.m_rows[1]), world_extent);
+      world_extent = MulAdd(Set1(extent[2]), Abs(rows.m_rows[2]), world_extent);
+      mins[lane] = Sub(world_center, world_extent);
+      maxs[lane] = Add(world_center, world_extent);
+    }
+    Transpose(mins[0], mins[1], mins[2], mins[3]);
+    Transpose(maxs[0], maxs[1], maxs[2], maxs[3]);
+
+    StoreLanes(ret.m_minX + first, lanes, mins[0]);
+    StoreLanes(ret.m_minY + first, lanes, mins[1]);
+    StoreLanes(ret.m_minZ + first, lanes, mins[2]);
+    StoreLanes(ret.m_maxX + first, lanes, maxs[0]);
+    StoreLanes(ret.m_maxY + first, lanes, maxs[1]);
+    StoreLanes(ret.m_maxZ + first, lanes, maxs[2]);
+  }
+}
+
+// Finds the points with the smallest and largest projections onto each of
+// `direction_count` directions (x, y and z, followed by diagonals), four
+// points at a time.
+template <uint32_t direction_count>
+void FindExtremalPoints(const vertex_t *points, uint32_t count,
+                        uint32_t (&min_index)[direction_count],
+                        uint32_t (&max_index)[direction_count]) {
+  using namespace Simd;
+  static const float kDirections[7][3] = {
+      {1.f, 0.f, 0.f}, {0.f, 1.f, 0.f},  {0.f, 0.f, 1.f},  {1.f, 1.f, 1.f},
+      {1.f, 1.f, -1.f}, {1.f, -1.f, 1.f}, {1.f, -1.f, -1.f}};
+  static_assert(direction_count <= 7, "Too many directions");
+
+  // Groups of four points are numbered with floats, exact for 2^26 points.
+  float4 min_projection[direction_count];
+  float4 max_projection[direction_count];
+  float4 min_group[direction_count];
+  float4 max_group[direction_count];
+  for (uint32_t d = 0; d < direction_count; ++d) {
+    min_projection[d] = Set1(FLT_MAX);
+    max_projection[d] = Set1(-FLT_MAX);
+    min_group[d] = max_group[d] = Zero();
+  }
+
+  float4 group = Zero();
+  const float4 one = Set1(1.f);
+  for (uint32_t first = 0; first < count; first += 4) {
+    float4 rows[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      // Past the end, repeat the last point. It can only tie.
+      rows[lane] = LoadUnaligned(points[first + lane < count ? first + lane
+                                                            : count - 1]);
+    }
+    Transpose(rows[0], rows[1], rows[2], rows[3]);
+    for (uint32_t d = 0; d < direction_count; ++d) {
+      const float4 projection =
+          d < 3 ? rows[d]
+                : MulAdd(rows[0], Set1(kDirections[d][0]),
+                         MulAdd(rows[1], Set1(kDirections[d][1]),
+                                Mul(rows[2], Set1(kDirections[d][2]))));
+      const float4 smaller = CmpLt(projection, min_projection[d]);
+      min_projection[d] = Select(smaller, projection, min_projection[d]);
+      min_group[d] = Select(smaller, group, min_group[d]);
+      const float4 larger = CmpGt(projection, max_projection[d]);
+      max_projection[d] = Select(larger, projection, max_projection[d]);
+      max_group[d] = Select(larger, group, max_group[d]);
+    }
+    group = Add(group, one);
+  }
+
+  for (uint32_t d = 0; d < direction_count; ++d) {
+    float projections[2][4];
+    float groups[2][4];
+    StoreUnaligned(projections[0], min_projection[d]);
+    StoreUnaligned(projections[1], max_projection[d]);
+    StoreUnaligned(groups[0], min_group[d]);
+    StoreUnaligned(groups[1], max_group[d]);
+    uint32_t min_lane = 0, max_lane = 0;
+    for (uint32_t lane = 1; lane < 4; ++lane) {
+      if (projections[0][lane] < projections[0][min_lane]) {
+        min_lane = lane;
+      }
+      if (projections[1][lane] > projections[1][max_lane]) {
+        max_lane = lane;
+      }
+    }
+    min_index[d] = std::min(
+        static_cast<uint32_t>(groups[0][min_lane]) * 4 + min_lane, count - 1);
+    max_index[d] = std::min(
+        static_cast<uint32_t>(groups[1][max_lane]) * 4 + max_lane, count - 1);
+  }
+}
+
+// Starts a sphere at the farthest apart of the extremal point pairs.
+template <uint32_t direction_count>
+void InitialSphere(const vertex_t *points, uint32_t count, float (&center)[3],
+                   float &radius) {
+  uint32_t min_index[direction_count];
+  uint32_t max_index[direction_count];
+  FindExtremalPoints(points, count, min_index, max_index);
+  uint32_t best = 0;
+  float best_distance = -1.f;
+  for (uint32_t d = 0; d < direction_count; ++d) {
+    const float distance =
+        PointDistanceSquaredPoint(points[min_index[d]], points[max_index[d]]);
+    if (distance > best_distance) {
+      best = d;
+      best_distance = distance;
+    }
+  }
+  const float *a = points[min_index[best]];
+  const float *b = points[max_index[best]];
+  for (uint32_t i = 0; i < 3; ++i) {
+    center[i] = (a[i] + b[i]) * 0.5f;
+  }
+  radius = sqrtf(best_distance) * 0.5f;
+}
+
+// Grows the sphere to include every point, starting from `first` and wrapping
+// around the end of the array, testing four points at a time. Points outside
+// are rare once the sphere is close to its final size.
+void GrowSphere(const vertex_t *points, uint32_t point_count, uint32_t first,
+                float (&center)[3], float &radius) {
+  using namespace Simd;
+  for (uint32_t done = 0; done < point_count; done += 4) {
+    const uint32_t lanes = point_count - done < 4 ? point_count - done : 4;
+    uint32_t indices[4];
+    float4 rows[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      indices[lane] = first + done + (lane < lanes ? lane : 0);
+      if (indices[lane] >= point_count) {
+        indices[lane] -= point_count;
+      }
+      rows[lane] = LoadUnaligned(points[indices[lane]]);
+    }
+    Transpose(rows[0], rows[1], rows[2], rows[3]);
+    const float4 dx = Sub(rows[0], Set1(center[0]));
+    const float4 dy = Sub(rows[1], Set1(center[1]));
+    const float4 dz = Sub(rows[2], Set1(center[2]));
+    const float4 distance_squared = MulAdd(dx, dx, MulAdd(dy, dy, Mul(dz, dz)));
+    if (MoveMask(CmpGt(distance_squared, Set1(radius * radius))) == 0) {
+      continue;
+    }
+    // Earlier lanes may have grown the sphere, so recheck each in order.
+    for (uint32_t lane = 0; lane < lanes; ++lane) {
+      const float *point = points[indices[lane]];
+      const float offset[3] = {point[0] - center[0], point[1] - center[1],
+                               point[2] - center[2]};
+      const float distance_sq = offset[0] * offset[0] +
+                                offset[1] * offset[1] + offset[2] * offset[2];
+      if (distance_sq <= radius * radius) {
+        continue;
+      }
+      // Move the center towards the point, keeping the far side in place.
+      const float distance = sqrtf(distance_sq);
+      const float new_radius = (radius + distance) * 0.5f;
+      const float step = (new_radius - radius) / distance;
+      for (uint32_t i = 0; i < 3; ++i) {
+        center[i] += offset[i] * step;
+      }
+      radius = new_radius;
+    }
+  }
+}
+
+void SetSphere(const float (&center)[3], float radius, boundingsphere_t &ret) {
+  ret.m_centerPt[0] = center[0];
+  ret.m_centerPt[1] = center[1];
+  ret.m_centerPt[2] = center[2];
+  ret.m_centerPt[3] = 1.f;
+  ret.m_radius = radius;
+}
+
+}  // namespace
+
+void TransformBoundingSpheres(const boundingsphere_t *spheres, uint32_t count,
+                              const matrix4_t *matrices,
+                              boundingspheresoa_t &ret) {
+  TransformSpheres(
+      spheres, count,
+      [matrices](uint32_t i) -> const matrix4_t & { return matrices[i]; },
+      [matrices](const uint32_t(&indices)[4]) {
+        return RadiusScales(matrices[indices[0]], matrices[indices[1]],
+                            matrices[indices[2]], matrices[indices[3]]);
+      },
+      ret);
+}
+
+void TransformBoundingSpheres(const boundingsphere_t *spheres, uint32_t count,
+                              const matrix4_t &matrix,
+                              boundingspheresoa_t &ret) {
+  // One matrix needs only one bound.
+  const float4 scale = RadiusScales(matrix, matrix, matrix, matrix);
+  TransformSpheres(
+      spheres, count,
+      [&matrix](uint32_t) -> const matrix4_t & { return matrix; },
+      [scale](const uint32_t(&)[4]) { return scale; }, ret);
+}
+
+void TransformAABBs(const aabb_t *boxes, uint32_t count,
+                    const matrix4_t *matrices, aabbsoa_t &ret) {
+  TransformBoxes(
+      boxes, count,
+      [matrices](uint32_t i) -> const matrix4_t & { return matrices[i]; },
+      ret);
+}
+
+void TransformAABBs(const aabb_t *boxes, uint32_t count,
+                    const matrix4_t &matrix, aabbsoa_t &ret) {
+  TransformBoxes(
+      boxes, count,
+      [&matrix](uint32_t) -> const matrix4_t & { return matrix; }, ret);
+}
+
+bool BoundingSphereFromPointsRitter(const vertex_t *points, uint32_t count,
+                                    boundingsphere_t &ret) {
+  if (count == 0) {
+    return false;
+  }
+  float center[3];
+  float radius;
+  InitialSphere<3>(points, count, center, radius);
+  GrowSphere(points, count, 0, center, radius);
+  SetSphere(center, radius, ret);
+  return true;
+}
+
+bool BoundingSphereFromPointsEPOS(const vertex_t *points, uint32_t count,
+                                  boundingsphere_t &ret, uint32_t iterations) {
+  if (count == 0) {
+    return false;
+  }
+  float center[3];
+  float radius;
+  InitialSphere<7>(points, count, center, radius);
+  GrowSphere(points, count, 0, center, radius);
+
+  // Each attempt starts from a smaller sphere and a different point, which
+  // lets the center drift towards the optimum.
+  float best_center[3] = {center[0], center[1], center[2]};
+  float best_radius = radius;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    radius = best_radius * 0.95f;
+    const auto first = static_cast<uint32_t>(
+        static_cast<uint64_t>(count) * (i + 1) / (iterations + 1));
+    GrowSphere(points, count, first, center, radius);
+    if (radius < best_radius) {
+      std::copy_n(center, 3, best_center);
+      best_radius = radius;
+    } else {
+      std::copy_n(best_center, 3, center);
+    }
+  }
+  SetSphere(best_center, best_radius, ret);
+  return true;
+}
+
+void BoundingSphereMerge(const boundingsphere_t &a, const boundingsphere_t &b,
+                         boundingsphere_t &ret) {
+  const float distance = PointDistancePoint(a.m_centerPt, b.m_centerPt);
+  if (distance + b.m_radius <= a.m_radius) {
+    ret = a;
+    return;
+  }
+  if (distance + a.m_radius <= b.m_radius) {
+    ret = b;
+    return;
+  }
+  // Spans from the far side of a to the far side of b.
+  const float radius = (distance + a.m_radius + b.m_radius) * 0.5f;
+  const float step = (radius - a.m_radius) / distance;
+  for (uint32_t i = 0; i < 3; ++i) {
+    ret.m_centerPt[i] =
+        a.m_centerPt[i] + (b.m_centerPt[i] - a.m_centerPt[i]) * step;
+  }
+  ret.m_centerPt[3] = 1.f;
+  ret.m_radius = radius;
+}
+
+}  // namespace XboxMath
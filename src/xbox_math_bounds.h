@@ -0,0 +1,80 @@
+#ifndef XBOX_MATH_BOUNDS_H_
+#define XBOX_MATH_BOUNDS_H_
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! Bounding spheres in structure of arrays layout, e.g. for culling four at a
+//! time. Each array is owned by the caller and holds one float per sphere.
+typedef struct boundingspheresoa_t {
+  float *m_centerX;
+  float *m_centerY;
+  float *m_centerZ;
+  float *m_radius;
+} boundingspheresoa_t;
+
+//! Axis aligned boxes in structure of arrays layout, as above.
+typedef struct aabbsoa_t {
+  float *m_minX;
+  float *m_minY;
+  float *m_minZ;
+  float *m_maxX;
+  float *m_maxY;
+  float *m_maxZ;
+} aabbsoa_t;
+
+//! Transforms `count` local space spheres by their objects' affine
+//! `matrices`, writing world space spheres to `ret`. Centers are transformed
+//! as by VectorMultMatrix. Radii are scaled by a bound on how far the upper
+//! 3x3 can stretch any direction, which is exact for rotations with uniform
+//! scale and keeps the results conservative under non-uniform scale or shear
+//! in either order.
+void TransformBoundingSpheres(const boundingsphere_t *spheres, uint32_t count,
+                              const matrix4_t *matrices,
+                              boundingspheresoa_t &ret);
+
+//! As above, with one `matrix` for every sphere.
+void TransformBoundingSpheres(const boundingsphere_t *spheres, uint32_t count,
+                              const matrix4_t &matrix,
+                              boundingspheresoa_t &ret);
+
+//! Transforms `count` local space boxes by their objects' affine `matrices`,
+//! writing the smallest world space boxes containing them to `ret`, using
+//! Arvo's method ("Transforming Axis-Aligned Bounding Boxes", Graphics Gems,
+//! 1990) in its center and extent form.
+void TransformAABBs(const aabb_t *boxes, uint32_t count,
+                    const matrix4_t *matrices, aabbsoa_t &ret);
+
+//! As above, with one `matrix` for every box.
+void TransformAABBs(const aabb_t *boxes, uint32_t count,
+                    const matrix4_t &matrix, aabbsoa_t &ret);
+
+//! Computes a sphere containing `count` points with Ritter's algorithm ("An
+//! Efficient Bounding Sphere", Graphics Gems, 1990): starts from the farthest
+//! apart pair of the points extremal along x, y and z, then grows the sphere
+//! to include each point outside it. Typically 5-20% larger than the minimum
+//! sphere.
+//! \return false if `count` is 0.
+bool BoundingSphereFromPointsRitter(const vertex_t *points, uint32_t count,
+                                    boundingsphere_t &ret);
+
+//! Computes a tighter sphere than BoundingSphereFromPointsRitter, at a few
+//! times the cost. The initial pair is chosen from the points extremal along
+//! seven directions, as in the EPOS algorithm ("Fast and Tight Fitting
+//! Bounding Spheres", Larsson, 2008), and the result is then refined
+//! `iterations` times by shrinking the sphere and growing it again over the
+//! points taken in a different order, keeping the smallest sphere found.
+//! \return false if `count` is 0.
+bool BoundingSphereFromPointsEPOS(const vertex_t *points, uint32_t count,
+                                  boundingsphere_t &ret,
+                                  uint32_t iterations = 8);
+
+//! Computes the smallest sphere containing both `a` and `b`, e.g. for building
+//! a sphere hierarchy bottom up.
+void BoundingSphereMerge(const boundingsphere_t &a, const boundingsphere_t &b,
+                         boundingsphere_t &ret);
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_BOUNDS_H_
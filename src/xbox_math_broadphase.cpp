@@ -0,0 +1,169 @@
+#include "xbox_math_broadphase.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <utility>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+// Lets the sweep load four spheres past the last one.
+static constexpr uint32_t kPadding = 4;
+
+CSweepAndPrune::CSweepAndPrune(uint32_t axis)
+    : m_axis(axis), m_addedSinceSort(0) {}
+
+uint32_t CSweepAndPrune::Add(const boundingsphere_t &sphere) {
+  uint32_t handle;
+  if (m_freeHandles.empty()) {
+    handle = static_cast<uint32_t>(m_objects.size());
+    m_objects.push_back({{0.f, 0.f, 0.f, 1.f}, 0.f, false, false});
+  } else {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  }
+  sapobject_t &object = m_objects[handle];
+  object.m_live = true;
+  // A removed handle may still be in the sorted order.
+  if (!object.m_sorted) {
+    object.m_sorted = true;
+    m_sortedHandles.push_back(handle);
+    ++m_addedSinceSort;
+  }
+  Update(handle, sphere);
+  return handle;
+}
+
+void CSweepAndPrune::Update(uint32_t handle, const boundingsphere_t &sphere) {
+  sapobject_t &object = m_objects[handle];
+  for (uint32_t i = 0; i < 4; ++i) {
+    object.m_center[i] = sphere.m_centerPt[i];
+  }
+  object.m_radius = sphere.m_radius;
+}
+
+void CSweepAndPrune::Remove(uint32_t handle) {
+  // Left in the sorted order until the next sort.
+  m_objects[handle].m_live = false;
+  m_freeHandles.push_back(handle);
+}
+
+void CSweepAndPrune::Clear() {
+  m_objects.clear();
+  m_freeHandles.clear();
+  m_sortedHandles.clear();
+  m_addedSinceSort = 0;
+}
+
+void CSweepAndPrune::Sort() {
+  // Drop removed spheres and refresh where the others start.
+  auto count = static_cast<uint32_t>(m_sortedHandles.size());
+  m_sortedStart.resize(count);
+  uint32_t live_count = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint32_t handle = m_sortedHandles[i];
+    sapobject_t &object = m_objects[handle];
+    if (!object.m_live) {
+      object.m_sorted = false;
+      continue;
+    }
+    m_sortedHandles[live_count] = handle;
+    m_sortedStart[live_count] = object.m_center[m_axis] - object.m_radius;
+    ++live_count;
+  }
+  count = live_count;
+  m_sortedHandles.resize(count);
+
+  // Many new spheres are appended out of order, so sort those from scratch.
+  // Otherwise use insertion sort, close to linear when the order changed
+  // little.
+  if (m_addedSinceSort > count / 8) {
+    std::vector<std::pair<float, uint32_t>> order(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      order[i] = {m_sortedStart[i], m_sortedHandles[i]};
+    }
+    std::sort(order.begin(), order.end());
+    for (uint32_t i = 0; i < count; ++i) {
+      m_sortedStart[i] = order[i].first;
+      m_sortedHandles[i] = order[i].second;
+    }
+  }
+  m_addedSinceSort = 0;
+  for (uint32_t i = 1; i < count; ++i) {
+    const float start = m_sortedStart[i];
+    if (m_sortedStart[i - 1] <= start) {
+      continue;
+    }
+    const uint32_t handle = m_sortedHandles[i];
+    uint32_t j = i;
+    do {
+      m_sortedStart[j] = m_sortedStart[j - 1];
+      m_sortedHandles[j] = m_sortedHandles[j - 1];
+      --j;
+    } while (j > 0 && m_sortedStart[j - 1] > start);
+    m_sortedStart[j] = start;
+    m_sortedHandles[j] = handle;
+  }
+
+  // Padding spheres start past every other sphere's end.
+  m_sortedStart.resize(count + kPadding);
+  m_sortedX.resize(count + kPadding);
+  m_sortedY.resize(count + kPadding);
+  m_sortedZ.resize(count + kPadding);
+  m_sortedRadius.resize(count + kPadding);
+  for (uint32_t i = 0; i < count; ++i) {
+    const sapobject_t &object = m_objects[m_sortedHandles[i]];
+    m_sortedX[i] = object.m_center[0];
+    m_sortedY[i] = object.m_center[1];
+    m_sortedZ[i] = object.m_center[2];
+    m_sortedRadius[i] = object.m_radius;
+  }
+  for (uint32_t i = count; i < count + kPadding; ++i) {
+    m_sortedStart[i] = FLT_MAX;
+    m_sortedX[i] = m_sortedY[i] = m_sortedZ[i] = m_sortedRadius[i] = 0.f;
+  }
+}
+
+uint32_t CSweepAndPrune::FindPairs(std::vector<broadphasepair_t> &pairs) {
+  using namespace Simd;
+  Sort();
+  pairs.clear();
+
+  const auto count = static_cast<uint32_t>(m_sortedHandles.size());
+  for (uint32_t i = 0; i < count; ++i) {
+    const float radius = m_sortedRadius[i];
+    const float4 end = Set1(m_sortedStart[i] + 2.f * radius);
+    const float4 x = Set1(m_sortedX[i]);
+    const float4 y = Set1(m_sortedY[i]);
+    const float4 z = Set1(m_sortedZ[i]);
+    const float4 radius4 = Set1(radius);
+    const uint32_t handle = m_sortedHandles[i];
+
+    // Every sphere starting before this one ends overlaps it along the axis.
+    // Once one starts after that, so do all the following ones.
+    int on_axis = 0xF;
+    for (uint32_t j = i + 1; on_axis == 0xF; j += 4) {
+      on_axis = MoveMask(CmpLe(LoadUnaligned(&m_sortedStart[j]), end));
+      const float4 dx = Sub(LoadUnaligned(&m_sortedX[j]), x);
+      const float4 dy = Sub(LoadUnaligned(&m_sortedY[j]), y);
+      const float4 dz = Sub(LoadUnaligned(&m_sortedZ[j]), z);
+      const float4 reach =
+          Simd::Add(LoadUnaligned(&m_sortedRadius[j]), radius4);
+      int overlapping =
+          MoveMask(CmpLe(MulAdd(dx, dx, MulAdd(dy, dy, Mul(dz, dz))),
+                         Mul(reach, reach))) &
+          on_axis;
+      for (uint32_t lane = 0; overlapping != 0; ++lane, overlapping >>= 1) {
+        if (overlapping & 1) {
+          const uint32_t other = m_sortedHandles[j + lane];
+          pairs.push_back(handle < other ? broadphasepair_t{handle, other}
+                                         : broadphasepair_t{other, handle});
+        }
+      }
+    }
+  }
+  return static_cast<uint32_t>(pairs.size());
+}
+
+}  // namespace XboxMath
@@ -0,0 +1,78 @@
+#ifndef XBOX_MATH_BROADPHASE_H_
+#define XBOX_MATH_BROADPHASE_H_
+
+#include <vector>
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! Two overlapping objects, identified by their handles, with m_first <
+//! m_second.
+typedef struct broadphasepair_t {
+  uint32_t m_first;
+  uint32_t m_second;
+} broadphasepair_t;
+
+//! A sweep and prune broadphase over bounding spheres.
+//!
+//! Spheres are kept sorted by where they start along one axis. FindPairs
+//! re-sorts them with an insertion sort, which takes close to linear time when
+//! objects move little between calls (after many additions, it sorts from
+//! scratch instead). It then sweeps along the axis and tests the spheres whose
+//! extents overlap on it four at a time.
+class CSweepAndPrune {
+ public:
+  //! Sorts along x, y or z for `axis` 0, 1 or 2. Choose the axis along which
+  //! objects are most spread out.
+  explicit CSweepAndPrune(uint32_t axis = 0);
+
+  //! \return the sphere's handle, which stays valid until it is removed and
+  //! may then be reused.
+  uint32_t Add(const boundingsphere_t &sphere);
+
+  void Update(uint32_t handle, const boundingsphere_t &sphere);
+
+  void Remove(uint32_t handle);
+
+  //! Removes every sphere.
+  void Clear();
+
+  [[nodiscard]] uint32_t GetObjectCount() const {
+    return static_cast<uint32_t>(m_objects.size() - m_freeHandles.size());
+  }
+
+  //! Replaces `pairs` with every pair of overlapping or touching spheres, in no
+  //! particular order.
+  //! \return the number of pairs.
+  uint32_t FindPairs(std::vector<broadphasepair_t> &pairs);
+
+ private:
+  typedef struct sapobject_t {
+    vector_t m_center;
+    float m_radius;
+    bool m_live;
+    bool m_sorted;  // Whether the handle is in m_sortedHandles.
+  } sapobject_t;
+
+  void Sort();
+
+  uint32_t m_axis;
+  uint32_t m_addedSinceSort;
+  std::vector<sapobject_t> m_objects;
+  std::vector<uint32_t> m_freeHandles;
+
+  // Handles sorted by where their spheres start along the axis, followed by
+  // the spheres in the same order, one component per array. The sphere
+  // arrays are padded for four wide loads.
+  std::vector<uint32_t> m_sortedHandles;
+  std::vector<float> m_sortedStart;
+  std::vector<float> m_sortedX;
+  std::vector<float> m_sortedY;
+  std::vector<float> m_sortedZ;
+  std::vector<float> m_sortedRadius;
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_BROADPHASE_H_
@@ -0,0 +1,361 @@
+#include "xbox_math_bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace XboxMath {
+
+static constexpr uint32_t kBinCount = 16;
+static constexpr uint32_t kMaxLeafTriangles = 4;
+// Beyond this depth nodes are split at the median to bound the traversal stack.
+static constexpr uint32_t kMaxSahDepth = 32;
+static constexpr uint32_t kTraversalStackSize = 64;
+
+namespace {
+
+struct Bounds {
+  float min_pt[3];
+  float max_pt[3];
+
+  void Reset() {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      min_pt[axis] = FLT_MAX;
+      max_pt[axis] = -FLT_MAX;
+    }
+  }
+
+  void Grow(const float *point) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      min_pt[axis] = std::min(min_pt[axis], point[axis]);
+      max_pt[axis] = std::max(max_pt[axis], point[axis]);
+    }
+  }
+
+  void Grow(const Bounds &other) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      min_pt[axis] = std::min(min_pt[axis], other.min_pt[axis]);
+      max_pt[axis] = std::max(max_pt[axis], other.max_pt[axis]);
+    }
+  }
+
+  float HalfArea() const {
+    const float dx = max_pt[0] - min_pt[0];
+    const float dy = max_pt[1] - min_pt[1];
+    const float dz = max_pt[2] - min_pt[2];
+    if (dx < 0.f) {
+      return 0.f;
+    }
+    return dx * dy + dy * dz + dz * dx;
+  }
+};
+
+struct BuildTask {
+  uint32_t node;
+  uint32_t first;
+  uint32_t count;
+  uint32_t depth;
+};
+
+}  // namespace
+
+// Slab test against a node's box. Returns the entry distance or FLT_MAX when
+// the box is missed or lies beyond `max_distance`.
+static inline float IntersectNode(const float *min_pt, const float *max_pt,
+                                  const float *origin,
+                                  const float *inverse_direction,
+                                  float max_distance) {
+  float t_enter = 0.f;
+  float t_exit = max_distance;
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    const float t0 = (min_pt[axis] - origin[axis]) * inverse_direction[axis];
+    const float t1 = (max_pt[axis] - origin[axis]) * inverse_direction[axis];
+    t_enter = std::max(t_enter, std::min(t0, t1));
+    t_exit = std::min(t_exit, std::max(t0, t1));
+  }
+  return t_enter <= t_exit ? t_enter : FLT_MAX;
+}
+
+bool CTriangleBVH::Build(const vertex_t *vertices, uint32_t vertex_count,
+                         const uint32_t *indices, uint32_t triangle_count) {
+  Clear();
+  if (!vertex_count || !triangle_count) {
+    return false;
+  }
+  for (uint32_t i = 0; i < triangle_count * 3; ++i) {
+    if (indices[i] >= vertex_count) {
+      return false;
+    }
+  }
+
+  m_vertices.resize(static_cast<size_t>(vertex_count) * 4);
+  for (uint32_t i = 0; i < vertex_count; ++i) {
+    std::copy(vertices[i], vertices[i] + 4, &m_vertices[i * 4]);
+  }
+
+  std::vector<Bounds> triangle_bounds(triangle_count);
+  std::vector<float> centroids(static_cast<size_t>(triangle_count) * 3);
+  for (uint32_t i = 0; i < triangle_count; ++i) {
+    Bounds &bounds = triangle_bounds[i];
+    bounds.Reset();
+    for (uint32_t corner = 0; corner < 3; ++corner) {
+      bounds.Grow(vertices[indices[i * 3 + corner]]);
+    }
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      centroids[i * 3 + axis] =
+          (bounds.min_pt[axis] + bounds.max_pt[axis]) * 0.5f;
+    }
+  }
+
+  m_triangleIds.resize(triangle_count);
+  for (uint32_t i = 0; i < triangle_count; ++i) {
+    m_triangleIds[i] = i;
+  }
+
+  m_nodes.reserve(static_cast<size_t>(triangle_count) * 2);
+  m_nodes.push_back(bvhnode_t());
+
+  std::vector<BuildTask> tasks;
+  tasks.push_back({0, 0, triangle_count, 0});
+  while (!tasks.empty()) {
+    const BuildTask task = tasks.back();
+    tasks.pop_back();
+    uint32_t *ids = &m_triangleIds[task.first];
+
+    Bounds bounds, centroid_bounds;
+    bounds.Reset();
+    centroid_bounds.Reset();
+    for (uint32_t i = 0; i < task.count; ++i) {
+      bounds.Grow(triangle_bounds[ids[i]]);
+      centroid_bounds.Grow(&centroids[ids[i] * 3]);
+    }
+
+    bvhnode_t &node = m_nodes[task.node];
+    std::copy(bounds.min_pt, bounds.min_pt + 3, node.m_minPt);
+    std::copy(bounds.max_pt, bounds.max_pt + 3, node.m_maxPt);
+    node.m_leftOrFirst = task.first;
+    node.m_triangleCount = task.count;
+    if (task.count <= kMaxLeafTriangles) {
+      continue;
+    }
+
+    uint32_t split_axis = 0;
+    for (uint32_t axis = 1; axis < 3; ++axis) {
+      if (centroid_bounds.max_pt[axis] - centroid_bounds.min_pt[axis] >
+          centroid_bounds.max_pt[split_axis] -
+              centroid_bounds.min_pt[split_axis]) {
+        split_axis = axis;
+      }
+    }
+    if (centroid_bounds.max_pt[split_axis] <=
+        centroid_bounds.min_pt[split_axis]) {
+      // All centroids coincide, so no split can separate the triangles.
+      continue;
+    }
+
+    uint32_t left_count = 0;
+    if (task.depth < kMaxSahDepth) {
+      // Evaluate the surface area heuristic at every bin boundary of every
+      // axis and keep the cheapest split.
+      float best_cost = bounds.HalfArea() * static_cast<float>(task.count);
+      uint32_t best_axis = 0;
+      uint32_t best_bin = 0;
+      bool found_split = false;
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        const float low = centroid_bounds.min_pt[axis];
+        const float extent = centroid_bounds.max_pt[axis] - low;
+        if (extent <= 0.f) {
+          continue;
+        }
+        const float bin_scale = kBinCount / extent;
+
+        Bounds bins[kBinCount];
+        uint32_t bin_counts[kBinCount] = {};
+        for (auto &bin : bins) {
+          bin.Reset();
+        }
+        for (uint32_t i = 0; i < task.count; ++i) {
+          uint32_t bin = static_cast<uint32_t>(
+              (centroids[ids[i] * 3 + axis] - low) * bin_scale);
+          bin = std::min(bin, kBinCount - 1);
+          bins[bin].Grow(triangle_bounds[ids[i]]);
+          ++bin_counts[bin];
+        }
+
+        float right_areas[kBinCount];
+        uint32_t right_counts[kBinCount];
+        Bounds right;
+        right.Reset();
+        uint32_t right_count = 0;
+        for (uint32_t bin = kBinCount - 1; bin > 0; --bin) {
+          right.Grow(bins[bin]);
+          right_count += bin_counts[bin];
+          right_areas[bin] = right.HalfArea();
+          right_counts[bin] = right_count;
+        }
+
+        Bounds left;
+        left.Reset();
+        uint32_t count = 0;
+        for (uint32_t bin = 0; bin < kBinCount - 1; ++bin) {
+          left.Grow(bins[bin]);
+          count += bin_counts[bin];
+          if (!count || !right_counts[bin + 1]) {
+            continue;
+          }
+          const float cost =
+              left.HalfArea() * static_cast<float>(count) +
+              right_areas[bin + 1] * static_cast<float>(right_counts[bin + 1]);
+          if (cost < best_cost) {
+            best_cost = cost;
+            best_axis = axis;
+            best_bin = bin;
+            found_split = true;
+          }
+        }
+      }
+
+      if (!found_split) {
+        continue;
+      }
+
+      const float low = centroid_bounds.min_pt[best_axis];
+      const float bin_scale =
+          kBinCount / (centroid_bounds.max_pt[best_axis] - low);
+      uint32_t *middle =
+          std::partition(ids, ids + task.count, [&](uint32_t id) {
+            uint32_t bin = static_cast<uint32_t>(
+                (centroids[id * 3 + best_axis] - low) * bin_scale);
+            return std::min(bin, kBinCount - 1) <= best_bin;
+          });
+      left_count = static_cast<uint32_t>(middle - ids);
+    } else {
+      left_count = task.count / 2;
+      std::nth_element(ids, ids + left_count, ids + task.count,
+                       [&](uint32_t a, uint32_t b) {
+                         return centroids[a * 3 + split_axis] <
+                                centroids[b * 3 + split_axis];
+                       });
+    }
+
+    const uint32_t left_child = static_cast<uint32_t>(m_nodes.size());
+    m_nodes[task.node].m_leftOrFirst = left_child;
+    m_nodes[task.node].m_triangleCount = 0;
+    m_nodes.push_back(bvhnode_t());
+    m_nodes.push_back(bvhnode_t());
+
+    tasks.push_back({left_child, task.first, left_count, task.depth + 1});
+    tasks.push_back({left_child + 1, task.first + left_count,
+                     task.count - left_count, task.depth + 1});
+  }
+  m_nodes.shrink_to_fit();
+
+  m_indices.resize(static_cast<size_t>(triangle_count) * 3);
+  for (uint32_t i = 0; i < triangle_count; ++i) {
+    const uint32_t *source = indices + m_triangleIds[i] * 3;
+    std::copy(source, source + 3, &m_indices[i * 3]);
+  }
+  return true;
+}
+
+void CTriangleBVH::Clear() {
+  m_nodes.clear();
+  m_vertices.clear();
+  m_indices.clear();
+  m_triangleIds.clear();
+}
+
+size_t CTriangleBVH::GetMemoryUsage() const {
+  return sizeof(*this) + m_nodes.capacity() * sizeof(bvhnode_t) +
+         m_vertices.capacity() * sizeof(float) +
+         m_indices.capacity() * sizeof(uint32_t) +
+         m_triangleIds.capacity() * sizeof(uint32_t);
+}
+
+template <bool kAnyHit>
+bool CTriangleBVH::Traverse(const ray_t &ray, rayhit_t &hit) const {
+  if (m_nodes.empty()) {
+    return false;
+  }
+
+  const vertex_t *vertices = reinterpret_cast<const vertex_t *>(&m_vertices[0]);
+  const float inverse_direction[3] = {1.f / ray.m_direction[0],
+                                      1.f / ray.m_direction[1],
+                                      1.f / ray.m_direction[2]};
+
+  const bvhnode_t *root = &m_nodes[0];
+  if (IntersectNode(root->m_minPt, root->m_maxPt, ray.m_origin,
+                    inverse_direction, hit.m_distance) == FLT_MAX) {
+    return false;
+  }
+
+  uint32_t stack[kTraversalStackSize];
+  uint32_t stack_size = 0;
+  uint32_t node_index = 0;
+  bool updated = false;
+  for (;;) {
+    const bvhnode_t &node = m_nodes[node_index];
+    if (node.m_triangleCount) {
+      rayhit_t leaf_hit = hit;
+      const uint32_t *indices = &m_indices[node.m_leftOrFirst * 3];
+      if (RayIntersectTriangles(ray, vertices, indices, node.m_triangleCount,
+                                leaf_hit)) {
+        hit = leaf_hit;
+        hit.m_index = m_triangleIds[node.m_leftOrFirst + leaf_hit.m_index];
+        updated = true;
+        if (kAnyHit) {
+          return true;
+        }
+      }
+    } else {
+      // Visit the nearer child first so that the closest hit shrinks the
+      // search range as early as possible.
+      uint32_t near_child = node.m_leftOrFirst;
+      uint32_t far_child = node.m_leftOrFirst + 1;
+      float near_t = IntersectNode(
+          m_nodes[near_child].m_minPt, m_nodes[near_child].m_maxPt,
+          ray.m_origin, inverse_direction, hit.m_distance);
+      float far_t = IntersectNode(
+          m_nodes[far_child].m_minPt, m_nodes[far_child].m_maxPt, ray.m_origin,
+          inverse_direction, hit.m_distance);
+      if (far_t < near_t) {
+        std::swap(near_t, far_t);
+        std::swap(near_child, far_child);
+      }
+
+      if (near_t != FLT_MAX) {
+        if (far_t != FLT_MAX) {
+          stack[stack_size++] = far_child;
+        }
+        node_index = near_child;
+        continue;
+      }
+    }
+
+    // Pop the next node that may still contain a closer hit.
+    bool found = false;
+    while (stack_size) {
+      node_index = stack[--stack_size];
+      const bvhnode_t &candidate = m_nodes[node_index];
+      if (IntersectNode(candidate.m_minPt, candidate.m_maxPt, ray.m_origin,
+                        inverse_direction, hit.m_distance) != FLT_MAX) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return updated;
+    }
+  }
+}
+
+bool CTriangleBVH::IntersectRay(const ray_t &ray, rayhit_t &hit) const {
+  return Traverse<false>(ray, hit);
+}
+
+bool CTriangleBVH::IntersectRayAny(const ray_t &ray, float max_distance) const {
+  rayhit_t hit;
+  RayHitReset(hit, max_distance);
+  return Traverse<true>(ray, hit);
+}
+
+}  // namespace XboxMath
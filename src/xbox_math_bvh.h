@@ -0,0 +1,66 @@
+#ifndef XBOX_MATH_BVH_H_
+#define XBOX_MATH_BVH_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "xbox_math_ray.h"
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! A static bounding volume hierarchy over an indexed triangle mesh, built with
+//! binned surface area heuristic splits and stored as a flat node array.
+class CTriangleBVH {
+ public:
+  //! Builds the hierarchy over `triangle_count` triangles whose vertex indices
+  //! are stored consecutively in `indices`. The vertices are copied.
+  //! \return false if the mesh is empty or an index is out of range.
+  bool Build(const vertex_t *vertices, uint32_t vertex_count,
+             const uint32_t *indices, uint32_t triangle_count);
+
+  void Clear();
+
+  [[nodiscard]] uint32_t GetNodeCount() const {
+    return static_cast<uint32_t>(m_nodes.size());
+  }
+
+  [[nodiscard]] uint32_t GetTriangleCount() const {
+    return static_cast<uint32_t>(m_triangleIds.size());
+  }
+
+  //! Returns the number of bytes used by the hierarchy and its mesh copy.
+  [[nodiscard]] size_t GetMemoryUsage() const;
+
+  //! Finds the closest triangle hit by `ray` nearer than `hit.m_distance`.
+  //! `hit.m_index` is set to the triangle's index in the mesh passed to Build.
+  //! \return true if `hit` was updated.
+  bool IntersectRay(const ray_t &ray, rayhit_t &hit) const;
+
+  //! \return true if `ray` hits any triangle nearer than `max_distance`,
+  //! without searching for the closest one (e.g., for line of sight checks).
+  [[nodiscard]] bool IntersectRayAny(const ray_t &ray,
+                                     float max_distance) const;
+
+ private:
+  typedef struct bvhnode_t {
+    float m_minPt[3];
+    uint32_t m_leftOrFirst;  // First child for interior nodes (the second
+                             // follows it), first triangle for leaves.
+    float m_maxPt[3];
+    uint32_t m_triangleCount;  // 0 for interior nodes.
+  } bvhnode_t;
+
+  template <bool kAnyHit>
+  bool Traverse(const ray_t &ray, rayhit_t &hit) const;
+
+  std::vector<bvhnode_t> m_nodes;
+  std::vector<float> m_vertices;    // 4 floats per vertex.
+  std::vector<uint32_t> m_indices;  // Reordered to match the leaves.
+  // Index in the source mesh of each reordered triangle.
+  std::vector<uint32_t> m_triangleIds;
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_BVH_H_
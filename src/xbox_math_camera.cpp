@@ -0,0 +1,175 @@
+#include "xbox_math_camera.h"
+
+#include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_util.h"
+#include "xbox_math_vector.h"
+
+#define RAD2DEG(c) ((float)(c) * 180.0f / (float)M_PI)
+
+namespace XboxMath {
+
+static constexpr uint32_t kDirtyAll = 0xFFFFFFFF;
+
+CCamera::CCamera()
+    : m_fovY(static_cast<float>(M_PI) * 0.25f),
+      m_aspect(640.f / 480.f),
+      m_zNear(1.f),
+      m_zFar(1000.f),
+      m_viewportWidth(640.f),
+      m_viewportHeight(480.f),
+      m_maxDepthbufferValue(static_cast<float>(0xFFFF)),
+      m_viewportZMin(0.f),
+      m_viewportZMax(1.f),
+      m_dirty(kDirtyAll) {
+  VectorSetVector(m_eye, 0.f, 0.f, 0.f);
+  VectorSetVector(m_at, 0.f, 0.f, 1.f);
+  VectorSetVector(m_up, 0.f, 1.f, 0.f);
+}
+
+void CCamera::MarkViewDirty() {
+  m_dirty |= kDirtyView | kDirtyComposite | kDirtyInverseComposite |
+             kDirtyFrustum;
+}
+
+void CCamera::MarkProjectionDirty() {
+  m_dirty |= kDirtyProjection | kDirtyComposite | kDirtyInverseComposite |
+             kDirtyFrustum;
+}
+
+void CCamera::SetLookAt(const vector_t &eye, const vector_t &at,
+                        const vector_t &up) {
+  VectorCopyVector(m_eye, eye);
+  VectorCopyVector(m_at, at);
+  VectorCopyVector(m_up, up);
+  MarkViewDirty();
+}
+
+void CCamera::SetEye(const vector_t &eye) {
+  VectorCopyVector(m_eye, eye);
+  MarkViewDirty();
+}
+
+void CCamera::SetAt(const vector_t &at) {
+  VectorCopyVector(m_at, at);
+  MarkViewDirty();
+}
+
+void CCamera::SetUp(const vector_t &up) {
+  VectorCopyVector(m_up, up);
+  MarkViewDirty();
+}
+
+void CCamera::SetPerspective(float fov_y, float aspect, float z_near,
+                             float z_far) {
+  m_fovY = fov_y;
+  m_aspect = aspect;
+  m_zNear = z_near;
+  m_zFar = z_far;
+  MarkProjectionDirty();
+}
+
+void CCamera::SetViewport(float width, float height,
+                          float max_depthbuffer_value, float z_min,
+                          float z_max) {
+  m_viewportWidth = width;
+  m_viewportHeight = height;
+  m_maxDepthbufferValue = max_depthbuffer_value;
+  m_viewportZMin = z_min;
+  m_viewportZMax = z_max;
+  // The frustum is independent of the viewport.
+  m_dirty |= kDirtyViewport | kDirtyComposite | kDirtyInverseComposite;
+}
+
+const matrix4_t &CCamera::GetView() const {
+  if (m_dirty & kDirtyView) {
+    CreateD3DLookAtLH(m_view, m_eye, m_at, m_up);
+    m_dirty &= ~kDirtyView;
+  }
+  return m_view;
+}
+
+const matrix4_t &CCamera::GetProjection() const {
+  if (m_dirty & kDirtyProjection) {
+    CreateD3DPerspectiveFOVLH(m_projection, m_fovY, m_aspect, m_zNear, m_zFar);
+    m_dirty &= ~kDirtyProjection;
+  }
+  return m_projection;
+}
+
+const matrix4_t &CCamera::GetViewport() const {
+  if (m_dirty & kDirtyViewport) {
+    CreateD3DViewport(m_viewport, m_viewportWidth, m_viewportHeight,
+                      m_maxDepthbufferValue, m_viewportZMin, m_viewportZMax);
+    m_dirty &= ~kDirtyViewport;
+  }
+  return m_viewport;
+}
+
+const matrix4_t &CCamera::GetComposite() const {
+  if (m_dirty & kDirtyComposite) {
+    matrix4_t projection_viewport;
+    MatrixMultMatrix(GetProjection(), GetViewport(), projection_viewport);
+    BuildCompositeMatrix(GetView(), projection_viewport, m_composite);
+    m_dirty &= ~kDirtyComposite;
+  }
+  return m_composite;
+}
+
+const matrix4_t &CCamera::GetInverseComposite() const {
+  if (m_dirty & kDirtyInverseComposite) {
+    matrix4_t inverse_view;
+    CreateD3DLookAtLHInverse(inverse_view, m_eye, m_at, m_up);
+
+    matrix4_t inverse_projection;
+    CreateD3DPerspectiveFOVLHInverse(inverse_projection, m_fovY, m_aspect,
+                                     m_zNear, m_zFar);
+
+    matrix4_t inverse_viewport;
+    CreateD3DViewportInverse(inverse_viewport, m_viewportWidth,
+                             m_viewportHeight, m_maxDepthbufferValue,
+                             m_viewportZMin, m_viewportZMax);
+
+    matrix4_t inverse_projection_viewport;
+    MatrixMultMatrix(inverse_viewport, inverse_projection,
+                     inverse_projection_viewport);
+    BuildInverseCompositeMatrix(inverse_view, inverse_projection_viewport,
+                                m_inverseComposite);
+    m_dirty &= ~kDirtyInverseComposite;
+  }
+  return m_inverseComposite;
+}
+
+const frustum_t &CCamera::GetFrustum() const {
+  if (m_dirty & kDirtyFrustum) {
+    // frustum_t is built in a right handed camera space looking down -z.
+    // Rotating it 180 degrees about y yields the (symmetric) left handed
+    // camera space frustum without the reflection that would flip the plane
+    // normals, after which the inverse view moves it into world space.
+    m_frustum.CreateFrustumMatrixForPerspective(RAD2DEG(m_fovY), m_aspect,
+                                                m_zNear, m_zFar);
+
+    matrix4_t inverse_view;
+    CreateD3DLookAtLHInverse(inverse_view, m_eye, m_at, m_up);
+
+    matrix4_t camera_to_world;
+    MatrixSetIdentity(camera_to_world);
+    camera_to_world[0][0] = -1.f;
+    camera_to_world[2][2] = -1.f;
+    MatrixMultMatrix(camera_to_world, inverse_view);
+
+    m_frustum.ApplyMatrixToFrustum(camera_to_world);
+    m_dirty &= ~kDirtyFrustum;
+  }
+  return m_frustum;
+}
+
+void CCamera::Project(const vector_t &world_point, vector_t &result) const {
+  ProjectPoint(world_point, GetComposite(), result);
+}
+
+void CCamera::Unproject(const vector_t &screen_point, vector_t &result) const {
+  UnprojectPoint(screen_point, GetInverseComposite(), result);
+}
+
+}  // namespace XboxMath
@@ -0,0 +1,95 @@
+#ifndef XBOX_MATH_CAMERA_H_
+#define XBOX_MATH_CAMERA_H_
+
+#include "xbox_math_frustum.h"
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! A D3D-style (left handed) perspective camera that caches its view,
+//! projection, viewport and composite matrices as well as its world space
+//! frustum.
+//!
+//! Setters only mark the values that depend on the changed input as dirty;
+//! derived values are rebuilt lazily the next time they are queried.
+class CCamera {
+ public:
+  CCamera();
+
+  //! Sets the inputs to CreateD3DLookAtLH.
+  void SetLookAt(const vector_t &eye, const vector_t &at, const vector_t &up);
+  void SetEye(const vector_t &eye);
+  void SetAt(const vector_t &at);
+  void SetUp(const vector_t &up);
+
+  //! Sets the inputs to CreateD3DPerspectiveFOVLH. `fov_y` is in radians.
+  void SetPerspective(float fov_y, float aspect, float z_near, float z_far);
+
+  //! Sets the inputs to CreateD3DViewport.
+  void SetViewport(float width, float height, float max_depthbuffer_value,
+                   float z_min = 0.f, float z_max = 1.f);
+
+  [[nodiscard]] const vector_t &GetEye() const { return m_eye; }
+  [[nodiscard]] const vector_t &GetAt() const { return m_at; }
+  [[nodiscard]] const vector_t &GetUp() const { return m_up; }
+
+  [[nodiscard]] const matrix4_t &GetView() const;
+  [[nodiscard]] const matrix4_t &GetProjection() const;
+  [[nodiscard]] const matrix4_t &GetViewport() const;
+
+  //! Returns view * projection * viewport, suitable for ProjectPoint.
+  [[nodiscard]] const matrix4_t &GetComposite() const;
+
+  //! Returns the inverse of GetComposite(), suitable for UnprojectPoint. This
+  //! is only computed when requested.
+  [[nodiscard]] const matrix4_t &GetInverseComposite() const;
+
+  //! Returns the view frustum in world space.
+  [[nodiscard]] const frustum_t &GetFrustum() const;
+
+  //! Projects `world_point` into screen space.
+  void Project(const vector_t &world_point, vector_t &result) const;
+
+  //! Unprojects `screen_point` into world space.
+  void Unproject(const vector_t &screen_point, vector_t &result) const;
+
+ private:
+  enum DirtyFlags {
+    kDirtyView = 1 << 0,
+    kDirtyProjection = 1 << 1,
+    kDirtyViewport = 1 << 2,
+    kDirtyComposite = 1 << 3,
+    kDirtyInverseComposite = 1 << 4,
+    kDirtyFrustum = 1 << 5,
+  };
+
+  void MarkViewDirty();
+  void MarkProjectionDirty();
+
+  vector_t m_eye;
+  vector_t m_at;
+  vector_t m_up;
+
+  float m_fovY;
+  float m_aspect;
+  float m_zNear;
+  float m_zFar;
+
+  float m_viewportWidth;
+  float m_viewportHeight;
+  float m_maxDepthbufferValue;
+  float m_viewportZMin;
+  float m_viewportZMax;
+
+  mutable uint32_t m_dirty;
+  mutable matrix4_t m_view;
+  mutable matrix4_t m_projection;
+  mutable matrix4_t m_viewport;
+  mutable matrix4_t m_composite;
+  mutable matrix4_t m_inverseComposite;
+  mutable frustum_t m_frustum;
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_CAMERA_H_
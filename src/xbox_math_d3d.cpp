@@ -1,5 +1,7 @@
 #include "xbox_math_d3d.h"
 
+#include "xbox_math_depth.h"
+#include "xbox_math_fast_math.h"
 #include "xbox_math_matrix.h"
 #include "xbox_math_vector.h"
 
@@ -7,32 +9,83 @@ namespace XboxMath {
 
 void CreateWorldView(const vector_t &translation, const vector_t &rotation,
                      matrix4_t &ret) {
-  vector_t inv_translation = {-translation[0], -translation[1], -translation[2],
-                              translation[3]};
+  // Closed form of translate(-translation) * rotate_z(-rotation[2]) *
+  // rotate_y(-rotation[1]) * rotate_x(-rotation[0]), as built by
+  // MatrixTranslate followed by MatrixRotate.
+  float sx, sy, sz, cx, cy, cz;
+#ifdef XBOX_MATH_FAST_TRIG
+  // One 4-wide approximation for all three angles.
+  Simd::float4 sines, cosines;
+  TrigSinCos(Simd::Set(-rotation[0], -rotation[1], -rotation[2], 0.f), sines,
+             cosines);
+  float sin_values[4];
+  float cos_values[4];
+  Simd::StoreUnaligned(sin_values, sines);
+  Simd::StoreUnaligned(cos_values, cosines);
+  sx = sin_values[0];
+  sy = sin_values[1];
+  sz = sin_values[2];
+  cx = cos_values[0];
+  cy = cos_values[1];
+  cz = cos_values[2];
+#else
+  // libm has no 4-wide form, and the 4-wide TrigSinCos would also evaluate
+  // the unused fourth lane. Negating the sines rather than the angles lets
+  // the compiler merge each sinf and cosf pair into one sincosf call.
+  TrigSinCos(rotation[0], sx, cx);
+  TrigSinCos(rotation[1], sy, cy);
+  TrigSinCos(rotation[2], sz, cz);
+  sx = -sx;
+  sy = -sy;
+  sz = -sz;
+#endif
+
+  ret[0][0] = cz * cy;
+  ret[0][1] = sz * cx + cz * sy * sx;
+  ret[0][2] = sz * sx - cz * sy * cx;
+  ret[0][3] = 0.f;
 
-  vector_t inv_rotation = {-rotation[0], -rotation[1], -rotation[2],
-                           rotation[3]};
+  ret[1][0] = -sz * cy;
+  ret[1][1] = cz * cx - sz * sy * sx;
+  ret[1][2] = cz * sx + sz * sy * cx;
+  ret[1][3] = 0.f;
 
-  MatrixSetIdentity(ret);
-  matrix4_t temp;
-  MatrixTranslate(ret, inv_translation, temp);
-  MatrixRotate(temp, inv_rotation, ret);
+  ret[2][0] = sy;
+  ret[2][1] = -cy * sx;
+  ret[2][2] = cy * cx;
+  ret[2][3] = 0.f;
+
+  const float tx = translation[0];
+  const float ty = translation[1];
+  const float tz = translation[2];
+  ret[3][0] = -(tx * ret[0][0] + ty * ret[1][0] + tz * ret[2][0]);
+  ret[3][1] = -(tx * ret[0][1] + ty * ret[1][1] + tz * ret[2][1]);
+  ret[3][2] = -(tx * ret[0][2] + ty * ret[1][2] + tz * ret[2][2]);
+  ret[3][3] = 1.f;
 }
 
-void CreateD3DLookAtLH(matrix4_t &ret, const vector_t &eye, const vector_t &at,
-                       const vector_t &up) {
-  // https://docs.microsoft.com/en-us/windows/win32/direct3d9/d3dxmatrix4_tlookatlh
-  vector_t z_axis = {0.f, 0.f, 0.f, 1.f};
+// Computes the camera space basis vectors used by CreateD3DLookAtLH.
+static void LookAtLHAxes(const vector_t &eye, const vector_t &at,
+                         const vector_t &up, vector_t &x_axis,
+                         vector_t &y_axis, vector_t &z_axis) {
+  VectorSetVector(z_axis, 0.f, 0.f, 0.f, 1.f);
   VectorSubtractVector(at, eye, z_axis);
   VectorNormalize(z_axis);
 
-  vector_t x_axis = {0.f, 0.f, 0.f, 1.f};
+  VectorSetVector(x_axis, 0.f, 0.f, 0.f, 1.f);
   VectorCrossVector(up, z_axis, x_axis);
   VectorNormalize(x_axis);
 
-  vector_t y_axis = {0.f, 0.f, 0.f, 1.f};
+  VectorSetVector(y_axis, 0.f, 0.f, 0.f, 1.f);
   VectorCrossVector(z_axis, x_axis, y_axis);
   VectorNormalize(y_axis);
+}
+
+void CreateD3DLookAtLH(matrix4_t &ret, const vector_t &eye, const vector_t &at,
+                       const vector_t &up) {
+  // https://docs.microsoft.com/en-us/windows/win32/direct3d9/d3dxmatrix4_tlookatlh
+  vector_t x_axis, y_axis, z_axis;
+  LookAtLHAxes(eye, at, up, x_axis, y_axis, z_axis);
 
   ret[0][0] = x_axis[0];
   ret[0][1] = y_axis[0];
@@ -55,9 +108,37 @@ void CreateD3DLookAtLH(matrix4_t &ret, const vector_t &eye, const vector_t &at,
   ret[3][3] = 1.f;
 }
 
+void CreateD3DLookAtLHInverse(matrix4_t &ret, const vector_t &eye,
+                              const vector_t &at, const vector_t &up) {
+  // The look-at matrix is a rotation followed by a translation, so its inverse
+  // is the transposed rotation with the eye as the translation.
+  vector_t x_axis, y_axis, z_axis;
+  LookAtLHAxes(eye, at, up, x_axis, y_axis, z_axis);
+
+  ret[0][0] = x_axis[0];
+  ret[0][1] = x_axis[1];
+  ret[0][2] = x_axis[2];
+  ret[0][3] = 0.f;
+
+  ret[1][0] = y_axis[0];
+  ret[1][1] = y_axis[1];
+  ret[1][2] = y_axis[2];
+  ret[1][3] = 0.f;
+
+  ret[2][0] = z_axis[0];
+  ret[2][1] = z_axis[1];
+  ret[2][2] = z_axis[2];
+  ret[2][3] = 0.f;
+
+  ret[3][0] = eye[0];
+  ret[3][1] = eye[1];
+  ret[3][2] = eye[2];
+  ret[3][3] = 1.f;
+}
+
 void CreateD3DPerspectiveFOVLH(matrix4_t &ret, float fov1, float aspect,
                                float z_near, float z_far) {
-  float y_scale = 1.0f / tanf(fov1 * 0.5f);
+  float y_scale = 1.0f / TrigTan(fov1 * 0.5f);
   float x_scale = y_scale / aspect;
 
   float z_adjustment = z_far / (z_far - z_near);
@@ -71,6 +152,23 @@ void CreateD3DPerspectiveFOVLH(matrix4_t &ret, float fov1, float aspect,
   ret[3][3] = 0.f;
 }
 
+void CreateD3DPerspectiveFOVLHInverse(matrix4_t &ret, float fov_y,
+                                      float aspect, float z_near, float z_far) {
+  const float tan_half_fov = TrigTan(fov_y * 0.5f);
+  const float z_adjustment = z_far / (z_far - z_near);
+
+  // (x, y, z, 1) * projection == (x * x_scale, y * y_scale,
+  // (z - z_near) * z_adjustment, z), so z is recovered from w and the original
+  // w from a combination of z and w.
+  MatrixSetIdentity(ret);
+  ret[0][0] = tan_half_fov * aspect;
+  ret[1][1] = tan_half_fov;
+  ret[2][2] = 0.f;
+  ret[2][3] = -1.f / (z_near * z_adjustment);
+  ret[3][2] = 1.f;
+  ret[3][3] = 1.f / z_near;
+}
+
 void CreateD3DOrthographicLH(matrix4_t &ret, float left, float right, float top,
                              float bottom, float z_near, float z_far) {
   const float inv_depth = 1.f / (z_near - z_far);
@@ -95,6 +193,18 @@ void CreateD3DOrthographicLH(matrix4_t &ret, float left, float right, float top,
   ret[3][3] = 1.f;
 }
 
+void CreateD3DOrthographicLHInverse(matrix4_t &ret, float left, float right,
+                                    float top, float bottom, float z_near,
+                                    float z_far) {
+  MatrixSetIdentity(ret);
+  ret[0][0] = (right - left) * 0.5f;
+  ret[1][1] = (top - bottom) * 0.5f;
+  ret[2][2] = z_far - z_near;
+  ret[3][0] = (left + right) * 0.5f;
+  ret[3][1] = (top + bottom) * 0.5f;
+  ret[3][2] = z_near;
+}
+
 void CreateD3DViewport(matrix4_t &ret, float width, float height,
                        float max_depthbuffer_value, float z_min, float z_max) {
   MatrixSetIdentity(ret);
@@ -107,26 +217,39 @@ void CreateD3DViewport(matrix4_t &ret, float width, float height,
   ret[3][2] = max_depthbuffer_value * z_min;
 }
 
+void CreateD3DViewportInverse(matrix4_t &ret, float width, float height,
+                              float max_depthbuffer_value, float z_min,
+                              float z_max) {
+  MatrixSetIdentity(ret);
+
+  ret[0][0] = 2.f / width;
+  ret[1][1] = -2.f / height;
+  ret[2][2] = 1.f / (max_depthbuffer_value * (z_max - z_min));
+  ret[3][0] = -1.f;
+  ret[3][1] = 1.f;
+  ret[3][2] = -1.f * z_min / (z_max - z_min);
+}
+
 void CreateD3DStandardViewport16Bit(matrix4_t &ret, float width, float height) {
-  CreateD3DViewport(ret, width, height, (float)0xFFFF, 0.0f, 1.0f);
+  CreateD3DViewport(ret, width, height, DepthBufferMaxValue(kDepthBuffer16Bit),
+                    0.0f, 1.0f);
 }
 
 void CreateD3DStandardViewport16BitFloat(matrix4_t &ret, float width,
                                          float height) {
-  const uint32_t max_value_int = 0x43FFF800;
-  float max_value = *(float *)&max_value_int;
-  CreateD3DViewport(ret, width, height, (float)max_value, 0.0f, 1.0f);
+  CreateD3DViewport(ret, width, height,
+                    DepthBufferMaxValue(kDepthBuffer16BitFloat), 0.0f, 1.0f);
 }
 
 void CreateD3DStandardViewport24Bit(matrix4_t &ret, float width, float height) {
-  CreateD3DViewport(ret, width, height, (float)0x00FFFFFF, 0.0f, 1.0f);
+  CreateD3DViewport(ret, width, height, DepthBufferMaxValue(kDepthBuffer24Bit),
+                    0.0f, 1.0f);
 }
 
 void CreateD3DStandardViewport24BitFloat(matrix4_t &ret, float width,
                                          float height) {
-  const uint32_t max_value_int = 0x7149F2CA;
-  float max_value = *(float *)&max_value_int;
-  CreateD3DViewport(ret, width, height, max_value, 0.0f, 1.0f);
+  CreateD3DViewport(ret, width, height,
+                    DepthBufferMaxValue(kDepthBuffer24BitFloat), 0.0f, 1.0f);
 }
 
 }  // namespace XboxMath
@@ -11,15 +11,37 @@ void CreateWorldView(const vector_t &translation, const vector_t &rotation,
 void CreateD3DLookAtLH(matrix4_t &ret, const vector_t &eye, const vector_t &at,
                        const vector_t &up);
 
+//! Creates the inverse of the matrix built by CreateD3DLookAtLH directly from
+//! the same parameters.
+void CreateD3DLookAtLHInverse(matrix4_t &ret, const vector_t &eye,
+                              const vector_t &at, const vector_t &up);
+
 void CreateD3DPerspectiveFOVLH(matrix4_t &ret, float fov_y, float aspect,
                                float z_near, float z_far);
 
+//! Creates the inverse of the matrix built by CreateD3DPerspectiveFOVLH
+//! directly from the same parameters.
+void CreateD3DPerspectiveFOVLHInverse(matrix4_t &ret, float fov_y,
+                                      float aspect, float z_near, float z_far);
+
 void CreateD3DOrthographicLH(matrix4_t &ret, float left, float right, float top,
                              float bottom, float z_near, float z_far);
 
+//! Creates the inverse of the matrix built by CreateD3DOrthographicLH directly
+//! from the same parameters.
+void CreateD3DOrthographicLHInverse(matrix4_t &ret, float left, float right,
+                                    float top, float bottom, float z_near,
+                                    float z_far);
+
 void CreateD3DViewport(matrix4_t &ret, float width, float height,
                        float max_depthbuffer_value, float z_min, float z_max);
 
+//! Creates the inverse of the matrix built by CreateD3DViewport directly from
+//! the same parameters.
+void CreateD3DViewportInverse(matrix4_t &ret, float width, float height,
+                              float max_depthbuffer_value, float z_min,
+                              float z_max);
+
 void CreateD3DStandardViewport16Bit(matrix4_t &ret, float width, float height);
 
 void CreateD3DStandardViewport16BitFloat(matrix4_t &ret, float width,
@@ -0,0 +1,328 @@
+#include "xbox_math_depth.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstring>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+static constexpr uint32_t k16BitFloatMaxBits = 0x43FFF800;
+static constexpr uint32_t k24BitFloatMaxBits = 0x7149F2CA;
+
+// 16-bit float depth values are converted to IEEE floats by rebiasing the
+// exponent from 7 to 127. Values with a zero exponent are denormals.
+static constexpr uint32_t k16BitFloatExponentRebias = 120 << 23;
+static constexpr uint32_t k16BitFloatMantissaShift = 23 - 12;
+static constexpr float k16BitFloatMinNormal = 0.015625f;  // 2^-6
+// Scales a 16-bit float denormal to its raw value, 2^18 in two steps.
+static constexpr float k16BitFloatDenormalScale = 512.f;  // 2^9
+
+// 24-bit float depth values share the IEEE exponent bias.
+static constexpr uint32_t k24BitFloatMantissaShift = 23 - 16;
+static constexpr float k24BitFloatMinNormal = FLT_MIN;  // 2^-126
+// Scales a 24-bit float denormal to its raw value, 2^142 in two steps.
+static constexpr float k24BitFloatDenormalScale =
+    2361183241434822606848.f;  // 2^71
+// The 24-bit float maximum is not representable in the format itself, so
+// encoding clamps to the largest value below it.
+static constexpr uint32_t k24BitFloatMaxRaw =
+    k24BitFloatMaxBits >> k24BitFloatMantissaShift;
+
+// The stencil value occupies the lower 8 bits of 24-bit depth buffers.
+static constexpr uint32_t k24BitDepthShift = 8;
+
+static inline float FloatFromBits(uint32_t bits) {
+  float ret;
+  memcpy(&ret, &bits, sizeof(ret));
+  return ret;
+}
+
+float DepthBufferMaxValue(DepthBufferFormat format) {
+  switch (format) {
+    case kDepthBuffer16Bit:
+      return static_cast<float>(0xFFFF);
+    case kDepthBuffer16BitFloat:
+      return FloatFromBits(k16BitFloatMaxBits);
+    case kDepthBuffer24Bit:
+      return static_cast<float>(0x00FFFFFF);
+    case kDepthBuffer24BitFloat:
+      return FloatFromBits(k24BitFloatMaxBits);
+  }
+  return 0.f;
+}
+
+template <DepthBufferFormat kFormat>
+static constexpr bool Is16BitFormat() {
+  return kFormat == kDepthBuffer16Bit || kFormat == kDepthBuffer16BitFloat;
+}
+
+template <DepthBufferFormat kFormat>
+static constexpr bool IsFixedPointFormat() {
+  return kFormat == kDepthBuffer16Bit || kFormat == kDepthBuffer24Bit;
+}
+
+// Reads `count` (at most 4) raw depth values starting at pixel `first` of
+// `pixels`. Unused lanes repeat the last value.
+template <DepthBufferFormat kFormat>
+static inline void LoadRawDepth(const uint8_t *pixels, uint32_t first,
+                                uint32_t count, uint32_t (&ret)[4]) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    const uint32_t pixel = first + (i < count ? i : count - 1);
+    if (Is16BitFormat<kFormat>()) {
+      uint16_t value;
+      memcpy(&value, pixels + pixel * sizeof(uint16_t), sizeof(value));
+      ret[i] = value;
+    } else {
+      uint32_t value;
+      memcpy(&value, pixels + pixel * sizeof(uint32_t), sizeof(value));
+      ret[i] = value >> k24BitDepthShift;
+    }
+  }
+}
+
+// Writes the first `count` raw depth values of `raw` starting at pixel `first`
+// of `pixels`.
+template <DepthBufferFormat kFormat>
+static inline void StoreRawDepth(const uint32_t (&raw)[4], uint32_t count,
+                                 uint8_t *pixels, uint32_t first) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if (Is16BitFormat<kFormat>()) {
+      const auto value = static_cast<uint16_t>(raw[i]);
+      memcpy(pixels + (first + i) * sizeof(uint16_t), &value, sizeof(value));
+    } else {
+      const uint32_t value = raw[i] << k24BitDepthShift;
+      memcpy(pixels + (first + i) * sizeof(uint32_t), &value, sizeof(value));
+    }
+  }
+}
+
+// Converts four raw depth values into screen space depth values.
+template <DepthBufferFormat kFormat>
+static inline Simd::float4 DecodeDepth(const uint32_t (&raw)[4]) {
+  using namespace Simd;
+  if (IsFixedPointFormat<kFormat>()) {
+    return Set(static_cast<float>(raw[0]), static_cast<float>(raw[1]),
+               static_cast<float>(raw[2]), static_cast<float>(raw[3]));
+  }
+
+  uint32_t bits[4];
+  for (uint32_t i = 0; i < 4; ++i) {
+    if (kFormat == kDepthBuffer16BitFloat) {
+      bits[i] =
+          (raw[i] << k16BitFloatMantissaShift) + k16BitFloatExponentRebias;
+    } else {
+      bits[i] = raw[i] << k24BitFloatMantissaShift;
+    }
+  }
+  float values[4];
+  memcpy(values, bits, sizeof(values));
+  const float4 value = LoadUnaligned(values);
+  if (kFormat == kDepthBuffer24BitFloat) {
+    return value;
+  }
+
+  // Rebiasing a denormal yields 2^-7 * (1 + m / 4096) instead of
+  // 2^-6 * (m / 4096), i.e. (value - 2^-7) * 2.
+  const float4 min_normal = Set1(k16BitFloatMinNormal);
+  const float4 denormal = Sub(Add(value, value), min_normal);
+  return Select(CmpLt(value, min_normal), denormal, value);
+}
+
+// Rounds non-negative lanes to the nearest integer (ties to even). Unlike
+// Simd::RoundNearest this covers the whole 24-bit fixed point range; lanes of
+// 2^23 and above are already integers.
+static inline Simd::float4 RoundNonNegative(Simd::float4 a) {
+  using namespace Simd;
+  const float4 magic = Set1(8388608.f);  // 2^23
+  return Select(CmpLt(a, magic), Sub(Add(a, magic), magic), a);
+}
+
+// Converts four screen space depth values into raw depth values, clamping
+// them to the format's range and rounding to the nearest representable value.
+//
+// Float formats are rounded to their 13 or 17 significant bits with a
+// Veltkamp split, so the raw value can be taken from the IEEE bits directly.
+// Denormals have a fixed spacing and are rounded like fixed point values.
+// SSE1 lacks integer lanes, so the final conversions are scalar.
+template <DepthBufferFormat kFormat>
+static inline void EncodeDepth(Simd::float4 depth, uint32_t (&ret)[4]) {
+  using namespace Simd;
+  constexpr bool is_16_bit_float = kFormat == kDepthBuffer16BitFloat;
+  const float4 clamped =
+      Min(Max(depth, Zero()), Set1(DepthBufferMaxValue(kFormat)));
+
+  float values[4];
+  if (IsFixedPointFormat<kFormat>()) {
+    StoreUnaligned(values, RoundNonNegative(clamped));
+    for (uint32_t i = 0; i < 4; ++i) {
+      ret[i] = static_cast<uint32_t>(values[i]);
+    }
+    return;
+  }
+
+  constexpr uint32_t mantissa_shift =
+      is_16_bit_float ? k16BitFloatMantissaShift : k24BitFloatMantissaShift;
+  const float4 split = Set1(static_cast<float>((1 << mantissa_shift) + 1));
+  const float4 scaled = Mul(clamped, split);
+  StoreUnaligned(values, Sub(scaled, Sub(scaled, clamped)));
+  uint32_t bits[4];
+  memcpy(bits, values, sizeof(bits));
+
+  const float4 min_normal =
+      Set1(is_16_bit_float ? k16BitFloatMinNormal : k24BitFloatMinNormal);
+  const float4 denormal_scale = Set1(
+      is_16_bit_float ? k16BitFloatDenormalScale : k24BitFloatDenormalScale);
+  const int denormal_mask = MoveMask(CmpLt(clamped, min_normal));
+  const float4 denormal_raw = Mul(Mul(clamped, denormal_scale), denormal_scale);
+  float denormals[4];
+  StoreUnaligned(denormals, RoundNonNegative(denormal_raw));
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    if (denormal_mask & (1 << i)) {
+      ret[i] = static_cast<uint32_t>(denormals[i]);
+    } else if (is_16_bit_float) {
+      ret[i] = (bits[i] - k16BitFloatExponentRebias) >> mantissa_shift;
+    } else {
+      ret[i] = std::min(bits[i] >> mantissa_shift, k24BitFloatMaxRaw);
+    }
+  }
+}
+
+template <DepthBufferFormat kFormat>
+static void DepthBufferToWorldPositions(const void *depth_buffer,
+                                        uint32_t pitch, uint32_t width,
+                                        uint32_t height,
+                                        const matrix4_t &inverse_composite,
+                                        vector_t *positions) {
+  using namespace Simd;
+  const float4 lane_offsets = Set(0.f, 1.f, 2.f, 3.f);
+
+  float4 x_row[4], z_row[4], step[4];
+  for (uint32_t c = 0; c < 4; ++c) {
+    x_row[c] = Set1(inverse_composite[0][c]);
+    z_row[c] = Set1(inverse_composite[2][c]);
+    step[c] = Set1(4.f * inverse_composite[0][c]);
+  }
+
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t *row = static_cast<const uint8_t *>(depth_buffer) +
+                         static_cast<size_t>(y) * pitch;
+    vector_t *row_positions = positions + static_cast<size_t>(y) * width;
+
+    // The x, y and translation terms of the unprojection, stepped four pixels
+    // at a time along the scanline.
+    float4 partial[4];
+    for (uint32_t c = 0; c < 4; ++c) {
+      const float row_start = static_cast<float>(y) * inverse_composite[1][c] +
+                              inverse_composite[3][c];
+      partial[c] = MulAdd(lane_offsets, x_row[c], Set1(row_start));
+    }
+
+    for (uint32_t x = 0; x < width; x += 4) {
+      const uint32_t count = width - x < 4 ? width - x : 4;
+      uint32_t raw[4];
+      LoadRawDepth<kFormat>(row, x, count, raw);
+      const float4 depth = DecodeDepth<kFormat>(raw);
+
+      const float4 inv_w = Div(Set1(1.f), MulAdd(depth, z_row[3], partial[3]));
+      float4 px = Mul(MulAdd(depth, z_row[0], partial[0]), inv_w);
+      float4 py = Mul(MulAdd(depth, z_row[1], partial[1]), inv_w);
+      float4 pz = Mul(MulAdd(depth, z_row[2], partial[2]), inv_w);
+      float4 pw = Set1(1.f);
+      Transpose(px, py, pz, pw);
+
+      const float4 results[4] = {px, py, pz, pw};
+      for (uint32_t i = 0; i < count; ++i) {
+        StoreUnaligned(row_positions[x + i], results[i]);
+      }
+
+      for (uint32_t c = 0; c < 4; ++c) {
+        partial[c] = Add(partial[c], step[c]);
+      }
+    }
+  }
+}
+
+template <DepthBufferFormat kFormat>
+static void EncodeDepthValues(const float *screen_z, uint32_t count,
+                              void *ret) {
+  using namespace Simd;
+  auto *pixels = static_cast<uint8_t *>(ret);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    uint32_t raw[4];
+    EncodeDepth<kFormat>(LoadUnaligned(screen_z + i), raw);
+    StoreRawDepth<kFormat>(raw, 4, pixels, i);
+  }
+  if (i < count) {
+    float tail[4] = {0.f, 0.f, 0.f, 0.f};
+    memcpy(tail, screen_z + i, (count - i) * sizeof(float));
+    uint32_t raw[4];
+    EncodeDepth<kFormat>(LoadUnaligned(tail), raw);
+    StoreRawDepth<kFormat>(raw, count - i, pixels, i);
+  }
+}
+
+template <DepthBufferFormat kFormat>
+static void DecodeDepthValues(const void *depth_values, uint32_t count,
+                              float *ret) {
+  using namespace Simd;
+  const auto *pixels = static_cast<const uint8_t *>(depth_values);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    uint32_t raw[4];
+    LoadRawDepth<kFormat>(pixels, i, 4, raw);
+    StoreUnaligned(ret + i, DecodeDepth<kFormat>(raw));
+  }
+  if (i < count) {
+    uint32_t raw[4];
+    LoadRawDepth<kFormat>(pixels, i, count - i, raw);
+    float tail[4];
+    StoreUnaligned(tail, DecodeDepth<kFormat>(raw));
+    memcpy(ret + i, tail, (count - i) * sizeof(float));
+  }
+}
+
+// Instantiates `function` for `format` and calls it with the remaining
+// arguments.
+#define DISPATCH_DEPTH_FORMAT(format, function, ...)      \
+  switch (format) {                                      \
+    case kDepthBuffer16Bit:                              \
+      function<kDepthBuffer16Bit>(__VA_ARGS__);          \
+      break;                                             \
+    case kDepthBuffer16BitFloat:                         \
+      function<kDepthBuffer16BitFloat>(__VA_ARGS__);     \
+      break;                                             \
+    case kDepthBuffer24Bit:                              \
+      function<kDepthBuffer24Bit>(__VA_ARGS__);          \
+      break;                                             \
+    case kDepthBuffer24BitFloat:                         \
+      function<kDepthBuffer24BitFloat>(__VA_ARGS__);     \
+      break;                                             \
+  }
+
+void DepthBufferToWorldPositions(const void *depth_buffer, uint32_t pitch,
+                                 DepthBufferFormat format, uint32_t width,
+                                 uint32_t height,
+                                 const matrix4_t &inverse_composite,
+                                 vector_t *positions) {
+  DISPATCH_DEPTH_FORMAT(format, DepthBufferToWorldPositions, depth_buffer,
+                        pitch, width, height, inverse_composite, positions);
+}
+
+void EncodeDepthValues(DepthBufferFormat format, const float *screen_z,
+                       uint32_t count, void *ret) {
+  DISPATCH_DEPTH_FORMAT(format, EncodeDepthValues, screen_z, count, ret);
+}
+
+void DecodeDepthValues(DepthBufferFormat format, const void *depth_values,
+                       uint32_t count, float *ret) {
+  DISPATCH_DEPTH_FORMAT(format, DecodeDepthValues, depth_values, count, ret);
+}
+
+#undef DISPATCH_DEPTH_FORMAT
+
+}  // namespace XboxMath
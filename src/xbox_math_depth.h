@@ -0,0 +1,56 @@
+#ifndef XBOX_MATH_DEPTH_H_
+#define XBOX_MATH_DEPTH_H_
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! The depth buffer formats set up by the CreateD3DStandardViewport*
+//! functions.
+//!
+//! 16-bit formats are stored in one uint16_t per pixel. 24-bit formats are
+//! stored in one uint32_t per pixel with the depth in the upper 24 bits and the
+//! stencil value in the lower 8 bits (D24S8).
+enum DepthBufferFormat {
+  kDepthBuffer16Bit,
+  kDepthBuffer16BitFloat,  // 4-bit exponent, 12-bit mantissa, no sign.
+  kDepthBuffer24Bit,
+  kDepthBuffer24BitFloat,  // 8-bit exponent, 16-bit mantissa, no sign.
+};
+
+//! Returns the max_depthbuffer_value passed to CreateD3DViewport by the
+//! standard viewport for `format`.
+float DepthBufferMaxValue(DepthBufferFormat format);
+
+//! Converts `count` screen space depth values (e.g., the z components produced
+//! by ProjectPoint) into depth buffer values of `format`, stored with the
+//! layout described above. 24-bit values are written with a zero stencil
+//! value.
+//!
+//! Values are clamped to [0, DepthBufferMaxValue(format)] and rounded to the
+//! nearest representable value (ties to even). The 24-bit float maximum is not
+//! representable, so it clamps to the largest value below it.
+void EncodeDepthValues(DepthBufferFormat format, const float *screen_z,
+                       uint32_t count, void *ret);
+
+//! Converts `count` depth buffer values of `format` back into screen space
+//! depth values. Decoding an encoded value yields it exactly.
+void DecodeDepthValues(DepthBufferFormat format, const void *depth_values,
+                       uint32_t count, float *ret);
+
+//! Reconstructs the world space position of every pixel of a `width` x
+//! `height` depth buffer whose rows are `pitch` bytes apart.
+//!
+//! `inverse_composite` is the inverse of the view * projection * viewport
+//! matrix that rendered the depth buffer. Pixel (x, y) is unprojected from the
+//! screen point (x, y, depth), matching UnprojectPoint. `positions` receives
+//! width * height positions in row-major order.
+void DepthBufferToWorldPositions(const void *depth_buffer, uint32_t pitch,
+                                 DepthBufferFormat format, uint32_t width,
+                                 uint32_t height,
+                                 const matrix4_t &inverse_composite,
+                                 vector_t *positions);
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_DEPTH_H_
@@ -0,0 +1,111 @@
+#include "xbox_math_distance.h"
+
+#include <cstddef>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+namespace {
+
+using Simd::float4;
+
+// Calls `output(i, j, lanes, distances_squared)` for each point a[i] and each
+// group of `lanes` (up to four) points starting at b[j]. Each group of b is
+// transposed once and reused for every point of a.
+template <typename Output>
+void ForEachDistanceSquared(const vertex_t *a, uint32_t a_count,
+                            const vertex_t *b, uint32_t b_count,
+                            Output output) {
+  using namespace Simd;
+  for (uint32_t j = 0; j < b_count; j += 4) {
+    const uint32_t lanes = b_count - j < 4 ? b_count - j : 4;
+    float4 rows[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      rows[lane] = LoadUnaligned(b[j + (lane < lanes ? lane : lanes - 1)]);
+    }
+    Transpose(rows[0], rows[1], rows[2], rows[3]);
+
+    for (uint32_t i = 0; i < a_count; ++i) {
+      const float4 x = Sub(rows[0], Set1(a[i][0]));
+      const float4 y = Sub(rows[1], Set1(a[i][1]));
+      const float4 z = Sub(rows[2], Set1(a[i][2]));
+      output(i, j, lanes, MulAdd(x, x, MulAdd(y, y, Mul(z, z))));
+    }
+  }
+}
+
+// Stores the first `lanes` values of `values` at `ret`.
+inline void StoreLanes(float *ret, uint32_t lanes, float4 values) {
+  if (lanes == 4) {
+    Simd::StoreUnaligned(ret, values);
+    return;
+  }
+  float buffer[4];
+  Simd::StoreUnaligned(buffer, values);
+  for (uint32_t lane = 0; lane < lanes; ++lane) {
+    ret[lane] = buffer[lane];
+  }
+}
+
+}  // namespace
+
+void PointDistancesSquaredPoints(const vertex_t &point, const vertex_t *points,
+                                 uint32_t count, float *ret) {
+  PointDistancesSquaredPoints(&point, 1, points, count, ret);
+}
+
+void PointDistancesSquaredPoints(const vertex_t *a, uint32_t a_count,
+                                 const vertex_t *b, uint32_t b_count,
+                                 float *ret) {
+  ForEachDistanceSquared(
+      a, a_count, b, b_count,
+      [&](uint32_t i, uint32_t j, uint32_t lanes, float4 distances_squared) {
+        StoreLanes(ret + static_cast<size_t>(i) * b_count + j, lanes,
+                   distances_squared);
+      });
+}
+
+void PointDistancesPoints(const vertex_t &point, const vertex_t *points,
+                          uint32_t count, float *ret) {
+  PointDistancesPoints(&point, 1, points, count, ret);
+}
+
+void PointDistancesPoints(const vertex_t *a, uint32_t a_count,
+                          const vertex_t *b, uint32_t b_count, float *ret) {
+  ForEachDistanceSquared(
+      a, a_count, b, b_count,
+      [&](uint32_t i, uint32_t j, uint32_t lanes, float4 distances_squared) {
+        StoreLanes(ret + static_cast<size_t>(i) * b_count + j, lanes,
+                   Simd::Sqrt(distances_squared));
+      });
+}
+
+uint32_t PointsWithinRadius(const vertex_t &point, const vertex_t *points,
+                            uint32_t count, float radius, uint32_t *mask) {
+  return PointsWithinRadius(&point, 1, points, count, radius, mask);
+}
+
+uint32_t PointsWithinRadius(const vertex_t *a, uint32_t a_count,
+                            const vertex_t *b, uint32_t b_count, float radius,
+                            uint32_t *mask) {
+  const uint32_t words = PointsWithinRadiusMaskWords(b_count);
+  for (size_t i = 0; i < static_cast<size_t>(a_count) * words; ++i) {
+    mask[i] = 0;
+  }
+  const float4 radius_squared = Simd::Set1(radius * radius);
+  uint32_t ret = 0;
+  ForEachDistanceSquared(
+      a, a_count, b, b_count,
+      [&](uint32_t i, uint32_t j, uint32_t lanes, float4 distances_squared) {
+        const auto bits = static_cast<uint32_t>(
+            Simd::MoveMask(Simd::CmpLe(distances_squared, radius_squared)) &
+            ((1 << lanes) - 1));
+        // Groups start at multiples of 4, so never straddle a word.
+        mask[static_cast<size_t>(i) * words + j / 32] |= bits << (j % 32);
+        ret += (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + (bits >> 3);
+      });
+  return ret;
+}
+
+}  // namespace XboxMath
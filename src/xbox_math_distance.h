@@ -0,0 +1,49 @@
+#ifndef XBOX_MATH_DISTANCE_H_
+#define XBOX_MATH_DISTANCE_H_
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! Batch versions of PointDistancePoint and PointDistanceSquaredPoint, four
+//! points at a time. Only x, y and z are used.
+//!
+//! The one-to-many forms measure from `point` to each of `count` `points`. The
+//! many-to-many forms measure from each of `a` to each of `b`, writing a
+//! row-major `a_count` x `b_count` matrix: the result for a[i] and b[j] is
+//! `ret[i * b_count + j]`.
+
+void PointDistancesSquaredPoints(const vertex_t &point, const vertex_t *points,
+                                 uint32_t count, float *ret);
+void PointDistancesSquaredPoints(const vertex_t *a, uint32_t a_count,
+                                 const vertex_t *b, uint32_t b_count,
+                                 float *ret);
+
+void PointDistancesPoints(const vertex_t &point, const vertex_t *points,
+                          uint32_t count, float *ret);
+void PointDistancesPoints(const vertex_t *a, uint32_t a_count,
+                          const vertex_t *b, uint32_t b_count, float *ret);
+
+//! Returns the number of words PointsWithinRadius writes per row of `count`
+//! points.
+inline uint32_t PointsWithinRadiusMaskWords(uint32_t count) {
+  return (count + 31) / 32;
+}
+
+//! Sets bit j % 32 of `mask[j / 32]` if `points[j]` is no farther than
+//! `radius` from `point`, and clears it otherwise. Unused bits of the last
+//! word are cleared.
+//! \return the number of points within `radius`.
+uint32_t PointsWithinRadius(const vertex_t &point, const vertex_t *points,
+                            uint32_t count, float radius, uint32_t *mask);
+
+//! The many-to-many form writes one mask row of
+//! PointsWithinRadiusMaskWords(`b_count`) words per point of `a`.
+//! \return the number of pairs within `radius`.
+uint32_t PointsWithinRadius(const vertex_t *a, uint32_t a_count,
+                            const vertex_t *b, uint32_t b_count, float radius,
+                            uint32_t *mask);
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_DISTANCE_H_
@@ -0,0 +1,289 @@
+#ifndef XBOX_MATH_FAST_MATH_H_
+#define XBOX_MATH_FAST_MATH_H_
+
+// Internal polynomial approximations of transcendental functions, usable both
+// on scalars and on Simd::float4 values.
+//
+// Building with XBOX_MATH_FAST_TRIG routes the library's own trigonometry
+// (via the Trig* functions at the end of this file) through these
+// approximations instead of libm.
+
+#include "xbox_math_simd.h"
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+namespace FastMathConstants {
+static constexpr float kTwoOverPi = 0.636619772367581343f;
+// pi/2 split into three parts for Cody-Waite range reduction. The first two
+// parts have few enough significant bits that multiplying them by the
+// quadrant index is exact.
+static constexpr float kPiOver2Part1 = 1.5703125f;
+static constexpr float kPiOver2Part2 = 4.837512969970703125e-4f;
+static constexpr float kPiOver2Part3 = 7.54978995489188216e-8f;
+
+// Minimax coefficients for sin/cos over [-pi/4, pi/4] (from Cephes).
+static constexpr float kSin1 = -1.6666654611e-1f;
+static constexpr float kSin2 = 8.3321608736e-3f;
+static constexpr float kSin3 = -1.9515295891e-4f;
+static constexpr float kCos1 = 4.166664568298827e-2f;
+static constexpr float kCos2 = -1.388731625493765e-3f;
+static constexpr float kCos3 = 2.443315711809948e-5f;
+
+// Minimax coefficients for tan over [-pi/4, pi/4] (from Cephes).
+static constexpr float kTan1 = 3.33331568548e-1f;
+static constexpr float kTan2 = 1.33387994085e-1f;
+static constexpr float kTan3 = 5.34112807005e-2f;
+static constexpr float kTan4 = 2.44301354525e-2f;
+static constexpr float kTan5 = 3.11992232697e-3f;
+static constexpr float kTan6 = 9.38540185543e-3f;
+
+// Minimax coefficients for asin over [-0.5, 0.5] (from Cephes).
+static constexpr float kAsin1 = 1.6666752422e-1f;
+static constexpr float kAsin2 = 7.4953002686e-2f;
+static constexpr float kAsin3 = 4.5470025998e-2f;
+static constexpr float kAsin4 = 2.4181311049e-2f;
+static constexpr float kAsin5 = 4.2163199048e-2f;
+
+static constexpr float kPi = 3.14159265358979323846f;
+static constexpr float kPiOver2 = 1.57079632679489661923f;
+}  // namespace FastMathConstants
+
+//! Calculates the sine and cosine of `x` (in radians) with a single range
+//! reduction.
+//!
+//! The absolute error is below 1e-7 for |x| <= 8192; precision degrades
+//! gradually for larger arguments.
+inline void FastSinCos(float x, float &sin_ret, float &cos_ret) {
+  using namespace FastMathConstants;
+  const float scaled = x * kTwoOverPi;
+  const int quadrant_index =
+      static_cast<int>(scaled >= 0.f ? scaled + 0.5f : scaled - 0.5f);
+  const float j = static_cast<float>(quadrant_index);
+  const int quadrant = quadrant_index & 3;
+
+  float r = x - j * kPiOver2Part1;
+  r -= j * kPiOver2Part2;
+  r -= j * kPiOver2Part3;
+  const float r2 = r * r;
+
+  float s = r + r * r2 * (kSin1 + r2 * (kSin2 + r2 * kSin3));
+  float c = 1.f - 0.5f * r2 + r2 * r2 * (kCos1 + r2 * (kCos2 + r2 * kCos3));
+
+  if (quadrant & 1) {
+    float temp = s;
+    s = c;
+    c = temp;
+  }
+  sin_ret = (quadrant & 2) ? -s : s;
+  cos_ret = (quadrant == 1 || quadrant == 2) ? -c : c;
+}
+
+//! 4-wide version of FastSinCos with identical error bounds.
+inline void FastSinCos(Simd::float4 x, Simd::float4 &sin_ret,
+                       Simd::float4 &cos_ret) {
+  using namespace Simd;
+  using namespace FastMathConstants;
+  const float4 j = RoundNearest(Mul(x, Set1(kTwoOverPi)));
+
+  float4 r = Sub(x, Mul(j, Set1(kPiOver2Part1)));
+  r = Sub(r, Mul(j, Set1(kPiOver2Part2)));
+  r = Sub(r, Mul(j, Set1(kPiOver2Part3)));
+  const float4 r2 = Mul(r, r);
+
+  // j mod 4, computed in floating point as SSE1 has no integer vectors.
+  // floor(j / 4) == round(j / 4 - 0.375) for integral j.
+  const float4 j_div_4 = RoundNearest(Sub(Mul(j, Set1(0.25f)), Set1(0.375f)));
+  const float4 quadrant = Sub(j, Mul(j_div_4, Set1(4.f)));
+
+  float4 s = MulAdd(r2, Set1(kSin3), Set1(kSin2));
+  s = MulAdd(r2, s, Set1(kSin1));
+  s = MulAdd(Mul(r, r2), s, r);
+
+  float4 c = MulAdd(r2, Set1(kCos3), Set1(kCos2));
+  c = MulAdd(r2, c, Set1(kCos1));
+  c = MulAdd(Mul(r2, r2), c, Sub(Set1(1.f), Mul(r2, Set1(0.5f))));
+
+  const float4 is_one = CmpEq(quadrant, Set1(1.f));
+  const float4 is_two = CmpEq(quadrant, Set1(2.f));
+  const float4 is_three = CmpEq(quadrant, Set1(3.f));
+  const float4 swap = Or(is_one, is_three);
+  const float4 sign_bit = Set1(-0.f);
+
+  const float4 sin_value = Select(swap, c, s);
+  const float4 cos_value = Select(swap, s, c);
+  sin_ret = Xor(sin_value, And(Or(is_two, is_three), sign_bit));
+  cos_ret = Xor(cos_value, And(Or(is_one, is_two), sign_bit));
+}
+
+//! Calculates the tangent of `x` (in radians).
+//!
+//! The relative error is below 2e-7 for |x| <= 100. For larger arguments the
+//! range reduction error is amplified close to the poles (up to 2e-5 at
+//! |x| ~= 8192).
+inline float FastTan(float x) {
+  using namespace FastMathConstants;
+  const float scaled = x * kTwoOverPi;
+  const int quadrant_index =
+      static_cast<int>(scaled >= 0.f ? scaled + 0.5f : scaled - 0.5f);
+  const float j = static_cast<float>(quadrant_index);
+
+  float r = x - j * kPiOver2Part1;
+  r -= j * kPiOver2Part2;
+  r -= j * kPiOver2Part3;
+  const float z = r * r;
+
+  float t = kTan6;
+  t = t * z + kTan5;
+  t = t * z + kTan4;
+  t = t * z + kTan3;
+  t = t * z + kTan2;
+  t = t * z + kTan1;
+  t = t * z * r + r;
+
+  // tan(r + pi/2) == -1 / tan(r)
+  return (quadrant_index & 1) ? -1.f / t : t;
+}
+
+//! 4-wide version of FastTan with identical error bounds.
+inline Simd::float4 FastTan(Simd::float4 x) {
+  using namespace Simd;
+  using namespace FastMathConstants;
+  const float4 j = RoundNearest(Mul(x, Set1(kTwoOverPi)));
+
+  float4 r = Sub(x, Mul(j, Set1(kPiOver2Part1)));
+  r = Sub(r, Mul(j, Set1(kPiOver2Part2)));
+  r = Sub(r, Mul(j, Set1(kPiOver2Part3)));
+  const float4 z = Mul(r, r);
+
+  float4 t = MulAdd(Set1(kTan6), z, Set1(kTan5));
+  t = MulAdd(t, z, Set1(kTan4));
+  t = MulAdd(t, z, Set1(kTan3));
+  t = MulAdd(t, z, Set1(kTan2));
+  t = MulAdd(t, z, Set1(kTan1));
+  t = MulAdd(Mul(t, z), r, r);
+
+  // j is odd if j - 2 * floor(j / 2) == 1, and floor(j / 2) for integral j is
+  // round(j / 2 - 0.25).
+  const float4 j_div_2 = RoundNearest(Sub(Mul(j, Set1(0.5f)), Set1(0.25f)));
+  const float4 odd = CmpEq(Sub(j, Add(j_div_2, j_div_2)), Set1(1.f));
+  return Select(odd, Negate(Div(Set1(1.f), t)), t);
+}
+
+//! Calculates the arc cosine of `x`, which must be in [-1, 1].
+//!
+//! The absolute error is below 3e-7.
+inline float FastAcos(float x) {
+  using namespace FastMathConstants;
+  const float a = fabsf(x);
+
+  // asin(s) for |s| <= 0.5, with acos(|x|) == 2 * asin(sqrt((1 - |x|) / 2))
+  // used to bring larger arguments into range.
+  float z, s;
+  if (a <= 0.5f) {
+    z = x * x;
+    s = a;
+  } else {
+    z = 0.5f * (1.f - a);
+    s = sqrtf(z);
+  }
+
+  float p = kAsin5;
+  p = p * z + kAsin4;
+  p = p * z + kAsin3;
+  p = p * z + kAsin2;
+  p = p * z + kAsin1;
+  p = p * z * s + s;
+
+  if (a <= 0.5f) {
+    return x < 0.f ? kPiOver2 + p : kPiOver2 - p;
+  }
+  return x < 0.f ? kPi - 2.f * p : 2.f * p;
+}
+
+//! 4-wide version of FastAcos with identical error bounds.
+inline Simd::float4 FastAcos(Simd::float4 x) {
+  using namespace Simd;
+  using namespace FastMathConstants;
+  const float4 a = Abs(x);
+  const float4 small = CmpLe(a, Set1(0.5f));
+  const float4 negative = CmpLt(x, Zero());
+
+  const float4 z_large = Mul(Set1(0.5f), Sub(Set1(1.f), a));
+  const float4 z = Select(small, Mul(x, x), z_large);
+  const float4 s = Select(small, a, Sqrt(z_large));
+
+  float4 p = MulAdd(Set1(kAsin5), z, Set1(kAsin4));
+  p = MulAdd(p, z, Set1(kAsin3));
+  p = MulAdd(p, z, Set1(kAsin2));
+  p = MulAdd(p, z, Set1(kAsin1));
+  p = MulAdd(Mul(p, z), s, s);
+
+  const float4 small_result =
+      Select(negative, Add(Set1(kPiOver2), p), Sub(Set1(kPiOver2), p));
+  const float4 twice_p = Add(p, p);
+  const float4 large_result =
+      Select(negative, Sub(Set1(kPi), twice_p), twice_p);
+  return Select(small, small_result, large_result);
+}
+
+//! Trigonometry used by the library itself.
+inline void TrigSinCos(float x, float &sin_ret, float &cos_ret) {
+#ifdef XBOX_MATH_FAST_TRIG
+  FastSinCos(x, sin_ret, cos_ret);
+#else
+  sin_ret = sinf(x);
+  cos_ret = cosf(x);
+#endif
+}
+
+//! 4-wide TrigSinCos, for callers that need several sines and cosines at once.
+inline void TrigSinCos(Simd::float4 x, Simd::float4 &sin_ret,
+                       Simd::float4 &cos_ret) {
+#ifdef XBOX_MATH_FAST_TRIG
+  FastSinCos(x, sin_ret, cos_ret);
+#else
+  float values[4];
+  float sines[4];
+  float cosines[4];
+  Simd::StoreUnaligned(values, x);
+  for (uint32_t i = 0; i < 4; ++i) {
+    sines[i] = sinf(values[i]);
+    cosines[i] = cosf(values[i]);
+  }
+  sin_ret = Simd::LoadUnaligned(sines);
+  cos_ret = Simd::LoadUnaligned(cosines);
+#endif
+}
+
+inline float TrigSin(float x) {
+#ifdef XBOX_MATH_FAST_TRIG
+  // Either polynomial may give the sine depending on the quadrant, so there
+  // is no cheaper sine-only approximation.
+  float sin_ret, cos_ret;
+  FastSinCos(x, sin_ret, cos_ret);
+  return sin_ret;
+#else
+  return sinf(x);
+#endif
+}
+
+inline float TrigTan(float x) {
+#ifdef XBOX_MATH_FAST_TRIG
+  return FastTan(x);
+#else
+  return tanf(x);
+#endif
+}
+
+inline float TrigAcos(float x) {
+#ifdef XBOX_MATH_FAST_TRIG
+  return FastAcos(x);
+#else
+  return static_cast<float>(acos(x));
+#endif
+}
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_FAST_MATH_H_
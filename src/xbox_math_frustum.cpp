@@ -1,5 +1,6 @@
 #include "xbox_math_frustum.h"
 
+#include "xbox_math_fast_math.h"
 #include "xbox_math_matrix.h"
 
 #define DEG2RAD(c) ((float)(c) * (float)M_PI / 180.0f)
@@ -12,12 +13,14 @@ namespace XboxMath {
 void frustum_t::CreateFrustumMatrixForPerspective(float fovY, float aspect,
                                                   float nearParam,
                                                   float farParam) {
+  const float tan_half_fov = TrigTan(DEG2RAD(fovY / 2));
+
   // Calculate the height/width of the near rect
-  float h_2n = (tanf(DEG2RAD(fovY / 2))) * nearParam;
+  float h_2n = tan_half_fov * nearParam;
   float w_2n = h_2n * aspect;
 
   // Calculate the height/width of the far rect
-  float h_2f = (tanf(DEG2RAD(fovY / 2))) * farParam;
+  float h_2f = tan_half_fov * farParam;
   float w_2f = h_2f * aspect;
 
   VectorSetVector(m_upperLeftNear, -w_2n, h_2n, -nearParam);
@@ -0,0 +1,168 @@
+#include "xbox_math_hiz.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+// Level rows hold at least one padding texel and are a multiple of 8 texels,
+// so each group of four output texels can read eight input texels.
+static inline uint32_t LevelPitch(uint32_t width) { return (width + 8) & ~7u; }
+
+void CHiZPyramid::Build(const void *depth_buffer, uint32_t pitch,
+                        DepthBufferFormat format, uint32_t width,
+                        uint32_t height) {
+  m_levels.clear();
+  if (!width || !height) {
+    m_min.clear();
+    m_max.clear();
+    return;
+  }
+
+  size_t offset = 0;
+  for (;;) {
+    const hizlevel_t level = {width, height, LevelPitch(width), offset};
+    m_levels.push_back(level);
+    offset += static_cast<size_t>(level.m_pitch) * height;
+    if (width == 1 && height == 1) {
+      break;
+    }
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+  }
+  m_min.resize(offset);
+  m_max.resize(offset);
+
+  const hizlevel_t &base = m_levels[0];
+  for (uint32_t y = 0; y < base.m_height; ++y) {
+    const size_t row = base.m_offset + static_cast<size_t>(y) * base.m_pitch;
+    DecodeDepthValues(format,
+                      static_cast<const uint8_t *>(depth_buffer) +
+                          static_cast<size_t>(y) * pitch,
+                      base.m_width, &m_min[row]);
+    std::copy(&m_min[row], &m_min[row] + base.m_width, &m_max[row]);
+  }
+  PadLevel(0);
+
+  for (uint32_t level = 1; level < GetLevelCount(); ++level) {
+    BuildLevel(level);
+    PadLevel(level);
+  }
+}
+
+void CHiZPyramid::BuildLevel(uint32_t level) {
+  using namespace Simd;
+  const hizlevel_t &source = m_levels[level - 1];
+  const hizlevel_t &target = m_levels[level];
+
+  for (uint32_t y = 0; y < target.m_height; ++y) {
+    // Odd heights reuse the last source row.
+    const size_t row0 =
+        source.m_offset + static_cast<size_t>(2 * y) * source.m_pitch;
+    const size_t row1 =
+        source.m_offset +
+        static_cast<size_t>(std::min(2 * y + 1, source.m_height - 1)) *
+            source.m_pitch;
+    const size_t target_row =
+        target.m_offset + static_cast<size_t>(y) * target.m_pitch;
+
+    for (uint32_t x = 0; x < target.m_width; x += 4) {
+      const uint32_t source_x = 2 * x;
+      float4 even, odd;
+
+      const float4 min_low = Min(LoadUnaligned(&m_min[row0 + source_x]),
+                                 LoadUnaligned(&m_min[row1 + source_x]));
+      const float4 min_high = Min(LoadUnaligned(&m_min[row0 + source_x + 4]),
+                                  LoadUnaligned(&m_min[row1 + source_x + 4]));
+      Deinterleave(min_low, min_high, even, odd);
+      StoreUnaligned(&m_min[target_row + x], Min(even, odd));
+
+      const float4 max_low = Max(LoadUnaligned(&m_max[row0 + source_x]),
+                                 LoadUnaligned(&m_max[row1 + source_x]));
+      const float4 max_high = Max(LoadUnaligned(&m_max[row0 + source_x + 4]),
+                                  LoadUnaligned(&m_max[row1 + source_x + 4]));
+      Deinterleave(max_low, max_high, even, odd);
+      StoreUnaligned(&m_max[target_row + x], Max(even, odd));
+    }
+  }
+}
+
+void CHiZPyramid::PadLevel(uint32_t level) {
+  // Replicating the last column makes odd widths reduce like clamped reads.
+  const hizlevel_t &info = m_levels[level];
+  for (uint32_t y = 0; y < info.m_height; ++y) {
+    const size_t row = info.m_offset + static_cast<size_t>(y) * info.m_pitch;
+    std::fill(&m_min[row + info.m_width], &m_min[row + info.m_pitch],
+              m_min[row + info.m_width - 1]);
+    std::fill(&m_max[row + info.m_width], &m_max[row + info.m_pitch],
+              m_max[row + info.m_width - 1]);
+  }
+}
+
+float CHiZPyramid::GetMinDepth(uint32_t level, uint32_t x, uint32_t y) const {
+  const hizlevel_t &info = m_levels[level];
+  return m_min[info.m_offset + static_cast<size_t>(y) * info.m_pitch + x];
+}
+
+float CHiZPyramid::GetMaxDepth(uint32_t level, uint32_t x, uint32_t y) const {
+  const hizlevel_t &info = m_levels[level];
+  return m_max[info.m_offset + static_cast<size_t>(y) * info.m_pitch + x];
+}
+
+uint32_t CHiZPyramid::TestRects(const screenrect_t *rects, uint32_t count,
+                                HiZResult *results) const {
+  uint32_t ret = 0;
+  if (m_levels.empty()) {
+    std::fill(results, results + count, kHiZVisible);
+    return ret;
+  }
+
+  const auto width = static_cast<float>(m_levels[0].m_width);
+  const auto height = static_cast<float>(m_levels[0].m_height);
+  for (uint32_t i = 0; i < count; ++i) {
+    const screenrect_t &rect = rects[i];
+    if (rect.m_maxX < 0.f || rect.m_maxY < 0.f || rect.m_minX >= width ||
+        rect.m_minY >= height) {
+      results[i] = kHiZVisible;
+      continue;
+    }
+
+    // The pixels the rect touches.
+    const auto x0 = static_cast<uint32_t>(std::max(0.f, floorf(rect.m_minX)));
+    const auto y0 = static_cast<uint32_t>(std::max(0.f, floorf(rect.m_minY)));
+    const auto x1 =
+        static_cast<uint32_t>(std::min(width - 1.f, floorf(rect.m_maxX)));
+    const auto y1 =
+        static_cast<uint32_t>(std::min(height - 1.f, floorf(rect.m_maxY)));
+
+    // The finest level at which they span at most 2x2 texels.
+    uint32_t level = 0;
+    while ((x1 >> level) - (x0 >> level) > 1 ||
+           (y1 >> level) - (y0 >> level) > 1) {
+      ++level;
+    }
+
+    float min_depth = FLT_MAX, max_depth = -FLT_MAX;
+    for (uint32_t y = y0 >> level; y <= y1 >> level; ++y) {
+      for (uint32_t x = x0 >> level; x <= x1 >> level; ++x) {
+        min_depth = std::min(min_depth, GetMinDepth(level, x, y));
+        max_depth = std::max(max_depth, GetMaxDepth(level, x, y));
+      }
+    }
+
+    if (rect.m_minZ > max_depth) {
+      results[i] = kHiZOccluded;
+      ++ret;
+    } else if (rect.m_maxZ < min_depth) {
+      results[i] = kHiZVisible;
+    } else {
+      results[i] = kHiZPartiallyOccluded;
+    }
+  }
+  return ret;
+}
+
+}  // namespace XboxMath
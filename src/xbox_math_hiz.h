@@ -0,0 +1,71 @@
+#ifndef XBOX_MATH_HIZ_H_
+#define XBOX_MATH_HIZ_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "xbox_math_depth.h"
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+enum HiZResult {
+  kHiZOccluded,           // Behind every pixel the rect covers.
+  kHiZPartiallyOccluded,  // Neither of the other cases.
+  kHiZVisible,            // In front of every pixel the rect covers.
+};
+
+//! A hierarchical Z pyramid built from an existing depth buffer, such as last
+//! frame's, for occlusion culling without rasterizing occluders.
+//!
+//! Level 0 holds the decoded screen space depth of every pixel. Each further
+//! level halves the resolution and stores the minimum and maximum depth of the
+//! 2x2 texels below it, down to a single texel.
+class CHiZPyramid {
+ public:
+  //! Builds the pyramid from a `width` x `height` depth buffer of `format`
+  //! whose rows are `pitch` bytes apart.
+  void Build(const void *depth_buffer, uint32_t pitch,
+             DepthBufferFormat format, uint32_t width, uint32_t height);
+
+  [[nodiscard]] uint32_t GetLevelCount() const {
+    return static_cast<uint32_t>(m_levels.size());
+  }
+  [[nodiscard]] uint32_t GetLevelWidth(uint32_t level) const {
+    return m_levels[level].m_width;
+  }
+  [[nodiscard]] uint32_t GetLevelHeight(uint32_t level) const {
+    return m_levels[level].m_height;
+  }
+  [[nodiscard]] float GetMinDepth(uint32_t level, uint32_t x,
+                                  uint32_t y) const;
+  [[nodiscard]] float GetMaxDepth(uint32_t level, uint32_t x,
+                                  uint32_t y) const;
+
+  //! Classifies `count` screen space rects, e.g. from
+  //! BoundingSphereScreenRectsPerspective with the camera that rendered the
+  //! depth buffer. Each rect is tested against the level at which it covers
+  //! at most 2x2 texels. Rects outside the buffer are reported as visible.
+  //! \return the number of occluded rects.
+  uint32_t TestRects(const screenrect_t *rects, uint32_t count,
+                     HiZResult *results) const;
+
+ private:
+  typedef struct hizlevel_t {
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_pitch;   // In texels, padded by replicating the last column.
+    size_t m_offset;    // Of the level's first texel in m_min and m_max.
+  } hizlevel_t;
+
+  void BuildLevel(uint32_t level);
+  void PadLevel(uint32_t level);
+
+  std::vector<hizlevel_t> m_levels;
+  std::vector<float> m_min;
+  std::vector<float> m_max;
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_HIZ_H_
@@ -0,0 +1,74 @@
+#include "xbox_math_lod.h"
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+static_assert(kMaxLodCount == 8, "SelectLods loads thresholds in two fours");
+
+void SelectLods(const boundingsphere_t *spheres, uint32_t count,
+                const vector_t &camera_position, float projection_scale,
+                const lodthresholds_t *tables, const uint32_t *table_indices,
+                uint32_t *lods) {
+  using namespace Simd;
+  const float4 camera_x = Set1(camera_position[0]);
+  const float4 camera_y = Set1(camera_position[1]);
+  const float4 camera_z = Set1(camera_position[2]);
+  const float4 scale_squared = Set1(projection_scale * projection_scale);
+  const float4 one = Set1(1.f);
+
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t lanes = count - first < 4 ? count - first : 4;
+    const boundingsphere_t *s[4];
+    const lodthresholds_t *t[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      const uint32_t index = first + (i < lanes ? i : lanes - 1);
+      s[i] = &spheres[index];
+      t[i] = &tables[table_indices[index]];
+    }
+
+    float4 x = LoadUnaligned(s[0]->m_centerPt);
+    float4 y = LoadUnaligned(s[1]->m_centerPt);
+    float4 z = LoadUnaligned(s[2]->m_centerPt);
+    float4 w = LoadUnaligned(s[3]->m_centerPt);
+    Transpose(x, y, z, w);
+    x = Sub(x, camera_x);
+    y = Sub(y, camera_y);
+    z = Sub(z, camera_z);
+    const float4 distance_squared = MulAdd(x, x, MulAdd(y, y, Mul(z, z)));
+    const float4 radius =
+        Set(s[0]->m_radius, s[1]->m_radius, s[2]->m_radius, s[3]->m_radius);
+    // radius * scale / distance < threshold, squared and cross multiplied.
+    const float4 projected = Mul(Mul(radius, radius), scale_squared);
+
+    // Transposed loads of each table's first and last four thresholds, one
+    // level per register. The two halves share level 3.
+    float4 low[4], high[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      low[i] = LoadUnaligned(t[i]->m_screenRadius);
+      high[i] = LoadUnaligned(t[i]->m_screenRadius + kMaxLodCount - 5);
+    }
+    Transpose(low[0], low[1], low[2], low[3]);
+    Transpose(high[0], high[1], high[2], high[3]);
+    const float4 thresholds[kMaxLodCount - 1] = {
+        low[0], low[1], low[2], low[3], high[1], high[2], high[3]};
+
+    float4 lod = Zero();
+    for (const float4 &threshold : thresholds) {
+      const float4 below = CmpLt(
+          projected, Mul(Mul(threshold, threshold), distance_squared));
+      lod = Add(lod, And(below, one));
+    }
+    // Thresholds above projection_scale would otherwise push spheres
+    // containing the camera past LOD 0.
+    lod = AndNot(CmpLe(distance_squared, Mul(radius, radius)), lod);
+
+    float values[4];
+    StoreUnaligned(values, lod);
+    for (uint32_t i = 0; i < lanes; ++i) {
+      lods[first + i] = static_cast<uint32_t>(values[i]);
+    }
+  }
+}
+
+}  // namespace XboxMath
@@ -0,0 +1,41 @@
+#ifndef XBOX_MATH_LOD_H_
+#define XBOX_MATH_LOD_H_
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! The maximum number of levels of detail an object may have.
+static constexpr uint32_t kMaxLodCount = 8;
+
+//! Projected bounding sphere radii below which an object switches to each
+//! coarser level of detail: LOD i + 1 is used once the radius drops below
+//! m_screenRadius[i]. Radii must be in descending order, with unused entries
+//! set to 0. Units are those of the projection scale, e.g. pixels.
+typedef struct lodthresholds_t {
+  float m_screenRadius[kMaxLodCount - 1];
+} lodthresholds_t;
+
+//! Returns the number of pixels a sphere of radius 1, one unit from the
+//! camera, spans vertically for a projection built by
+//! CreateD3DPerspectiveFOVLH and a viewport `viewport_height` pixels high.
+inline float LodProjectionScale(const matrix4_t &projection,
+                                float viewport_height) {
+  return projection[1][1] * viewport_height * 0.5f;
+}
+
+//! Selects the level of detail of `count` objects from the projected radius
+//! of their bounding spheres, radius * `projection_scale` / distance to
+//! `camera_position`. Object i uses `tables[table_indices[i]]`, so objects
+//! sharing a mesh may share a table.
+//!
+//! The distance is compared squared against each threshold, so no square
+//! roots are taken. Objects whose sphere contains the camera use LOD 0.
+void SelectLods(const boundingsphere_t *spheres, uint32_t count,
+                const vector_t &camera_position, float projection_scale,
+                const lodthresholds_t *tables, const uint32_t *table_indices,
+                uint32_t *lods);
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_LOD_H_
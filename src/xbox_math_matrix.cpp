@@ -1,5 +1,7 @@
 #include "xbox_math_matrix.h"
 
+#include "xbox_math_fast_math.h"
+
 #ifndef NDEBUG
 #include <cassert>
 #define DBGASSERT(c) assert((c))
@@ -262,8 +264,8 @@ void MatrixRotate(const matrix4_t &mat, const vector_t &rotation,
   matrix4_t temp;
 
   MatrixSetIdentity(temp);
-  float sin_rz = sinf(rotation[2]);
-  float cos_rz = cosf(rotation[2]);
+  float sin_rz, cos_rz;
+  TrigSinCos(rotation[2], sin_rz, cos_rz);
   temp[0][0] = cos_rz;
   temp[0][1] = sin_rz;
   temp[1][0] = -sin_rz;
@@ -271,8 +273,8 @@ void MatrixRotate(const matrix4_t &mat, const vector_t &rotation,
   MatrixMultMatrix(mat, temp, ret);
 
   MatrixSetIdentity(temp);
-  float sin_ry = sinf(rotation[1]);
-  float cos_ry = cosf(rotation[1]);
+  float sin_ry, cos_ry;
+  TrigSinCos(rotation[1], sin_ry, cos_ry);
   temp[0][0] = cos_ry;
   temp[0][2] = -sin_ry;
   temp[2][0] = sin_ry;
@@ -280,8 +282,8 @@ void MatrixRotate(const matrix4_t &mat, const vector_t &rotation,
   MatrixMultMatrix(ret, temp);
 
   MatrixSetIdentity(temp);
-  float sin_rx = sinf(rotation[0]);
-  float cos_rx = cosf(rotation[0]);
+  float sin_rx, cos_rx;
+  TrigSinCos(rotation[0], sin_rx, cos_rx);
   temp[1][1] = cos_rx;
   temp[1][2] = sin_rx;
   temp[2][1] = -sin_rx;
@@ -0,0 +1,362 @@
+#include "xbox_math_mesh.h"
+
+#include <cfloat>
+
+#include "xbox_math_fast_math.h"
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+namespace {
+
+using Simd::float4;
+
+bool IndicesInRange(const uint32_t *indices, uint32_t index_count,
+                    uint32_t vertex_count) {
+  for (uint32_t i = 0; i < index_count; ++i) {
+    if (indices[i] >= vertex_count) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Scales the vectors (x, y, z) to unit length, leaving zero vectors as zero.
+inline void Normalize(float4 &x, float4 &y, float4 &z) {
+  using namespace Simd;
+  const float4 length_squared = MulAdd(x, x, MulAdd(y, y, Mul(z, z)));
+  const float4 scale = RsqrtRefinedOrZero(length_squared);
+  x = Mul(x, scale);
+  y = Mul(y, scale);
+  z = Mul(z, scale);
+}
+
+// Finds the first corner and the corner count of the four vertices starting at
+// `first`, of which `lanes` are in use; unused lanes get no corners.
+// \return the largest corner count.
+uint32_t VertexCorners(const vertexadjacency_t &adjacency, uint32_t first,
+                       uint32_t lanes, uint32_t (&begin)[4],
+                       uint32_t (&degree)[4]) {
+  uint32_t max_degree = 0;
+  for (uint32_t lane = 0; lane < 4; ++lane) {
+    const uint32_t v = first + (lane < lanes ? lane : 0);
+    begin[lane] = adjacency.m_offsets[v];
+    degree[lane] = lane < lanes ? adjacency.m_offsets[v + 1] - begin[lane] : 0;
+    max_degree = degree[lane] > max_degree ? degree[lane] : max_degree;
+  }
+  return max_degree;
+}
+
+// The lanes that still have a corner at `step`.
+inline float4 ActiveLanes(uint32_t step, const uint32_t (&degree)[4]) {
+  using namespace Simd;
+  return CmpLt(Set1(static_cast<float>(step)),
+               Set(static_cast<float>(degree[0]), static_cast<float>(degree[1]),
+                   static_cast<float>(degree[2]),
+                   static_cast<float>(degree[3])));
+}
+
+// The vertices following and preceding `corner` in its triangle.
+inline void CornerNeighbours(const uint32_t *indices, uint32_t corner,
+                             uint32_t &next, uint32_t &previous) {
+  const uint32_t triangle = corner / 3;
+  const uint32_t at = corner - triangle * 3;
+  next = indices[triangle * 3 + (at == 2 ? 0 : at + 1)];
+  previous = indices[triangle * 3 + (at == 0 ? 2 : at - 1)];
+}
+
+// Loads lanes [`first`, `first` + `lanes`) of `vectors`, repeating the first
+// for unused lanes, transposed to one component per register.
+inline void LoadTransposed(const vector_t *vectors, uint32_t first,
+                           uint32_t lanes, float4 (&ret)[4]) {
+  using namespace Simd;
+  for (uint32_t lane = 0; lane < 4; ++lane) {
+    ret[lane] = LoadUnaligned(vectors[first + (lane < lanes ? lane : 0)]);
+  }
+  Transpose(ret[0], ret[1], ret[2], ret[3]);
+}
+
+// Transposes `rows` back and stores lanes [`first`, `first` + `lanes`).
+inline void StoreTransposed(float4 (&rows)[4], uint32_t first, uint32_t lanes,
+                            vector_t *ret) {
+  using namespace Simd;
+  Transpose(rows[0], rows[1], rows[2], rows[3]);
+  for (uint32_t lane = 0; lane < lanes; ++lane) {
+    StoreUnaligned(ret[first + lane], rows[lane]);
+  }
+}
+
+}  // namespace
+
+bool ComputeFaceNormals(const vertex_t *vertices, uint32_t vertex_count,
+                        const uint32_t *indices, uint32_t triangle_count,
+                        bool normalize, vector_t *normals) {
+  using namespace Simd;
+  if (!IndicesInRange(indices, triangle_count * 3, vertex_count)) {
+    return false;
+  }
+
+  for (uint32_t first = 0; first < triangle_count; first += 4) {
+    const uint32_t lanes =
+        triangle_count - first < 4 ? triangle_count - first : 4;
+    // The three corners of four triangles, one component per register.
+    float4 corners[3][4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      const uint32_t *triangle =
+          &indices[(first + (lane < lanes ? lane : lanes - 1)) * 3];
+      for (uint32_t corner = 0; corner < 3; ++corner) {
+        corners[corner][lane] = LoadUnaligned(vertices[triangle[corner]]);
+      }
+    }
+    for (auto &corner : corners) {
+      Transpose(corner[0], corner[1], corner[2], corner[3]);
+    }
+    const float4(&a)[4] = corners[0];
+    const float4(&b)[4] = corners[1];
+    const float4(&c)[4] = corners[2];
+
+    const float4 ab_x = Sub(a[0], b[0]);
+    const float4 ab_y = Sub(a[1], b[1]);
+    const float4 ab_z = Sub(a[2], b[2]);
+    const float4 bc_x = Sub(b[0], c[0]);
+    const float4 bc_y = Sub(b[1], c[1]);
+    const float4 bc_z = Sub(b[2], c[2]);
+    float4 normal[4] = {Sub(Mul(ab_y, bc_z), Mul(ab_z, bc_y)),
+                        Sub(Mul(ab_z, bc_x), Mul(ab_x, bc_z)),
+                        Sub(Mul(ab_x, bc_y), Mul(ab_y, bc_x)), Set1(1.f)};
+    if (normalize) {
+      Normalize(normal[0], normal[1], normal[2]);
+    }
+
+    Transpose(normal[0], normal[1], normal[2], normal[3]);
+    for (uint32_t lane = 0; lane < lanes; ++lane) {
+      StoreUnaligned(normals[first + lane], normal[lane]);
+    }
+  }
+  return true;
+}
+
+bool BuildVertexAdjacency(const uint32_t *indices, uint32_t triangle_count,
+                          uint32_t vertex_count, vertexadjacency_t &ret) {
+  const uint32_t corner_count = triangle_count * 3;
+  if (!IndicesInRange(indices, corner_count, vertex_count)) {
+    return false;
+  }
+  // Count the corners of each vertex, then place them with a counting sort.
+  ret.m_offsets.assign(vertex_count + 1, 0);
+  for (uint32_t i = 0; i < corner_count; ++i) {
+    ++ret.m_offsets[indices[i] + 1];
+  }
+  for (uint32_t v = 0; v < vertex_count; ++v) {
+    ret.m_offsets[v + 1] += ret.m_offsets[v];
+  }
+  ret.m_corners.resize(corner_count);
+  std::vector<uint32_t> next(ret.m_offsets.begin(), ret.m_offsets.end() - 1);
+  for (uint32_t i = 0; i < corner_count; ++i) {
+    ret.m_corners[next[indices[i]]++] = i;
+  }
+  return true;
+}
+
+void ComputeVertexNormals(const vertex_t *vertices, const uint32_t *indices,
+                          const vector_t *face_normals,
+                          const vertexadjacency_t &adjacency,
+                          VertexNormalWeighting weighting,
+                          uint32_t first_vertex, uint32_t vertex_count,
+                          vector_t *normals) {
+  using namespace Simd;
+  const uint32_t *corners = adjacency.m_corners.data();
+  const float4 min_length_squared = Set1(FLT_MIN);
+  const uint32_t end_vertex = first_vertex + vertex_count;
+
+  // Four vertices at a time, one per lane, walking their corners in step.
+  for (uint32_t first = first_vertex; first < end_vertex; first += 4) {
+    const uint32_t lanes = end_vertex - first < 4 ? end_vertex - first : 4;
+    uint32_t begin[4], degree[4];
+    const uint32_t max_degree =
+        VertexCorners(adjacency, first, lanes, begin, degree);
+
+    float4 sum[4] = {Zero(), Zero(), Zero(), Zero()};
+    if (weighting == kVertexNormalWeightArea) {
+      // The face normals' lengths are already twice the triangle areas.
+      for (uint32_t lane = 0; lane < 4; ++lane) {
+        for (uint32_t i = 0; i < degree[lane]; ++i) {
+          sum[lane] = Add(
+              sum[lane], LoadUnaligned(face_normals[corners[begin[lane] + i] /
+                                                    3]));
+        }
+      }
+      Transpose(sum[0], sum[1], sum[2], sum[3]);
+    } else {
+      float4 position[4];
+      LoadTransposed(vertices, first, lanes, position);
+
+      for (uint32_t step = 0; step < max_degree; ++step) {
+        float4 normal[4], next[4], previous[4];
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+          // Lanes past their vertex's degree repeat its first corner, and are
+          // masked out below.
+          const uint32_t corner =
+              corners[begin[lane] + (step < degree[lane] ? step : 0)];
+          uint32_t next_index, previous_index;
+          CornerNeighbours(indices, corner, next_index, previous_index);
+          normal[lane] = LoadUnaligned(face_normals[corner / 3]);
+          next[lane] = LoadUnaligned(vertices[next_index]);
+          previous[lane] = LoadUnaligned(vertices[previous_index]);
+        }
+        Transpose(normal[0], normal[1], normal[2], normal[3]);
+        Transpose(next[0], next[1], next[2], next[3]);
+        Transpose(previous[0], previous[1], previous[2], previous[3]);
+
+        // The angle between the edges leaving the vertex.
+        const float4 a_x = Sub(next[0], position[0]);
+        const float4 a_y = Sub(next[1], position[1]);
+        const float4 a_z = Sub(next[2], position[2]);
+        const float4 b_x = Sub(previous[0], position[0]);
+        const float4 b_y = Sub(previous[1], position[1]);
+        const float4 b_z = Sub(previous[2], position[2]);
+        const float4 dot = MulAdd(a_x, b_x, MulAdd(a_y, b_y, Mul(a_z, b_z)));
+        const float4 lengths_squared =
+            Mul(MulAdd(a_x, a_x, MulAdd(a_y, a_y, Mul(a_z, a_z))),
+                MulAdd(b_x, b_x, MulAdd(b_y, b_y, Mul(b_z, b_z))));
+        const float4 cosine =
+            Max(Set1(-1.f),
+                Min(Set1(1.f), Mul(dot, RsqrtRefined(Max(
+                                            lengths_squared,
+                                            min_length_squared)))));
+        const float4 normal_length_squared =
+            MulAdd(normal[0], normal[0],
+                   MulAdd(normal[1], normal[1], Mul(normal[2], normal[2])));
+
+        // Scaled by the inverse face normal length to make it unit length.
+        // Degenerate triangles and finished lanes contribute nothing.
+        const float4 valid =
+            And(ActiveLanes(step, degree),
+                And(CmpGe(lengths_squared, min_length_squared),
+                    CmpGe(normal_length_squared, min_length_squared)));
+        const float4 weight =
+            And(valid, Mul(FastAcos(cosine),
+                           RsqrtRefined(Max(normal_length_squared,
+                                            min_length_squared))));
+        sum[0] = MulAdd(normal[0], weight, sum[0]);
+        sum[1] = MulAdd(normal[1], weight, sum[1]);
+        sum[2] = MulAdd(normal[2], weight, sum[2]);
+      }
+    }
+
+    Normalize(sum[0], sum[1], sum[2]);
+    sum[3] = Set1(1.f);
+    StoreTransposed(sum, first, lanes, normals);
+  }
+}
+
+void ComputeVertexTangents(const vertex_t *vertices,
+                           const texcoord_t *texcoords,
+                           const uint32_t *indices, const vector_t *normals,
+                           const vertexadjacency_t &adjacency,
+                           bool orthogonalize, uint32_t first_vertex,
+                           uint32_t vertex_count, vector_t *tangents) {
+  using namespace Simd;
+  const uint32_t *corners = adjacency.m_corners.data();
+  const uint32_t end_vertex = first_vertex + vertex_count;
+
+  for (uint32_t first = first_vertex; first < end_vertex; first += 4) {
+    const uint32_t lanes = end_vertex - first < 4 ? end_vertex - first : 4;
+    uint32_t begin[4], degree[4];
+    const uint32_t max_degree =
+        VertexCorners(adjacency, first, lanes, begin, degree);
+
+    float4 position[4];
+    LoadTransposed(vertices, first, lanes, position);
+    const texcoord_t *uv[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      uv[lane] = &texcoords[first + (lane < lanes ? lane : 0)];
+    }
+    const float4 u = Set((*uv[0])[0], (*uv[1])[0], (*uv[2])[0], (*uv[3])[0]);
+    const float4 v = Set((*uv[0])[1], (*uv[1])[1], (*uv[2])[1], (*uv[3])[1]);
+
+    float4 tangent[4] = {Zero(), Zero(), Zero(), Zero()};
+    float4 bitangent[3] = {Zero(), Zero(), Zero()};
+    for (uint32_t step = 0; step < max_degree; ++step) {
+      float4 next[4], previous[4];
+      const float *next_uv[4], *previous_uv[4];
+      for (uint32_t lane = 0; lane < 4; ++lane) {
+        const uint32_t corner =
+            corners[begin[lane] + (step < degree[lane] ? step : 0)];
+        uint32_t next_index, previous_index;
+        CornerNeighbours(indices, corner, next_index, previous_index);
+        next[lane] = LoadUnaligned(vertices[next_index]);
+        previous[lane] = LoadUnaligned(vertices[previous_index]);
+        next_uv[lane] = texcoords[next_index];
+        previous_uv[lane] = texcoords[previous_index];
+      }
+      Transpose(next[0], next[1], next[2], next[3]);
+      Transpose(previous[0], previous[1], previous[2], previous[3]);
+
+      // Solves e1 = du1 * T + dv1 * B and e2 = du2 * T + dv2 * B for the
+      // triangle's edges leaving the vertex.
+      const float4 e1_x = Sub(next[0], position[0]);
+      const float4 e1_y = Sub(next[1], position[1]);
+      const float4 e1_z = Sub(next[2], position[2]);
+      const float4 e2_x = Sub(previous[0], position[0]);
+      const float4 e2_y = Sub(previous[1], position[1]);
+      const float4 e2_z = Sub(previous[2], position[2]);
+      const float4 du1 = Sub(
+          Set(next_uv[0][0], next_uv[1][0], next_uv[2][0], next_uv[3][0]), u);
+      const float4 dv1 = Sub(
+          Set(next_uv[0][1], next_uv[1][1], next_uv[2][1], next_uv[3][1]), v);
+      const float4 du2 = Sub(Set(previous_uv[0][0], previous_uv[1][0],
+                                 previous_uv[2][0], previous_uv[3][0]),
+                             u);
+      const float4 dv2 = Sub(Set(previous_uv[0][1], previous_uv[1][1],
+                                 previous_uv[2][1], previous_uv[3][1]),
+                             v);
+      const float4 determinant = Sub(Mul(du1, dv2), Mul(du2, dv1));
+      const float4 valid = And(ActiveLanes(step, degree),
+                               CmpGe(Abs(determinant), Set1(FLT_MIN)));
+      const float4 r =
+          And(valid, Div(Set1(1.f), Select(valid, determinant, Set1(1.f))));
+
+      const float4 t_dv2 = Mul(dv2, r);
+      const float4 t_dv1 = Mul(dv1, r);
+      tangent[0] = Add(tangent[0], Sub(Mul(e1_x, t_dv2), Mul(e2_x, t_dv1)));
+      tangent[1] = Add(tangent[1], Sub(Mul(e1_y, t_dv2), Mul(e2_y, t_dv1)));
+      tangent[2] = Add(tangent[2], Sub(Mul(e1_z, t_dv2), Mul(e2_z, t_dv1)));
+      const float4 b_du1 = Mul(du1, r);
+      const float4 b_du2 = Mul(du2, r);
+      bitangent[0] =
+          Add(bitangent[0], Sub(Mul(e2_x, b_du1), Mul(e1_x, b_du2)));
+      bitangent[1] =
+          Add(bitangent[1], Sub(Mul(e2_y, b_du1), Mul(e1_y, b_du2)));
+      bitangent[2] =
+          Add(bitangent[2], Sub(Mul(e2_z, b_du1), Mul(e1_z, b_du2)));
+    }
+
+    float4 normal[4];
+    LoadTransposed(normals, first, lanes, normal);
+    if (orthogonalize) {
+      const float4 dot =
+          MulAdd(normal[0], tangent[0],
+                 MulAdd(normal[1], tangent[1], Mul(normal[2], tangent[2])));
+      tangent[0] = Sub(tangent[0], Mul(normal[0], dot));
+      tangent[1] = Sub(tangent[1], Mul(normal[1], dot));
+      tangent[2] = Sub(tangent[2], Mul(normal[2], dot));
+    }
+    Normalize(tangent[0], tangent[1], tangent[2]);
+
+    // Left handed if the bitangent opposes normal x tangent.
+    const float4 cross_x =
+        Sub(Mul(normal[1], tangent[2]), Mul(normal[2], tangent[1]));
+    const float4 cross_y =
+        Sub(Mul(normal[2], tangent[0]), Mul(normal[0], tangent[2]));
+    const float4 cross_z =
+        Sub(Mul(normal[0], tangent[1]), Mul(normal[1], tangent[0]));
+    const float4 handedness =
+        MulAdd(cross_x, bitangent[0],
+               MulAdd(cross_y, bitangent[1], Mul(cross_z, bitangent[2])));
+    tangent[3] = Select(CmpLt(handedness, Zero()), Set1(-1.f), Set1(1.f));
+    StoreTransposed(tangent, first, lanes, tangents);
+  }
+}
+
+}  // namespace XboxMath
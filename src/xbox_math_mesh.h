@@ -0,0 +1,82 @@
+#ifndef XBOX_MATH_MESH_H_
+#define XBOX_MATH_MESH_H_
+
+#include <vector>
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! Computes the normal of each of `triangle_count` triangles whose vertex
+//! indices are stored consecutively in `indices`, with PlaneFindNormal's
+//! winding: for a triangle (a, b, c), (a - b) x (b - c), with w set to 1.
+//!
+//! If `normalize` is true, normals are scaled to unit length as by
+//! PlaneFindNormalizedNormal, to within 2^-21 relative error. Degenerate
+//! triangles then get a zero normal.
+//! \return false if an index is out of range, in which case nothing is
+//! written.
+bool ComputeFaceNormals(const vertex_t *vertices, uint32_t vertex_count,
+                        const uint32_t *indices, uint32_t triangle_count,
+                        bool normalize, vector_t *normals);
+
+//! The triangles around each vertex of an indexed mesh, in compressed sparse
+//! row layout: the corners of vertex v are m_corners[m_offsets[v]] up to
+//! m_corners[m_offsets[v + 1]]. Each corner is a position in the mesh's index
+//! array, so triangle corner / 3 uses the vertex as its corner % 3.
+typedef struct vertexadjacency_t {
+  std::vector<uint32_t> m_offsets;  // One more than the vertex count.
+  std::vector<uint32_t> m_corners;
+} vertexadjacency_t;
+
+//! Builds the adjacency of `vertex_count` vertices, once per mesh topology.
+//! \return false if an index is out of range.
+bool BuildVertexAdjacency(const uint32_t *indices, uint32_t triangle_count,
+                          uint32_t vertex_count, vertexadjacency_t &ret);
+
+enum VertexNormalWeighting {
+  kVertexNormalWeightArea,   // By the area of each triangle.
+  kVertexNormalWeightAngle,  // By the angle of each triangle at the vertex.
+};
+
+//! Computes smooth unit normals for vertices [`first_vertex`, `first_vertex`
+//! + `vertex_count`) of an indexed mesh by summing the weighted normals of the
+//! triangles around each vertex. `face_normals` are the unnormalized normals
+//! from ComputeFaceNormals. Vertices without triangles, or whose triangles
+//! cancel out, get a zero normal.
+//!
+//! Each vertex gathers from its own triangles, so calls for disjoint vertex
+//! ranges may run concurrently, e.g. one range per worker thread.
+//! Angle weighting gives results independent of how faces are triangulated.
+void ComputeVertexNormals(const vertex_t *vertices, const uint32_t *indices,
+                          const vector_t *face_normals,
+                          const vertexadjacency_t &adjacency,
+                          VertexNormalWeighting weighting,
+                          uint32_t first_vertex, uint32_t vertex_count,
+                          vector_t *normals);
+
+//! Computes packed tangent frames for vertices [`first_vertex`, `first_vertex`
+//! + `vertex_count`) of an indexed mesh from its positions and texture
+//! coordinates, summing each vertex's triangles' tangents and bitangents in a
+//! single pass. `normals` are the mesh's unit vertex normals, e.g. from
+//! ComputeVertexNormals.
+//!
+//! Each tangent is the unit direction of increasing u, stored in xyz. If
+//! `orthogonalize` is true, it is first made perpendicular to the normal with
+//! a Gram-Schmidt step. w holds the handedness, 1 or -1, from which the
+//! bitangent is recovered as w * (normal x tangent). Triangles with
+//! degenerate texture coordinates contribute nothing, and vertices left
+//! without a tangent get a zero one.
+//!
+//! As with ComputeVertexNormals, calls for disjoint vertex ranges may run
+//! concurrently.
+void ComputeVertexTangents(const vertex_t *vertices,
+                           const texcoord_t *texcoords,
+                           const uint32_t *indices, const vector_t *normals,
+                           const vertexadjacency_t &adjacency,
+                           bool orthogonalize, uint32_t first_vertex,
+                           uint32_t vertex_count, vector_t *tangents);
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_MESH_H_
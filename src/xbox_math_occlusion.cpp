@@ -0,0 +1,416 @@
+#include "xbox_math_occlusion.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_simd.h"
+#include "xbox_math_util.h"
+
+namespace XboxMath {
+
+static constexpr uint32_t kTilePixels =
+    COcclusionBuffer::kTileWidth * COcclusionBuffer::kTileHeight;
+
+// Triangles with a smaller screen space area cover no pixels.
+static constexpr float kMinTriangleArea = 1e-6f;
+
+// Transforms `point` by the rows of a matrix loaded into `rows`.
+static inline void TransformPoint(const Simd::float4 (&rows)[4],
+                                  const float *point, float (&ret)[4]) {
+  using namespace Simd;
+  float4 result = MulAdd(Set1(point[0]), rows[0], rows[3]);
+  result = MulAdd(Set1(point[1]), rows[1], result);
+  result = MulAdd(Set1(point[2]), rows[2], result);
+  StoreUnaligned(ret, result);
+}
+
+// Whether BoundingSphereScreenRectsPerspective applies: `view` must be rigid
+// and `projection` shaped like those of CreateD3DPerspectiveFOVLH.
+static bool SuitsExactSphereRects(const matrix4_t &view,
+                                  const matrix4_t &projection) {
+  static constexpr float kRigidTolerance = 1e-4f;
+  for (uint32_t i = 0; i < 3; ++i) {
+    for (uint32_t j = 0; j < 3; ++j) {
+      const float dot = view[i][0] * view[j][0] + view[i][1] * view[j][1] +
+                        view[i][2] * view[j][2];
+      if (fabsf(dot - (i == j ? 1.f : 0.f)) > kRigidTolerance) {
+        return false;
+      }
+    }
+  }
+  return projection[0][1] == 0.f && projection[0][2] == 0.f &&
+         projection[0][3] == 0.f && projection[1][0] == 0.f &&
+         projection[1][2] == 0.f && projection[1][3] == 0.f &&
+         projection[2][0] == 0.f && projection[2][1] == 0.f &&
+         projection[2][3] == 1.f && projection[3][0] == 0.f &&
+         projection[3][1] == 0.f && projection[3][3] == 0.f &&
+         projection[2][2] > 0.f && projection[3][2] < 0.f;
+}
+
+static inline void LoadRows(const matrix4_t &matrix, Simd::float4 (&ret)[4]) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    ret[i] = Simd::LoadUnaligned(matrix[i]);
+  }
+}
+
+COcclusionBuffer::COcclusionBuffer(uint32_t width, uint32_t height)
+    : m_width(width),
+      m_height(height),
+      m_tilesX((width + kTileWidth - 1) / kTileWidth),
+      m_tilesY((height + kTileHeight - 1) / kTileHeight),
+      m_exactSphereRects(false) {
+  m_depth.resize(static_cast<size_t>(GetTileCount()) * kTilePixels);
+  m_tileMax.resize(GetTileCount());
+  m_tileTriangles.resize(GetTileCount());
+  MatrixSetIdentity(m_composite);
+  MatrixSetIdentity(m_view);
+  MatrixSetIdentity(m_projection);
+  MatrixSetIdentity(m_viewport);
+  Clear();
+}
+
+void COcclusionBuffer::SetViewProjection(const matrix4_t &view,
+                                         const matrix4_t &projection) {
+  MatrixCopyMatrix(m_view, view);
+  MatrixCopyMatrix(m_projection, projection);
+  CreateD3DViewport(m_viewport, static_cast<float>(m_width),
+                    static_cast<float>(m_height), 1.f, 0.f, 1.f);
+  matrix4_t projection_viewport;
+  MatrixMultMatrix(projection, m_viewport, projection_viewport);
+  BuildCompositeMatrix(view, projection_viewport, m_composite);
+  m_exactSphereRects = SuitsExactSphereRects(view, projection);
+  Clear();
+}
+
+void COcclusionBuffer::Clear() {
+  m_triangles.clear();
+  for (auto &triangles : m_tileTriangles) {
+    triangles.clear();
+  }
+
+  // Pixels outside the buffer are set to the near plane so they never raise a
+  // tile's maximum depth.
+  for (uint32_t tile = 0; tile < GetTileCount(); ++tile) {
+    const uint32_t tile_x = (tile % m_tilesX) * kTileWidth;
+    const uint32_t tile_y = (tile / m_tilesX) * kTileHeight;
+    float *depth = &m_depth[static_cast<size_t>(tile) * kTilePixels];
+    for (uint32_t y = 0; y < kTileHeight; ++y) {
+      for (uint32_t x = 0; x < kTileWidth; ++x) {
+        const bool inside = tile_x + x < m_width && tile_y + y < m_height;
+        depth[y * kTileWidth + x] = inside ? 1.f : 0.f;
+      }
+    }
+    m_tileMax[tile] = 1.f;
+  }
+}
+
+bool COcclusionBuffer::AddOccluders(const vertex_t *vertices,
+                                    uint32_t vertex_count,
+                                    const uint32_t *indices,
+                                    uint32_t triangle_count) {
+  for (uint32_t i = 0; i < triangle_count * 3; ++i) {
+    if (indices[i] >= vertex_count) {
+      return false;
+    }
+  }
+
+  Simd::float4 rows[4];
+  LoadRows(m_composite, rows);
+  m_clipVertices.resize(static_cast<size_t>(vertex_count) * 4);
+  float(*clip)[4] = reinterpret_cast<float(*)[4]>(m_clipVertices.data());
+  for (uint32_t i = 0; i < vertex_count; ++i) {
+    TransformPoint(rows, vertices[i], clip[i]);
+  }
+
+  for (uint32_t triangle = 0; triangle < triangle_count; ++triangle) {
+    const float *input[3] = {clip[indices[triangle * 3]],
+                             clip[indices[triangle * 3 + 1]],
+                             clip[indices[triangle * 3 + 2]]};
+
+    // Clip against the near plane (z >= 0 in clip space), which turns the
+    // triangle into a polygon of up to four vertices.
+    float polygon[4][4];
+    uint32_t polygon_count = 0;
+    for (uint32_t i = 0; i < 3; ++i) {
+      const float *p = input[i];
+      const float *q = input[(i + 1) % 3];
+      if (p[2] >= 0.f) {
+        std::copy(p, p + 4, polygon[polygon_count++]);
+      }
+      if ((p[2] >= 0.f) != (q[2] >= 0.f)) {
+        const float t = p[2] / (p[2] - q[2]);
+        for (uint32_t c = 0; c < 4; ++c) {
+          polygon[polygon_count][c] = p[c] + t * (q[c] - p[c]);
+        }
+        ++polygon_count;
+      }
+    }
+    if (polygon_count < 3) {
+      continue;
+    }
+
+    float screen[4][3];
+    for (uint32_t i = 0; i < polygon_count; ++i) {
+      const float inv_w = 1.f / polygon[i][3];
+      screen[i][0] = polygon[i][0] * inv_w;
+      screen[i][1] = polygon[i][1] * inv_w;
+      screen[i][2] = polygon[i][2] * inv_w;
+    }
+    for (uint32_t i = 2; i < polygon_count; ++i) {
+      AddScreenTriangle(screen[0], screen[i - 1], screen[i]);
+    }
+  }
+  return true;
+}
+
+void COcclusionBuffer::AddScreenTriangle(const float (&a)[3],
+                                         const float (&b)[3],
+                                         const float (&c)[3]) {
+  const float ab_x = b[0] - a[0], ab_y = b[1] - a[1];
+  const float ac_x = c[0] - a[0], ac_y = c[1] - a[1];
+  const float area = ab_x * ac_y - ac_x * ab_y;
+  if (fabsf(area) < kMinTriangleArea) {
+    return;
+  }
+
+  occludertriangle_t triangle;
+  const float min_x = std::min({a[0], b[0], c[0]});
+  const float min_y = std::min({a[1], b[1], c[1]});
+  const float max_x = std::max({a[0], b[0], c[0]});
+  const float max_y = std::max({a[1], b[1], c[1]});
+  if (max_x < 0.f || max_y < 0.f || min_x >= static_cast<float>(m_width) ||
+      min_y >= static_cast<float>(m_height)) {
+    return;
+  }
+  triangle.m_minX = static_cast<int32_t>(std::max(0.f, floorf(min_x)));
+  triangle.m_minY = static_cast<int32_t>(std::max(0.f, floorf(min_y)));
+  triangle.m_maxX = static_cast<int32_t>(
+      std::min(static_cast<float>(m_width - 1), floorf(max_x)));
+  triangle.m_maxY = static_cast<int32_t>(
+      std::min(static_cast<float>(m_height - 1), floorf(max_y)));
+
+  // Edge functions are positive inside the triangle. Pixels are covered when
+  // their center is inside or on an edge, so triangles sharing an edge leave
+  // no gaps.
+  const float sign = area > 0.f ? 1.f : -1.f;
+  const float *vertices[3] = {a, b, c};
+  for (uint32_t i = 0; i < 3; ++i) {
+    const float *p = vertices[i];
+    const float *q = vertices[(i + 1) % 3];
+    triangle.m_edges[i][0] = sign * (p[1] - q[1]);
+    triangle.m_edges[i][1] = sign * (q[0] - p[0]);
+    triangle.m_edges[i][2] = sign * (p[0] * q[1] - p[1] * q[0]);
+  }
+
+  // The depth plane, moved back to the farthest depth within a pixel.
+  const float ab_z = b[2] - a[2], ac_z = c[2] - a[2];
+  const float depth_a = (ab_z * ac_y - ac_z * ab_y) / area;
+  const float depth_b = (ac_z * ab_x - ab_z * ac_x) / area;
+  triangle.m_depth[0] = depth_a;
+  triangle.m_depth[1] = depth_b;
+  triangle.m_depth[2] = a[2] - depth_a * a[0] - depth_b * a[1] +
+                        0.5f * (fabsf(depth_a) + fabsf(depth_b));
+
+  const auto index = static_cast<uint32_t>(m_triangles.size());
+  m_triangles.push_back(triangle);
+  const uint32_t first_tile_x = triangle.m_minX / kTileWidth;
+  const uint32_t last_tile_x = triangle.m_maxX / kTileWidth;
+  const uint32_t first_tile_y = triangle.m_minY / kTileHeight;
+  const uint32_t last_tile_y = triangle.m_maxY / kTileHeight;
+  for (uint32_t tile_y = first_tile_y; tile_y <= last_tile_y; ++tile_y) {
+    for (uint32_t tile_x = first_tile_x; tile_x <= last_tile_x; ++tile_x) {
+      m_tileTriangles[tile_y * m_tilesX + tile_x].push_back(index);
+    }
+  }
+}
+
+void COcclusionBuffer::RasterizeTiles(uint32_t first_tile,
+                                      uint32_t tile_count) {
+  const uint32_t last_tile = std::min(first_tile + tile_count, GetTileCount());
+  for (uint32_t tile = first_tile; tile < last_tile; ++tile) {
+    RasterizeTile(tile);
+  }
+}
+
+void COcclusionBuffer::RasterizeTile(uint32_t tile) {
+  using namespace Simd;
+  const int32_t tile_x = static_cast<int32_t>((tile % m_tilesX) * kTileWidth);
+  const int32_t tile_y = static_cast<int32_t>((tile / m_tilesX) * kTileHeight);
+  float *depth = &m_depth[static_cast<size_t>(tile) * kTilePixels];
+  const float4 lane_offsets = Set(0.5f, 1.5f, 2.5f, 3.5f);
+  const float4 zero = Zero();
+
+  for (uint32_t index : m_tileTriangles[tile]) {
+    const occludertriangle_t &triangle = m_triangles[index];
+    // Blocks start on multiples of 4 pixels; the edge functions reject the
+    // pixels outside the triangle's bounds.
+    const int32_t min_x = std::max(triangle.m_minX, tile_x) & ~3;
+    const int32_t max_x = std::min(
+        triangle.m_maxX, tile_x + static_cast<int32_t>(kTileWidth) - 1);
+    const int32_t min_y = std::max(triangle.m_minY, tile_y);
+    const int32_t max_y = std::min(
+        triangle.m_maxY, tile_y + static_cast<int32_t>(kTileHeight) - 1);
+
+    float4 start[4], step[4];
+    const float *planes[4] = {triangle.m_edges[0], triangle.m_edges[1],
+                              triangle.m_edges[2], triangle.m_depth};
+    const float4 block_x = Add(Set1(static_cast<float>(min_x)), lane_offsets);
+    for (uint32_t i = 0; i < 4; ++i) {
+      start[i] = MulAdd(Set1(planes[i][0]), block_x, Set1(planes[i][2]));
+      step[i] = Set1(4.f * planes[i][0]);
+    }
+
+    for (int32_t y = min_y; y <= max_y; ++y) {
+      const float4 center_y = Set1(static_cast<float>(y) + 0.5f);
+      float4 values[4];
+      for (uint32_t i = 0; i < 4; ++i) {
+        values[i] = MulAdd(Set1(planes[i][1]), center_y, start[i]);
+      }
+
+      float *row = depth + (y - tile_y) * kTileWidth;
+      for (int32_t x = min_x; x <= max_x; x += 4) {
+        const float4 inside = And(And(CmpGe(values[0], zero),
+                                      CmpGe(values[1], zero)),
+                                  CmpGe(values[2], zero));
+        if (MoveMask(inside)) {
+          const float4 stored = LoadUnaligned(row + x - tile_x);
+          StoreUnaligned(row + x - tile_x,
+                         Select(inside, Min(stored, values[3]), stored));
+        }
+        for (uint32_t i = 0; i < 4; ++i) {
+          values[i] = Add(values[i], step[i]);
+        }
+      }
+    }
+  }
+
+  float4 tile_max = LoadUnaligned(depth);
+  for (uint32_t i = 4; i < kTilePixels; i += 4) {
+    tile_max = Max(tile_max, LoadUnaligned(depth + i));
+  }
+  float lanes[4];
+  StoreUnaligned(lanes, tile_max);
+  m_tileMax[tile] = std::max(std::max(lanes[0], lanes[1]),
+                             std::max(lanes[2], lanes[3]));
+}
+
+bool COcclusionBuffer::IsScreenRectOccluded(const screenrect_t &rect) const {
+  using namespace Simd;
+  if (rect.m_maxX < 0.f || rect.m_maxY < 0.f ||
+      rect.m_minX >= static_cast<float>(m_width) ||
+      rect.m_minY >= static_cast<float>(m_height)) {
+    return false;
+  }
+  const float min_x = rect.m_minX, min_y = rect.m_minY;
+  const float max_x = rect.m_maxX, max_y = rect.m_maxY;
+  const float min_z = rect.m_minZ;
+
+  // Occluders cover pixels by their centers, so a pixel may be partially
+  // uncovered. Testing the pixels around the box as well accounts for that.
+  const auto first_x =
+      static_cast<int32_t>(std::max(0.f, floorf(min_x) - 1.f));
+  const auto first_y =
+      static_cast<int32_t>(std::max(0.f, floorf(min_y) - 1.f));
+  const auto last_x = static_cast<int32_t>(
+      std::min(static_cast<float>(m_width - 1), floorf(max_x) + 1.f));
+  const auto last_y = static_cast<int32_t>(
+      std::min(static_cast<float>(m_height - 1), floorf(max_y) + 1.f));
+
+  const float4 box_depth = Set1(min_z);
+  const float4 lane_offsets = Set(0.f, 1.f, 2.f, 3.f);
+  const float4 first_x4 = Set1(static_cast<float>(first_x));
+  const float4 last_x4 = Set1(static_cast<float>(last_x));
+
+  for (int32_t tile_y = first_y / kTileHeight;
+       tile_y <= last_y / static_cast<int32_t>(kTileHeight); ++tile_y) {
+    for (int32_t tile_x = first_x / kTileWidth;
+         tile_x <= last_x / static_cast<int32_t>(kTileWidth); ++tile_x) {
+      const uint32_t tile = tile_y * m_tilesX + tile_x;
+      if (min_z > m_tileMax[tile]) {
+        continue;  // Everything in the tile is in front of the box.
+      }
+
+      const int32_t origin_x = tile_x * kTileWidth;
+      const int32_t origin_y = tile_y * kTileHeight;
+      const float *depth = &m_depth[static_cast<size_t>(tile) * kTilePixels];
+      const int32_t x0 = std::max(first_x, origin_x) & ~3;
+      const int32_t x1 =
+          std::min(last_x, origin_x + static_cast<int32_t>(kTileWidth) - 1);
+      const int32_t y0 = std::max(first_y, origin_y);
+      const int32_t y1 =
+          std::min(last_y, origin_y + static_cast<int32_t>(kTileHeight) - 1);
+      for (int32_t y = y0; y <= y1; ++y) {
+        const float *row = depth + (y - origin_y) * kTileWidth;
+        for (int32_t x = x0; x <= x1; x += 4) {
+          const float4 pixel_x = Add(Set1(static_cast<float>(x)), lane_offsets);
+          const float4 in_rect =
+              And(CmpGe(pixel_x, first_x4), CmpLe(pixel_x, last_x4));
+          const float4 visible =
+              CmpGe(LoadUnaligned(row + x - origin_x), box_depth);
+          if (MoveMask(And(in_rect, visible))) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void COcclusionBuffer::SphereScreenRects(const boundingsphere_t *spheres,
+                                         uint32_t count,
+                                         screenrect_t *rects) const {
+  if (m_exactSphereRects) {
+    // Spheres crossing the near plane get a nearest depth of 0, and spheres
+    // behind it an empty rect, neither of which is ever occluded.
+    BoundingSphereScreenRectsPerspective(spheres, count, m_view, m_projection,
+                                         m_viewport, rects);
+    return;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    // Volumes crossing the near plane project to negative depths, which are
+    // never occluded either.
+    if (!BoundingSphereScreenRect(spheres[i], m_composite, rects[i])) {
+      rects[i] = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX};
+    }
+  }
+}
+
+bool COcclusionBuffer::IsSphereOccluded(const boundingsphere_t &sphere) const {
+  screenrect_t rect;
+  SphereScreenRects(&sphere, 1, &rect);
+  return IsScreenRectOccluded(rect);
+}
+
+bool COcclusionBuffer::IsAABBOccluded(const aabb_t &box) const {
+  screenrect_t rect;
+  return BoundingBoxScreenRect(box, m_composite, rect) &&
+         IsScreenRectOccluded(rect);
+}
+
+uint32_t COcclusionBuffer::TestSpheres(const boundingsphere_t *spheres,
+                                       uint32_t count, bool *occluded) const {
+  static constexpr uint32_t kBatchSize = 64;
+  screenrect_t rects[kBatchSize];
+  uint32_t ret = 0;
+  for (uint32_t first = 0; first < count; first += kBatchSize) {
+    const uint32_t batch = std::min(kBatchSize, count - first);
+    SphereScreenRects(spheres + first, batch, rects);
+    for (uint32_t i = 0; i < batch; ++i) {
+      occluded[first + i] = IsScreenRectOccluded(rects[i]);
+      ret += occluded[first + i] ? 1 : 0;
+    }
+  }
+  return ret;
+}
+
+float COcclusionBuffer::GetDepth(uint32_t x, uint32_t y) const {
+  const uint32_t tile = (y / kTileHeight) * m_tilesX + x / kTileWidth;
+  return m_depth[static_cast<size_t>(tile) * kTilePixels +
+                 (y % kTileHeight) * kTileWidth + x % kTileWidth];
+}
+
+}  // namespace XboxMath
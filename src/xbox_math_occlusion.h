@@ -0,0 +1,127 @@
+#ifndef XBOX_MATH_OCCLUSION_H_
+#define XBOX_MATH_OCCLUSION_H_
+
+#include <vector>
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! A low resolution software depth buffer for occlusion culling.
+//!
+//! Each frame, occluder triangles are added with AddOccluders, which projects,
+//! near plane clips and bins them into tiles. The tiles are then rasterized
+//! with RasterizeTiles, which may be called concurrently for disjoint tile
+//! ranges (e.g., one range per worker thread). Finally, bounding volumes are
+//! tested against the buffer with the Is*Occluded functions.
+//!
+//! Tests are conservative: occluders write the farthest depth they reach within
+//! each pixel whose center they cover, and bounding volumes are only reported
+//! as occluded when every pixel they touch, plus a one pixel border for
+//! partially covered pixels, is closer than them. Gaps between occluders
+//! narrower than a pixel may still be treated as closed.
+class COcclusionBuffer {
+ public:
+  static constexpr uint32_t kTileWidth = 32;
+  static constexpr uint32_t kTileHeight = 16;
+
+  //! Creates a buffer of `width` x `height` pixels. The viewport used for
+  //! projection is created with CreateD3DViewport for the same dimensions and
+  //! a [0, 1] depth range.
+  COcclusionBuffer(uint32_t width, uint32_t height);
+
+  [[nodiscard]] uint32_t GetWidth() const { return m_width; }
+  [[nodiscard]] uint32_t GetHeight() const { return m_height; }
+  [[nodiscard]] uint32_t GetTileCount() const {
+    return m_tilesX * m_tilesY;
+  }
+
+  //! Sets the camera used to project occluders and occludees, and clears the
+  //! buffer. With a rigid `view` (e.g., from CreateD3DLookAtLH) and a
+  //! perspective `projection` from CreateD3DPerspectiveFOVLH, spheres are
+  //! bounded by their exact screen rects (BoundingSphereScreenRectsPerspective)
+  //! rather than by projecting the corners of their bounding boxes.
+  void SetViewProjection(const matrix4_t &view, const matrix4_t &projection);
+
+  //! Removes all occluders and resets every pixel to the far plane.
+  void Clear();
+
+  //! Projects `triangle_count` world space triangles, whose vertex indices are
+  //! stored consecutively in `indices`, and bins them into the tiles they
+  //! overlap. Triangles are double sided.
+  //! \return false if an index is out of range, in which case nothing is added.
+  bool AddOccluders(const vertex_t *vertices, uint32_t vertex_count,
+                    const uint32_t *indices, uint32_t triangle_count);
+
+  //! Rasterizes the binned occluders into tiles [`first_tile`, `first_tile` +
+  //! `tile_count`). Calls for disjoint ranges may run concurrently, but not
+  //! concurrently with any other member function.
+  void RasterizeTiles(uint32_t first_tile, uint32_t tile_count);
+
+  //! Rasterizes every tile on the calling thread.
+  void Rasterize() { RasterizeTiles(0, GetTileCount()); }
+
+  //! \return true if `sphere` is hidden behind the rasterized occluders.
+  //! Volumes that cross the near plane or lie outside the buffer are never
+  //! reported as occluded; frustum culling is expected to handle the latter.
+  [[nodiscard]] bool IsSphereOccluded(const boundingsphere_t &sphere) const;
+  [[nodiscard]] bool IsAABBOccluded(const aabb_t &box) const;
+
+  //! \return true if the screen space `rect`, computed with this buffer's
+  //! projection (e.g., by BoundingBoxScreenRect with GetComposite()), is
+  //! hidden.
+  [[nodiscard]] bool IsScreenRectOccluded(const screenrect_t &rect) const;
+
+  //! Returns view * projection * viewport for the current camera.
+  [[nodiscard]] const matrix4_t &GetComposite() const { return m_composite; }
+
+  //! Tests `count` spheres, setting `occluded[i]` for each of them. Exact
+  //! sphere rects are computed four spheres at a time.
+  //! \return the number of occluded spheres.
+  uint32_t TestSpheres(const boundingsphere_t *spheres, uint32_t count,
+                       bool *occluded) const;
+
+  //! Returns the depth stored for pixel (`x`, `y`), 1 if nothing covers it.
+  [[nodiscard]] float GetDepth(uint32_t x, uint32_t y) const;
+
+ private:
+  // A screen space triangle set up for rasterization. Each edge function and
+  // the depth plane are evaluated as a * x + b * y + c at pixel centers.
+  typedef struct occludertriangle_t {
+    float m_edges[3][3];
+    float m_depth[3];
+    int32_t m_minX;
+    int32_t m_minY;
+    int32_t m_maxX;
+    int32_t m_maxY;
+  } occludertriangle_t;
+
+  // Computes the screen rects of `count` spheres.
+  void SphereScreenRects(const boundingsphere_t *spheres, uint32_t count,
+                         screenrect_t *rects) const;
+  void AddScreenTriangle(const float (&a)[3], const float (&b)[3],
+                         const float (&c)[3]);
+  void RasterizeTile(uint32_t tile);
+
+  uint32_t m_width;
+  uint32_t m_height;
+  uint32_t m_tilesX;
+  uint32_t m_tilesY;
+  matrix4_t m_composite;
+  // The factors of m_composite, for BoundingSphereScreenRectsPerspective.
+  matrix4_t m_view;
+  matrix4_t m_projection;
+  matrix4_t m_viewport;
+  // Whether the camera suits BoundingSphereScreenRectsPerspective.
+  bool m_exactSphereRects;
+
+  std::vector<float> m_depth;    // Tile by tile, rows within a tile.
+  std::vector<float> m_tileMax;  // Farthest depth stored in each tile.
+  std::vector<occludertriangle_t> m_triangles;
+  std::vector<std::vector<uint32_t>> m_tileTriangles;
+  std::vector<float> m_clipVertices;  // Scratch space for AddOccluders.
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_OCCLUSION_H_
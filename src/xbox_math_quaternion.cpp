@@ -1,13 +1,20 @@
 #include "xbox_math_quaternion.h"
 
 #include <cassert>
+#include <cstring>
 
+#include "xbox_math_fast_math.h"
 #include "xbox_math_matrix.h"
+#include "xbox_math_simd.h"
 
 #define DEG2RAD(c) ((float)(c) * (float)M_PI / 180.0f)
 
 namespace XboxMath {
 
+// The batch conversions write quaternions as packed float quads.
+static_assert(sizeof(CQuaternion) == 4 * sizeof(float),
+              "CQuaternion must consist of exactly four floats");
+
 CQuaternion::CQuaternion() : x(0), y(0), z(0), w(1) {}
 
 CQuaternion::CQuaternion(float xI, float yI, float zI, float wI)
@@ -15,9 +22,11 @@ CQuaternion::CQuaternion(float xI, float yI, float zI, float wI)
 
 CQuaternion::CQuaternion(const vector_t &axis, float angle) {
   float d = VectorLength(axis);
-  float s = sinf(DEG2RAD(angle) * 0.5f) / d;
+  float sin_half, cos_half;
+  TrigSinCos(DEG2RAD(angle) * 0.5f, sin_half, cos_half);
+  float s = sin_half / d;
 
-  SetValues(axis[0] * s, axis[1] * s, axis[2] * s, cosf(DEG2RAD(angle) * 0.5f));
+  SetValues(axis[0] * s, axis[1] * s, axis[2] * s, cos_half);
 }
 
 CQuaternion::CQuaternion(float yaw, float pitch, float roll) {
@@ -124,18 +133,15 @@ CQuaternion &CQuaternion::SetEuler(float yaw, float pitch, float roll) {
   float rRad = DEG2RAD(roll) / 2.0f;
 
   if (yRad != 0.0f) {
-    cosY = cosf(yRad);
-    sinY = sinf(yRad);
+    TrigSinCos(yRad, sinY, cosY);
   }
 
   if (pRad != 0.0f) {
-    cosP = cosf(pRad);
-    sinP = sinf(pRad);
+    TrigSinCos(pRad, sinP, cosP);
   }
 
   if (rRad != 0.0f) {
-    cosR = cosf(rRad);
-    sinR = sinf(rRad);
+    TrigSinCos(rRad, sinR, cosR);
   }
 
   SetValues(cosR * sinP * cosY + sinR * cosP * sinY,
@@ -146,6 +152,28 @@ CQuaternion &CQuaternion::SetEuler(float yaw, float pitch, float roll) {
   return *this;
 }
 
+CQuaternion Slerp(const CQuaternion &from, const CQuaternion &to,
+                  float interp) {
+  float omega, cosO, sinO;
+  float scale0, scale1;
+
+  cosO = QuaternionDotQuaternion(from, to);
+
+  if (cosO < 0.0) cosO = -cosO;
+
+  if ((1.0 - cosO) > SLERP_ERROR_TOLERANCE) {
+    omega = TrigAcos(cosO);
+    sinO = TrigSin(omega);
+    scale0 = TrigSin((1.0F - interp) * omega) / sinO;
+    scale1 = TrigSin(interp * omega) / sinO;
+  } else {
+    scale0 = 1.0f - interp;
+    scale1 = interp;
+  }
+
+  return (scale0 * from) + (scale1 * -to);
+}
+
 void CQuaternion::GetMatrix(matrix4_t &ret) const {
   MatrixSetRowVector(ret, 1.0f - 2.0f * (y * y) - 2.0f * (z * z),
                      2.0f * (x * y + w * z), 2.0f * (x * z - w * y), 0, 0);
@@ -160,4 +188,141 @@ void CQuaternion::GetMatrix(matrix4_t &ret) const {
   MatrixSetRowVector(ret, 0, 0, 0, 1, 3);
 }
 
+// Converts four Euler rotations to quaternions, writing 16 floats to `out`.
+static inline void EulerToQuaternionBlock(const vector_t *euler,
+                                          Simd::float4 half_angle_scale,
+                                          float *out) {
+  using namespace Simd;
+  float4 yaw = LoadUnaligned(euler[0]);
+  float4 pitch = LoadUnaligned(euler[1]);
+  float4 roll = LoadUnaligned(euler[2]);
+  float4 unused = LoadUnaligned(euler[3]);
+  Transpose(yaw, pitch, roll, unused);
+
+  float4 sin_y, cos_y, sin_p, cos_p, sin_r, cos_r;
+  FastSinCos(Mul(yaw, half_angle_scale), sin_y, cos_y);
+  FastSinCos(Mul(pitch, half_angle_scale), sin_p, cos_p);
+  FastSinCos(Mul(roll, half_angle_scale), sin_r, cos_r);
+
+  const float4 cos_p_cos_y = Mul(cos_p, cos_y);
+  const float4 cos_p_sin_y = Mul(cos_p, sin_y);
+  const float4 sin_p_cos_y = Mul(sin_p, cos_y);
+  const float4 sin_p_sin_y = Mul(sin_p, sin_y);
+
+  float4 x = Add(Mul(cos_r, sin_p_cos_y), Mul(sin_r, cos_p_sin_y));
+  float4 y = Sub(Mul(cos_r, cos_p_sin_y), Mul(sin_r, sin_p_cos_y));
+  float4 z = Sub(Mul(sin_r, cos_p_cos_y), Mul(cos_r, sin_p_sin_y));
+  float4 w = Add(Mul(cos_r, cos_p_cos_y), Mul(sin_r, sin_p_sin_y));
+
+  Transpose(x, y, z, w);
+  StoreUnaligned(out, x);
+  StoreUnaligned(out + 4, y);
+  StoreUnaligned(out + 8, z);
+  StoreUnaligned(out + 12, w);
+}
+
+// Converts four axis-angle rotations to quaternions, writing 16 floats to
+// `out`.
+static inline void AxisAngleToQuaternionBlock(const vector_t *axes,
+                                              const float *angles,
+                                              Simd::float4 half_angle_scale,
+                                              float *out) {
+  using namespace Simd;
+  float4 x = LoadUnaligned(axes[0]);
+  float4 y = LoadUnaligned(axes[1]);
+  float4 z = LoadUnaligned(axes[2]);
+  float4 w = LoadUnaligned(axes[3]);
+  Transpose(x, y, z, w);
+
+  float4 sin_half, cos_half;
+  FastSinCos(Mul(LoadUnaligned(angles), half_angle_scale), sin_half, cos_half);
+
+  const float4 length = Sqrt(Add(Add(Mul(x, x), Mul(y, y)), Mul(z, z)));
+  const float4 scale = Div(sin_half, length);
+  x = Mul(x, scale);
+  y = Mul(y, scale);
+  z = Mul(z, scale);
+  w = cos_half;
+
+  Transpose(x, y, z, w);
+  StoreUnaligned(out, x);
+  StoreUnaligned(out + 4, y);
+  StoreUnaligned(out + 8, z);
+  StoreUnaligned(out + 12, w);
+}
+
+static void EulerToQuaternions(const vector_t *euler, uint32_t count,
+                               float half_angle_scale, CQuaternion *ret) {
+  const Simd::float4 scale = Simd::Set1(half_angle_scale);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    EulerToQuaternionBlock(euler + i, scale,
+                           reinterpret_cast<float *>(ret + i));
+  }
+
+  const uint32_t remainder = count - i;
+  if (remainder) {
+    vector_t padded[4] = {};
+    memcpy(padded, euler + i, remainder * sizeof(vector_t));
+    CQuaternion block[4];
+    EulerToQuaternionBlock(padded, scale, reinterpret_cast<float *>(block));
+    for (uint32_t j = 0; j < remainder; ++j) {
+      ret[i + j] = block[j];
+    }
+  }
+}
+
+static void AxisAngleToQuaternions(const vector_t *axes, const float *angles,
+                                   uint32_t count, float half_angle_scale,
+                                   CQuaternion *ret) {
+  const Simd::float4 scale = Simd::Set1(half_angle_scale);
+
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    AxisAngleToQuaternionBlock(axes + i, angles + i, scale,
+                               reinterpret_cast<float *>(ret + i));
+  }
+
+  const uint32_t remainder = count - i;
+  if (remainder) {
+    // Pad with a valid axis to avoid dividing by zero in unused lanes.
+    vector_t padded_axes[4] = {
+        {1.f, 0.f, 0.f, 1.f},
+        {1.f, 0.f, 0.f, 1.f},
+        {1.f, 0.f, 0.f, 1.f},
+        {1.f, 0.f, 0.f, 1.f},
+    };
+    float padded_angles[4] = {};
+    memcpy(padded_axes, axes + i, remainder * sizeof(vector_t));
+    memcpy(padded_angles, angles + i, remainder * sizeof(float));
+    CQuaternion block[4];
+    AxisAngleToQuaternionBlock(padded_axes, padded_angles, scale,
+                               reinterpret_cast<float *>(block));
+    for (uint32_t j = 0; j < remainder; ++j) {
+      ret[i + j] = block[j];
+    }
+  }
+}
+
+void QuaternionsFromEuler(const vector_t *euler, uint32_t count,
+                          CQuaternion *ret) {
+  EulerToQuaternions(euler, count, 0.5f, ret);
+}
+
+void QuaternionsFromEulerDegrees(const vector_t *euler, uint32_t count,
+                                 CQuaternion *ret) {
+  EulerToQuaternions(euler, count, DEG2RAD(0.5f), ret);
+}
+
+void QuaternionsFromAxisAngle(const vector_t *axes, const float *angles,
+                              uint32_t count, CQuaternion *ret) {
+  AxisAngleToQuaternions(axes, angles, count, 0.5f, ret);
+}
+
+void QuaternionsFromAxisAngleDegrees(const vector_t *axes, const float *angles,
+                                     uint32_t count, CQuaternion *ret) {
+  AxisAngleToQuaternions(axes, angles, count, DEG2RAD(0.5f), ret);
+}
+
 }  // namespace XboxMath
@@ -54,27 +54,28 @@ inline float QuaternionDotQuaternion(const CQuaternion &a,
   return ((a[0] * b[0]) + (a[1] * b[1]) + (a[2] * b[2]) + (a[3] * b[3]));
 }
 
-inline CQuaternion Slerp(const CQuaternion &from, const CQuaternion &to,
-                         float interp) {
-  float omega, cosO, sinO;
-  float scale0, scale1;
-
-  cosO = QuaternionDotQuaternion(from, to);
-
-  if (cosO < 0.0) cosO = -cosO;
-
-  if ((1.0 - cosO) > SLERP_ERROR_TOLERANCE) {
-    omega = (float)acos(cosO);
-    sinO = sinf(omega);
-    scale0 = sinf((1.0F - interp) * omega) / sinO;
-    scale1 = sinf(interp * omega) / sinO;
-  } else {
-    scale0 = 1.0f - interp;
-    scale1 = interp;
-  }
-
-  return (scale0 * from) + (scale1 * -to);
-}
+CQuaternion Slerp(const CQuaternion &from, const CQuaternion &to,
+                  float interp);
+
+//! Converts `count` Euler rotations into quaternions using the same axis
+//! convention as CQuaternion::SetEuler. `euler[i][0]`, `euler[i][1]` and
+//! `euler[i][2]` hold the yaw, pitch and roll in radians.
+void QuaternionsFromEuler(const vector_t *euler, uint32_t count,
+                          CQuaternion *ret);
+
+//! As QuaternionsFromEuler, with the angles given in degrees.
+void QuaternionsFromEulerDegrees(const vector_t *euler, uint32_t count,
+                                 CQuaternion *ret);
+
+//! Converts `count` rotations of `angles[i]` radians about `axes[i]` into
+//! quaternions. Axes need not be normalized.
+void QuaternionsFromAxisAngle(const vector_t *axes, const float *angles,
+                              uint32_t count, CQuaternion *ret);
+
+//! As QuaternionsFromAxisAngle, with the angles given in degrees (matching
+//! the CQuaternion(axis, angle) constructor).
+void QuaternionsFromAxisAngleDegrees(const vector_t *axes, const float *angles,
+                                     uint32_t count, CQuaternion *ret);
 
 }  // namespace XboxMath
 
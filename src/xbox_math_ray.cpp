@@ -0,0 +1,474 @@
+#include "xbox_math_ray.h"
+
+#include <cstddef>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+// Homogeneous x, y, z and w coordinates of four unprojected points.
+typedef Simd::float4 homogeneous4_t[4];
+
+// Determinants below this are treated as rays parallel to the triangle.
+static constexpr float kTriangleEpsilon = 1e-12f;
+
+namespace {
+
+// x, y and z coordinates of four points or vectors.
+struct vector4_t {
+  Simd::float4 x;
+  Simd::float4 y;
+  Simd::float4 z;
+};
+
+}  // namespace
+
+static inline void Broadcast(const vector_t &v, vector4_t &ret) {
+  ret.x = Simd::Set1(v[0]);
+  ret.y = Simd::Set1(v[1]);
+  ret.z = Simd::Set1(v[2]);
+}
+
+static inline void Load(const float (&v)[3][4], vector4_t &ret) {
+  ret.x = Simd::LoadUnaligned(v[0]);
+  ret.y = Simd::LoadUnaligned(v[1]);
+  ret.z = Simd::LoadUnaligned(v[2]);
+}
+
+// Loads four (possibly unaligned) vectors and transposes them.
+static inline void Gather(const float *a, const float *b, const float *c,
+                          const float *d, vector4_t &ret) {
+  Simd::float4 w = Simd::LoadUnaligned(d);
+  ret.x = Simd::LoadUnaligned(a);
+  ret.y = Simd::LoadUnaligned(b);
+  ret.z = Simd::LoadUnaligned(c);
+  Simd::Transpose(ret.x, ret.y, ret.z, w);
+}
+
+static inline void Subtract(const vector4_t &a, const vector4_t &b,
+                            vector4_t &ret) {
+  ret.x = Simd::Sub(a.x, b.x);
+  ret.y = Simd::Sub(a.y, b.y);
+  ret.z = Simd::Sub(a.z, b.z);
+}
+
+static inline Simd::float4 Dot(const vector4_t &a, const vector4_t &b) {
+  using namespace Simd;
+  return MulAdd(a.x, b.x, MulAdd(a.y, b.y, Mul(a.z, b.z)));
+}
+
+static inline void Cross(const vector4_t &a, const vector4_t &b,
+                         vector4_t &ret) {
+  using namespace Simd;
+  ret.x = Sub(Mul(a.y, b.z), Mul(a.z, b.y));
+  ret.y = Sub(Mul(a.z, b.x), Mul(a.x, b.z));
+  ret.z = Sub(Mul(a.x, b.y), Mul(a.y, b.x));
+}
+
+// Returns the mask of lanes where the ray hits the sphere, with the distance in
+// `t`.
+static inline Simd::float4 IntersectSphere(const vector4_t &origin,
+                                           const vector4_t &direction,
+                                           const vector4_t &center,
+                                           Simd::float4 radius_squared,
+                                           Simd::float4 &t) {
+  using namespace Simd;
+  vector4_t offset;
+  Subtract(origin, center, offset);
+  const float4 b = Dot(offset, direction);
+  const float4 c = Sub(Dot(offset, offset), radius_squared);
+  const float4 discriminant = Sub(Mul(b, b), c);
+  const float4 root = Sqrt(Max(discriminant, Zero()));
+
+  const float4 t_enter = Sub(Negate(b), root);
+  const float4 t_exit = Sub(root, b);
+  t = Select(CmpLt(t_enter, Zero()), t_exit, t_enter);
+  return And(CmpGe(discriminant, Zero()), CmpGe(t, Zero()));
+}
+
+// Slab test. Returns the mask of lanes where the ray hits the box, with the
+// entry distance (0 if the origin is inside) in `t`.
+static inline Simd::float4 IntersectAABB(const vector4_t &origin,
+                                         const vector4_t &inverse_direction,
+                                         const vector4_t &min_pt,
+                                         const vector4_t &max_pt,
+                                         Simd::float4 &t) {
+  using namespace Simd;
+  const float4 x0 = Mul(Sub(min_pt.x, origin.x), inverse_direction.x);
+  const float4 x1 = Mul(Sub(max_pt.x, origin.x), inverse_direction.x);
+  const float4 y0 = Mul(Sub(min_pt.y, origin.y), inverse_direction.y);
+  const float4 y1 = Mul(Sub(max_pt.y, origin.y), inverse_direction.y);
+  const float4 z0 = Mul(Sub(min_pt.z, origin.z), inverse_direction.z);
+  const float4 z1 = Mul(Sub(max_pt.z, origin.z), inverse_direction.z);
+
+  const float4 t_enter =
+      Max(Max(Min(x0, x1), Min(y0, y1)), Max(Min(z0, z1), Zero()));
+  const float4 t_exit = Min(Min(Max(x0, x1), Max(y0, y1)), Max(z0, z1));
+  t = t_enter;
+  return CmpLe(t_enter, t_exit);
+}
+
+// Moller-Trumbore test. Returns the mask of lanes where the ray hits the
+// triangle, with the distance in `t` and barycentric coordinates in `u`, `v`.
+static inline Simd::float4 IntersectTriangle(
+    const vector4_t &origin, const vector4_t &direction, const vector4_t &a,
+    const vector4_t &b, const vector4_t &c, Simd::float4 &t, Simd::float4 &u,
+    Simd::float4 &v) {
+  using namespace Simd;
+  vector4_t edge1, edge2;
+  Subtract(b, a, edge1);
+  Subtract(c, a, edge2);
+
+  vector4_t p;
+  Cross(direction, edge2, p);
+  const float4 determinant = Dot(edge1, p);
+  const float4 inv_determinant = Div(Set1(1.f), determinant);
+
+  vector4_t s;
+  Subtract(origin, a, s);
+  u = Mul(Dot(s, p), inv_determinant);
+
+  vector4_t q;
+  Cross(s, edge1, q);
+  v = Mul(Dot(direction, q), inv_determinant);
+  t = Mul(Dot(edge2, q), inv_determinant);
+
+  float4 mask = CmpGt(Abs(determinant), Set1(kTriangleEpsilon));
+  mask = And(mask, CmpGe(u, Zero()));
+  mask = And(mask, CmpGe(v, Zero()));
+  mask = And(mask, CmpLe(Add(u, v), Set1(1.f)));
+  return And(mask, CmpGe(t, Zero()));
+}
+
+// Returns the mask of the first `count` lanes.
+static inline int LaneMask(uint32_t count) { return (1 << count) - 1; }
+
+// Updates `hit` with the closest of the lanes in `mask`.
+static bool UpdateClosestHit(int mask, Simd::float4 t, Simd::float4 u,
+                             Simd::float4 v, uint32_t first_index,
+                             rayhit_t &hit) {
+  if (!mask) {
+    return false;
+  }
+  float distances[4], us[4], vs[4];
+  Simd::StoreUnaligned(distances, t);
+  Simd::StoreUnaligned(us, u);
+  Simd::StoreUnaligned(vs, v);
+
+  bool updated = false;
+  for (uint32_t i = 0; i < 4; ++i) {
+    if ((mask & (1 << i)) && distances[i] < hit.m_distance) {
+      hit.m_distance = distances[i];
+      hit.m_index = first_index + i;
+      hit.m_u = us[i];
+      hit.m_v = vs[i];
+      updated = true;
+    }
+  }
+  return updated;
+}
+
+// Updates the lanes of `hits` in `mask` that are closer than before.
+static int UpdatePacketHits(Simd::float4 mask, Simd::float4 t, Simd::float4 u,
+                            Simd::float4 v, uint32_t index,
+                            rayhit_t (&hits)[4]) {
+  using namespace Simd;
+  const float4 current = Set(hits[0].m_distance, hits[1].m_distance,
+                             hits[2].m_distance, hits[3].m_distance);
+  const int closer = MoveMask(And(mask, CmpLt(t, current)));
+  if (!closer) {
+    return 0;
+  }
+
+  float distances[4], us[4], vs[4];
+  StoreUnaligned(distances, t);
+  StoreUnaligned(us, u);
+  StoreUnaligned(vs, v);
+  for (uint32_t i = 0; i < 4; ++i) {
+    if (closer & (1 << i)) {
+      hits[i].m_distance = distances[i];
+      hits[i].m_index = index;
+      hits[i].m_u = us[i];
+      hits[i].m_v = vs[i];
+    }
+  }
+  return closer;
+}
+
+// Converts four near/far plane point pairs into rays, writing the first
+// `count` of them to `ret`.
+static void EmitRays(const homogeneous4_t &near_point,
+                     const homogeneous4_t &far_point, uint32_t count,
+                     ray_t *ret) {
+  using namespace Simd;
+  const float4 inv_near_w = Div(Set1(1.f), near_point[3]);
+  const float4 inv_far_w = Div(Set1(1.f), far_point[3]);
+
+  float4 origin_x = Mul(near_point[0], inv_near_w);
+  float4 origin_y = Mul(near_point[1], inv_near_w);
+  float4 origin_z = Mul(near_point[2], inv_near_w);
+
+  float4 direction_x = Sub(Mul(far_point[0], inv_far_w), origin_x);
+  float4 direction_y = Sub(Mul(far_point[1], inv_far_w), origin_y);
+  float4 direction_z = Sub(Mul(far_point[2], inv_far_w), origin_z);
+
+  const float4 length_squared =
+      MulAdd(direction_x, direction_x,
+             MulAdd(direction_y, direction_y, Mul(direction_z, direction_z)));
+  const float4 inv_length = Div(Set1(1.f), Sqrt(length_squared));
+  direction_x = Mul(direction_x, inv_length);
+  direction_y = Mul(direction_y, inv_length);
+  direction_z = Mul(direction_z, inv_length);
+
+  float4 origin_w = Set1(1.f);
+  float4 direction_w = Zero();
+  Transpose(origin_x, origin_y, origin_z, origin_w);
+  Transpose(direction_x, direction_y, direction_z, direction_w);
+
+  const float4 origins[4] = {origin_x, origin_y, origin_z, origin_w};
+  const float4 directions[4] = {direction_x, direction_y, direction_z,
+                                direction_w};
+  for (uint32_t i = 0; i < count; ++i) {
+    StoreUnaligned(ret[i].m_origin, origins[i]);
+    StoreUnaligned(ret[i].m_direction, directions[i]);
+  }
+}
+
+void RayPacketFromRays(const ray_t *rays, uint32_t count, raypacket_t &ret) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    const ray_t &ray = rays[i < count ? i : count - 1];
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      ret.m_origin[axis][i] = ray.m_origin[axis];
+      ret.m_direction[axis][i] = ray.m_direction[axis];
+      ret.m_inverseDirection[axis][i] = 1.f / ray.m_direction[axis];
+    }
+  }
+}
+
+bool RayIntersectSpheres(const ray_t &ray, const boundingsphere_t *spheres,
+                         uint32_t count, rayhit_t &hit) {
+  using namespace Simd;
+  vector4_t origin, direction;
+  Broadcast(ray.m_origin, origin);
+  Broadcast(ray.m_direction, direction);
+
+  bool updated = false;
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t lanes = count - first < 4 ? count - first : 4;
+    const boundingsphere_t *s[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      s[i] = &spheres[first + (i < lanes ? i : lanes - 1)];
+    }
+
+    vector4_t center;
+    Gather(s[0]->m_centerPt, s[1]->m_centerPt, s[2]->m_centerPt,
+           s[3]->m_centerPt, center);
+    const float4 radius = Set(s[0]->m_radius, s[1]->m_radius, s[2]->m_radius,
+                              s[3]->m_radius);
+
+    float4 t;
+    const float4 mask =
+        IntersectSphere(origin, direction, center, Mul(radius, radius), t);
+    updated |= UpdateClosestHit(MoveMask(mask) & LaneMask(lanes), t, Zero(),
+                                Zero(), first, hit);
+  }
+  return updated;
+}
+
+bool RayIntersectAABBs(const ray_t &ray, const aabb_t *boxes, uint32_t count,
+                       rayhit_t &hit) {
+  using namespace Simd;
+  vector4_t origin, inverse_direction;
+  Broadcast(ray.m_origin, origin);
+  inverse_direction.x = Set1(1.f / ray.m_direction[0]);
+  inverse_direction.y = Set1(1.f / ray.m_direction[1]);
+  inverse_direction.z = Set1(1.f / ray.m_direction[2]);
+
+  bool updated = false;
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t lanes = count - first < 4 ? count - first : 4;
+    const aabb_t *b[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      b[i] = &boxes[first + (i < lanes ? i : lanes - 1)];
+    }
+
+    vector4_t min_pt, max_pt;
+    Gather(b[0]->m_minPt, b[1]->m_minPt, b[2]->m_minPt, b[3]->m_minPt, min_pt);
+    Gather(b[0]->m_maxPt, b[1]->m_maxPt, b[2]->m_maxPt, b[3]->m_maxPt, max_pt);
+
+    float4 t;
+    const float4 mask =
+        IntersectAABB(origin, inverse_direction, min_pt, max_pt, t);
+    updated |= UpdateClosestHit(MoveMask(mask) & LaneMask(lanes), t, Zero(),
+                                Zero(), first, hit);
+  }
+  return updated;
+}
+
+bool RayIntersectTriangles(const ray_t &ray, const vertex_t *vertices,
+                           const uint32_t *indices, uint32_t triangle_count,
+                           rayhit_t &hit) {
+  using namespace Simd;
+  vector4_t origin, direction;
+  Broadcast(ray.m_origin, origin);
+  Broadcast(ray.m_direction, direction);
+
+  bool updated = false;
+  for (uint32_t first = 0; first < triangle_count; first += 4) {
+    const uint32_t lanes =
+        triangle_count - first < 4 ? triangle_count - first : 4;
+    const uint32_t *tri[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      tri[i] = &indices[(first + (i < lanes ? i : lanes - 1)) * 3];
+    }
+
+    vector4_t a, b, c;
+    Gather(vertices[tri[0][0]], vertices[tri[1][0]], vertices[tri[2][0]],
+           vertices[tri[3][0]], a);
+    Gather(vertices[tri[0][1]], vertices[tri[1][1]], vertices[tri[2][1]],
+           vertices[tri[3][1]], b);
+    Gather(vertices[tri[0][2]], vertices[tri[1][2]], vertices[tri[2][2]],
+           vertices[tri[3][2]], c);
+
+    float4 t, u, v;
+    const float4 mask = IntersectTriangle(origin, direction, a, b, c, t, u, v);
+    updated |= UpdateClosestHit(MoveMask(mask) & LaneMask(lanes), t, u, v,
+                                first, hit);
+  }
+  return updated;
+}
+
+int RayPacketIntersectSphere(const raypacket_t &packet,
+                             const boundingsphere_t &sphere, uint32_t index,
+                             rayhit_t (&hits)[4]) {
+  using namespace Simd;
+  vector4_t origin, direction, center;
+  Load(packet.m_origin, origin);
+  Load(packet.m_direction, direction);
+  Broadcast(sphere.m_centerPt, center);
+
+  float4 t;
+  const float4 mask = IntersectSphere(
+      origin, direction, center, Set1(sphere.m_radius * sphere.m_radius), t);
+  return UpdatePacketHits(mask, t, Zero(), Zero(), index, hits);
+}
+
+int RayPacketIntersectAABB(const raypacket_t &packet, const aabb_t &box,
+                           uint32_t index, rayhit_t (&hits)[4]) {
+  using namespace Simd;
+  vector4_t origin, inverse_direction, min_pt, max_pt;
+  Load(packet.m_origin, origin);
+  Load(packet.m_inverseDirection, inverse_direction);
+  Broadcast(box.m_minPt, min_pt);
+  Broadcast(box.m_maxPt, max_pt);
+
+  float4 t;
+  const float4 mask =
+      IntersectAABB(origin, inverse_direction, min_pt, max_pt, t);
+  return UpdatePacketHits(mask, t, Zero(), Zero(), index, hits);
+}
+
+int RayPacketIntersectTriangle(const raypacket_t &packet, const vertex_t &a,
+                               const vertex_t &b, const vertex_t &c,
+                               uint32_t index, rayhit_t (&hits)[4]) {
+  using namespace Simd;
+  vector4_t origin, direction, a4, b4, c4;
+  Load(packet.m_origin, origin);
+  Load(packet.m_direction, direction);
+  Broadcast(a, a4);
+  Broadcast(b, b4);
+  Broadcast(c, c4);
+
+  float4 t, u, v;
+  const float4 mask = IntersectTriangle(origin, direction, a4, b4, c4, t, u, v);
+  return UpdatePacketHits(mask, t, u, v, index, hits);
+}
+
+void ViewportDepthRange(const matrix4_t &viewport, float &near_screen_z,
+                        float &far_screen_z) {
+  near_screen_z = viewport[3][2];
+  far_screen_z = viewport[2][2] + viewport[3][2];
+}
+
+CRayGenerator::CRayGenerator(const matrix4_t &inverse_composite,
+                             const matrix4_t &viewport) {
+  float near_screen_z, far_screen_z;
+  ViewportDepthRange(viewport, near_screen_z, far_screen_z);
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    m_xRow[i] = inverse_composite[0][i];
+    m_yRow[i] = inverse_composite[1][i];
+    m_nearRow[i] =
+        near_screen_z * inverse_composite[2][i] + inverse_composite[3][i];
+    m_farRow[i] =
+        far_screen_z * inverse_composite[2][i] + inverse_composite[3][i];
+  }
+}
+
+void CRayGenerator::GenerateRay(float screen_x, float screen_y,
+                                ray_t &ret) const {
+  vector_t point = {screen_x, screen_y, 0.f, 1.f};
+  GenerateRays(&point, 1, &ret);
+}
+
+void CRayGenerator::GenerateRays(const vector_t *screen_points, uint32_t count,
+                                 ray_t *ret) const {
+  using namespace Simd;
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t batch = count - first < 4 ? count - first : 4;
+
+    float xs[4] = {0.f, 0.f, 0.f, 0.f};
+    float ys[4] = {0.f, 0.f, 0.f, 0.f};
+    for (uint32_t i = 0; i < batch; ++i) {
+      xs[i] = screen_points[first + i][0];
+      ys[i] = screen_points[first + i][1];
+    }
+    const float4 x = LoadUnaligned(xs);
+    const float4 y = LoadUnaligned(ys);
+
+    homogeneous4_t near_point, far_point;
+    for (uint32_t c = 0; c < 4; ++c) {
+      const float4 xy = MulAdd(x, Set1(m_xRow[c]), Mul(y, Set1(m_yRow[c])));
+      near_point[c] = Add(xy, Set1(m_nearRow[c]));
+      far_point[c] = Add(xy, Set1(m_farRow[c]));
+    }
+
+    EmitRays(near_point, far_point, batch, ret + first);
+  }
+}
+
+void CRayGenerator::GenerateGrid(float left, float top, float step_x,
+                                 float step_y, uint32_t columns,
+                                 uint32_t rows, ray_t *ret) const {
+  using namespace Simd;
+  const float4 lane_offsets = Mul(Set(0.f, 1.f, 2.f, 3.f), Set1(step_x));
+
+  for (uint32_t row = 0; row < rows; ++row) {
+    const float y = top + static_cast<float>(row) * step_y;
+
+    // Each lane holds one of four adjacent pixels; every iteration advances
+    // all lanes four pixels to the right.
+    homogeneous4_t near_point, far_point, step;
+    for (uint32_t c = 0; c < 4; ++c) {
+      const float row_start = left * m_xRow[c] + y * m_yRow[c];
+      const float4 lane_start =
+          MulAdd(lane_offsets, Set1(m_xRow[c]), Set1(row_start));
+      near_point[c] = Add(lane_start, Set1(m_nearRow[c]));
+      far_point[c] = Add(lane_start, Set1(m_farRow[c]));
+      step[c] = Set1(4.f * step_x * m_xRow[c]);
+    }
+
+    ray_t *row_rays = ret + static_cast<size_t>(row) * columns;
+    for (uint32_t column = 0; column < columns; column += 4) {
+      const uint32_t batch = columns - column < 4 ? columns - column : 4;
+      EmitRays(near_point, far_point, batch, row_rays + column);
+
+      for (uint32_t c = 0; c < 4; ++c) {
+        near_point[c] = Add(near_point[c], step[c]);
+        far_point[c] = Add(far_point[c], step[c]);
+      }
+    }
+  }
+}
+
+}  // namespace XboxMath
@@ -0,0 +1,116 @@
+#ifndef XBOX_MATH_RAY_H_
+#define XBOX_MATH_RAY_H_
+
+#include <cfloat>
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+typedef struct ray_t {
+  vector_t m_origin;     // w is 1.
+  vector_t m_direction;  // Unit length, w is 0.
+} ray_t;
+
+static constexpr uint32_t kRayHitNone = 0xFFFFFFFF;
+
+//! The closest intersection found so far by the RayIntersect* functions.
+typedef struct rayhit_t {
+  float m_distance;  // Distance along the ray, acts as the query's max range.
+  uint32_t m_index;  // Index of the primitive hit or kRayHitNone.
+  float m_u;         // Barycentric coordinates of a triangle hit, weighting
+  float m_v;         // the triangle's second and third vertices.
+} rayhit_t;
+
+inline void RayHitReset(rayhit_t &hit, float max_distance = FLT_MAX) {
+  hit.m_distance = max_distance;
+  hit.m_index = kRayHitNone;
+  hit.m_u = 0.f;
+  hit.m_v = 0.f;
+}
+
+//! Four rays in SoA form for the RayPacketIntersect* functions.
+typedef struct raypacket_t {
+  float m_origin[3][4];
+  float m_direction[3][4];
+  float m_inverseDirection[3][4];
+} raypacket_t;
+
+//! Builds a packet from up to four rays. Partial packets repeat the last ray.
+void RayPacketFromRays(const ray_t *rays, uint32_t count, raypacket_t &ret);
+
+//! Retrieves the screen space depth values of the near and far clipping planes
+//! from a viewport matrix built by CreateD3DViewport.
+void ViewportDepthRange(const matrix4_t &viewport, float &near_screen_z,
+                        float &far_screen_z);
+
+//! Intersects `ray` with `count` spheres. Hits closer than `hit.m_distance`
+//! replace the contents of `hit`; rays starting inside a sphere hit it where
+//! they exit.
+//! \return true if `hit` was updated.
+bool RayIntersectSpheres(const ray_t &ray, const boundingsphere_t *spheres,
+                         uint32_t count, rayhit_t &hit);
+
+//! Intersects `ray` with `count` axis aligned boxes. Rays starting inside a
+//! box hit it at distance 0.
+//! \return true if `hit` was updated.
+bool RayIntersectAABBs(const ray_t &ray, const aabb_t *boxes, uint32_t count,
+                       rayhit_t &hit);
+
+//! Intersects `ray` with `triangle_count` (double sided) triangles whose
+//! vertex indices are stored consecutively in `indices`.
+//! \return true if `hit` was updated.
+bool RayIntersectTriangles(const ray_t &ray, const vertex_t *vertices,
+                           const uint32_t *indices, uint32_t triangle_count,
+                           rayhit_t &hit);
+
+//! Intersects the four rays of `packet` with a single primitive, updating the
+//! hits of the rays that hit it closer than before with `index`.
+//! \return a bit mask of the updated hits.
+int RayPacketIntersectSphere(const raypacket_t &packet,
+                             const boundingsphere_t &sphere, uint32_t index,
+                             rayhit_t (&hits)[4]);
+int RayPacketIntersectAABB(const raypacket_t &packet, const aabb_t &box,
+                           uint32_t index, rayhit_t (&hits)[4]);
+int RayPacketIntersectTriangle(const raypacket_t &packet, const vertex_t &a,
+                               const vertex_t &b, const vertex_t &c,
+                               uint32_t index, rayhit_t (&hits)[4]);
+
+//! Generates world space picking rays for screen points by unprojecting them
+//! onto the near and far clipping planes.
+class CRayGenerator {
+ public:
+  //! `inverse_composite` is the inverse of view * projection * viewport and
+  //! `viewport` is the viewport matrix used to build the composite matrix.
+  CRayGenerator(const matrix4_t &inverse_composite, const matrix4_t &viewport);
+
+  //! Generates the ray through screen position (`screen_x`, `screen_y`).
+  void GenerateRay(float screen_x, float screen_y, ray_t &ret) const;
+
+  //! Generates rays for `count` screen points. Only the x and y components of
+  //! `screen_points` are used.
+  void GenerateRays(const vector_t *screen_points, uint32_t count,
+                    ray_t *ret) const;
+
+  //! Generates rays for a `columns` x `rows` grid of screen positions starting
+  //! at (`left`, `top`) and spaced by `step_x` and `step_y`. Rays are written
+  //! in row-major order, so `ret` must hold columns * rows entries.
+  //!
+  //! The unprojected points are stepped incrementally along each row rather
+  //! than transforming every grid position.
+  void GenerateGrid(float left, float top, float step_x, float step_y,
+                    uint32_t columns, uint32_t rows, ray_t *ret) const;
+
+ private:
+  // The inverse composite matrix rows with the near or far plane depth folded
+  // into the translation row, such that unprojecting (x, y) onto the near
+  // plane is x * m_xRow + y * m_yRow + m_nearRow.
+  vector_t m_xRow;
+  vector_t m_yRow;
+  vector_t m_nearRow;
+  vector_t m_farRow;
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_RAY_H_
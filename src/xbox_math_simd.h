@@ -0,0 +1,229 @@
+#ifndef XBOX_MATH_SIMD_H_
+#define XBOX_MATH_SIMD_H_
+
+// Internal 4-wide float helpers used by the batch kernels.
+//
+// The original XBOX CPU only supports SSE (no SSE2), so only SSE1 intrinsics
+// may be used here. Targets without SSE (or builds defining XBOX_MATH_NO_SSE)
+// get an equivalent scalar implementation.
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "xbox_math_types.h"
+
+#if !defined(XBOX_MATH_NO_SSE) &&                                    \
+    (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define XBOX_MATH_USE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace XboxMath {
+namespace Simd {
+
+#ifdef XBOX_MATH_USE_SSE
+
+typedef __m128 float4;
+
+inline float4 Set1(float v) { return _mm_set1_ps(v); }
+inline float4 Set(float x, float y, float z, float w) {
+  return _mm_setr_ps(x, y, z, w);
+}
+inline float4 Zero() { return _mm_setzero_ps(); }
+//! `p` must be 16-byte aligned.
+inline float4 Load(const float *p) { return _mm_load_ps(p); }
+inline float4 LoadUnaligned(const float *p) { return _mm_loadu_ps(p); }
+//! `p` must be 16-byte aligned.
+inline void Store(float *p, float4 v) { _mm_store_ps(p, v); }
+inline void StoreUnaligned(float *p, float4 v) { _mm_storeu_ps(p, v); }
+
+inline float4 Add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 Sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 Mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 Div(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 Min(float4 a, float4 b) { return _mm_min_ps(a, b); }
+inline float4 Max(float4 a, float4 b) { return _mm_max_ps(a, b); }
+inline float4 Sqrt(float4 a) { return _mm_sqrt_ps(a); }
+//! Approximates 1 / sqrt(`a`) to within 1.5 * 2^-12 relative error.
+inline float4 Rsqrt(float4 a) { return _mm_rsqrt_ps(a); }
+
+inline float4 CmpLt(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+inline float4 CmpLe(float4 a, float4 b) { return _mm_cmple_ps(a, b); }
+inline float4 CmpGt(float4 a, float4 b) { return _mm_cmpgt_ps(a, b); }
+inline float4 CmpGe(float4 a, float4 b) { return _mm_cmpge_ps(a, b); }
+inline float4 CmpEq(float4 a, float4 b) { return _mm_cmpeq_ps(a, b); }
+
+inline float4 And(float4 a, float4 b) { return _mm_and_ps(a, b); }
+//! Returns ~a & b.
+inline float4 AndNot(float4 a, float4 b) { return _mm_andnot_ps(a, b); }
+inline float4 Or(float4 a, float4 b) { return _mm_or_ps(a, b); }
+inline float4 Xor(float4 a, float4 b) { return _mm_xor_ps(a, b); }
+
+//! Returns a bit per lane, set if the lane's sign bit is set.
+inline int MoveMask(float4 a) { return _mm_movemask_ps(a); }
+
+inline float GetX(float4 a) { return _mm_cvtss_f32(a); }
+
+inline void Transpose(float4 &r0, float4 &r1, float4 &r2, float4 &r3) {
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+}
+
+//! Splits the eight lanes of `a` and `b` into the even lanes (a0, a2, b0, b2)
+//! and the odd lanes (a1, a3, b1, b3).
+inline void Deinterleave(float4 a, float4 b, float4 &even, float4 &odd) {
+  even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+#else
+
+typedef struct float4 {
+  float v[4];
+} float4;
+
+inline float4 Set1(float v) { return {{v, v, v, v}}; }
+inline float4 Set(float x, float y, float z, float w) { return {{x, y, z, w}}; }
+inline float4 Zero() { return {{0.f, 0.f, 0.f, 0.f}}; }
+inline float4 Load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline float4 LoadUnaligned(const float *p) { return Load(p); }
+inline void Store(float *p, float4 v) { memcpy(p, v.v, sizeof(v.v)); }
+inline void StoreUnaligned(float *p, float4 v) { Store(p, v); }
+
+#define XBOX_MATH_SIMD_BINARY_OP(name, expr)  \
+  inline float4 name(float4 a, float4 b) {    \
+    float4 ret;                               \
+    for (int i = 0; i < 4; ++i) {             \
+      const float x = a.v[i];                 \
+      const float y = b.v[i];                 \
+      ret.v[i] = (expr);                      \
+    }                                         \
+    return ret;                               \
+  }
+
+XBOX_MATH_SIMD_BINARY_OP(Add, x + y)
+XBOX_MATH_SIMD_BINARY_OP(Sub, x - y)
+XBOX_MATH_SIMD_BINARY_OP(Mul, x *y)
+XBOX_MATH_SIMD_BINARY_OP(Div, x / y)
+XBOX_MATH_SIMD_BINARY_OP(Min, x < y ? x : y)
+XBOX_MATH_SIMD_BINARY_OP(Max, x > y ? x : y)
+
+#undef XBOX_MATH_SIMD_BINARY_OP
+
+inline float4 Sqrt(float4 a) {
+  return {{sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3])}};
+}
+
+inline float4 Rsqrt(float4 a) { return Div(Set1(1.f), Sqrt(a)); }
+
+inline float MaskFromBool(bool b) {
+  const uint32_t bits = b ? 0xFFFFFFFF : 0;
+  float ret;
+  memcpy(&ret, &bits, sizeof(ret));
+  return ret;
+}
+
+#define XBOX_MATH_SIMD_COMPARE_OP(name, op)             \
+  inline float4 name(float4 a, float4 b) {              \
+    float4 ret;                                         \
+    for (int i = 0; i < 4; ++i) {                       \
+      ret.v[i] = MaskFromBool(a.v[i] op b.v[i]);        \
+    }                                                   \
+    return ret;                                         \
+  }
+
+XBOX_MATH_SIMD_COMPARE_OP(CmpLt, <)
+XBOX_MATH_SIMD_COMPARE_OP(CmpLe, <=)
+XBOX_MATH_SIMD_COMPARE_OP(CmpGt, >)
+XBOX_MATH_SIMD_COMPARE_OP(CmpGe, >=)
+XBOX_MATH_SIMD_COMPARE_OP(CmpEq, ==)
+
+#undef XBOX_MATH_SIMD_COMPARE_OP
+
+#define XBOX_MATH_SIMD_BITWISE_OP(name, expr)   \
+  inline float4 name(float4 a, float4 b) {      \
+    float4 ret;                                 \
+    for (int i = 0; i < 4; ++i) {               \
+      uint32_t x, y;                            \
+      memcpy(&x, &a.v[i], sizeof(x));           \
+      memcpy(&y, &b.v[i], sizeof(y));           \
+      const uint32_t result = (expr);           \
+      memcpy(&ret.v[i], &result, sizeof(result)); \
+    }                                           \
+    return ret;                                 \
+  }
+
+XBOX_MATH_SIMD_BITWISE_OP(And, x &y)
+XBOX_MATH_SIMD_BITWISE_OP(AndNot, ~x & y)
+XBOX_MATH_SIMD_BITWISE_OP(Or, x | y)
+XBOX_MATH_SIMD_BITWISE_OP(Xor, x ^ y)
+
+#undef XBOX_MATH_SIMD_BITWISE_OP
+
+inline int MoveMask(float4 a) {
+  int ret = 0;
+  for (int i = 0; i < 4; ++i) {
+    ret |= std::signbit(a.v[i]) ? (1 << i) : 0;
+  }
+  return ret;
+}
+
+inline float GetX(float4 a) { return a.v[0]; }
+
+inline void Transpose(float4 &r0, float4 &r1, float4 &r2, float4 &r3) {
+  float4 t0 = {{r0.v[0], r1.v[0], r2.v[0], r3.v[0]}};
+  float4 t1 = {{r0.v[1], r1.v[1], r2.v[1], r3.v[1]}};
+  float4 t2 = {{r0.v[2], r1.v[2], r2.v[2], r3.v[2]}};
+  float4 t3 = {{r0.v[3], r1.v[3], r2.v[3], r3.v[3]}};
+  r0 = t0;
+  r1 = t1;
+  r2 = t2;
+  r3 = t3;
+}
+
+inline void Deinterleave(float4 a, float4 b, float4 &even, float4 &odd) {
+  even = {{a.v[0], a.v[2], b.v[0], b.v[2]}};
+  odd = {{a.v[1], a.v[3], b.v[1], b.v[3]}};
+}
+
+#endif  // XBOX_MATH_USE_SSE
+
+//! Returns `a` where `mask` is set and `b` elsewhere.
+inline float4 Select(float4 mask, float4 a, float4 b) {
+  return Or(And(mask, a), AndNot(mask, b));
+}
+
+inline float4 MulAdd(float4 a, float4 b, float4 c) { return Add(Mul(a, b), c); }
+
+//! Rsqrt refined by one Newton-Raphson step, to within 2^-21 relative error.
+//! `a` must be a positive, finite normal number.
+inline float4 RsqrtRefined(float4 a) {
+  const float4 estimate = Rsqrt(a);
+  const float4 half_a_estimate = Mul(Mul(Set1(0.5f), a), estimate);
+  return Mul(estimate, Sub(Set1(1.5f), Mul(half_a_estimate, estimate)));
+}
+
+//! RsqrtRefined of each lane of `a` that is at least FLT_MIN, and 0 in the
+//! others, so that vectors with zero or denormal squared lengths scale to
+//! zero rather than infinity.
+inline float4 RsqrtRefinedOrZero(float4 a) {
+  const float4 min_a = Set1(FLT_MIN);
+  return And(CmpGe(a, min_a), RsqrtRefined(Max(a, min_a)));
+}
+
+inline float4 Abs(float4 a) { return AndNot(Set1(-0.f), a); }
+
+inline float4 Negate(float4 a) { return Xor(Set1(-0.f), a); }
+
+//! Rounds each lane to the nearest integer (ties to even) without requiring
+//! SSE2 conversions. Only valid for |a| < 2^22.
+inline float4 RoundNearest(float4 a) {
+  const float4 magic = Set1(12582912.f);  // 1.5 * 2^23
+  return Sub(Add(a, magic), magic);
+}
+
+}  // namespace Simd
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_SIMD_H_
@@ -0,0 +1,277 @@
+#include "xbox_math_spatial_hash.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <utility>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+namespace {
+
+// Keeps cell coordinates, and the range sizes computed from them, in range.
+constexpr float kMaxCellCoordinate = 1 << 29;
+
+int32_t CellCoordinate(float value) {
+  return static_cast<int32_t>(std::max(
+      -kMaxCellCoordinate, std::min(floorf(value), kMaxCellCoordinate)));
+}
+
+}  // namespace
+
+CSpatialHashGrid::CSpatialHashGrid(float cell_size, uint32_t bucket_count)
+    : m_cellSize(cell_size),
+      m_inverseCellSize(1.f / cell_size),
+      m_maxRadius(0.f),
+      m_objectCount(0) {
+  uint32_t buckets = 1;
+  while (buckets < bucket_count && buckets < 0x80000000u) {
+    buckets <<= 1;
+  }
+  m_buckets.resize(buckets);
+}
+
+void CSpatialHashGrid::GetCell(const float *point, int32_t (&cell)[3]) const {
+  for (uint32_t i = 0; i < 3; ++i) {
+    cell[i] = CellCoordinate(point[i] * m_inverseCellSize);
+  }
+}
+
+uint32_t CSpatialHashGrid::GetBucket(const int32_t (&cell)[3]) const {
+  // The hash function of "Optimized Spatial Hashing for Collision Detection
+  // of Deformable Objects" (Teschner et al., 2003).
+  const uint32_t hash = (static_cast<uint32_t>(cell[0]) * 73856093u) ^
+                        (static_cast<uint32_t>(cell[1]) * 19349663u) ^
+                        (static_cast<uint32_t>(cell[2]) * 83492791u);
+  return hash & static_cast<uint32_t>(m_buckets.size() - 1);
+}
+
+void CSpatialHashGrid::AddEntry(uint32_t handle, const int32_t (&cell)[3],
+                                const float *center, float radius) {
+  gridobject_t &object = m_objects[handle];
+  object.m_bucket = GetBucket(cell);
+  gridbucket_t &bucket = m_buckets[object.m_bucket];
+  object.m_slot = static_cast<uint32_t>(bucket.m_entries.size());
+  bucket.m_entries.push_back({{cell[0], cell[1], cell[2]}, handle});
+  bucket.m_spheres.insert(bucket.m_spheres.end(),
+                          {center[0], center[1], center[2], radius});
+}
+
+void CSpatialHashGrid::RemoveEntry(uint32_t handle) {
+  const gridobject_t &object = m_objects[handle];
+  gridbucket_t &bucket = m_buckets[object.m_bucket];
+  const uint32_t last = static_cast<uint32_t>(bucket.m_entries.size()) - 1;
+  if (object.m_slot != last) {
+    // Fill the hole with the last entry.
+    bucket.m_entries[object.m_slot] = bucket.m_entries[last];
+    std::copy_n(bucket.m_spheres.begin() + last * 4, 4,
+                bucket.m_spheres.begin() + object.m_slot * 4);
+    m_objects[bucket.m_entries[object.m_slot].m_handle].m_slot =
+        object.m_slot;
+  }
+  bucket.m_entries.pop_back();
+  bucket.m_spheres.resize(last * 4);
+}
+
+uint32_t CSpatialHashGrid::Insert(const vertex_t &center, float radius) {
+  uint32_t handle;
+  if (m_freeHandles.empty()) {
+    handle = static_cast<uint32_t>(m_objects.size());
+    m_objects.push_back({kFreeHandle, 0});
+  } else {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  }
+  int32_t cell[3];
+  GetCell(center, cell);
+  AddEntry(handle, cell, center, radius);
+  m_maxRadius = std::max(m_maxRadius, radius);
+  ++m_objectCount;
+  return handle;
+}
+
+void CSpatialHashGrid::Move(uint32_t handle, const vertex_t &center) {
+  const gridobject_t &object = m_objects[handle];
+  gridbucket_t &bucket = m_buckets[object.m_bucket];
+  int32_t cell[3];
+  GetCell(center, cell);
+  float *sphere = &bucket.m_spheres[object.m_slot * 4];
+  if (std::equal(cell, cell + 3, bucket.m_entries[object.m_slot].m_cell)) {
+    std::copy_n(center, 3, sphere);
+    return;
+  }
+  const float radius = sphere[3];
+  RemoveEntry(handle);
+  AddEntry(handle, cell, center, radius);
+}
+
+void CSpatialHashGrid::Remove(uint32_t handle) {
+  RemoveEntry(handle);
+  m_objects[handle].m_bucket = kFreeHandle;
+  m_freeHandles.push_back(handle);
+  --m_objectCount;
+}
+
+void CSpatialHashGrid::Clear() {
+  for (auto &bucket : m_buckets) {
+    bucket.m_spheres.clear();
+    bucket.m_entries.clear();
+  }
+  m_objects.clear();
+  m_freeHandles.clear();
+  m_objectCount = 0;
+  m_maxRadius = 0.f;
+}
+
+size_t CSpatialHashGrid::GetMemoryUsage() const {
+  size_t ret = m_buckets.capacity() * sizeof(gridbucket_t) +
+               m_objects.capacity() * sizeof(gridobject_t) +
+               m_freeHandles.capacity() * sizeof(uint32_t);
+  for (const auto &bucket : m_buckets) {
+    ret += bucket.m_spheres.capacity() * sizeof(float) +
+           bucket.m_entries.capacity() * sizeof(gridentry_t);
+  }
+  return ret;
+}
+
+template <typename Visit>
+bool CSpatialHashGrid::ForEachCandidate(const vertex_t &point, float reach,
+                                        Visit visit) const {
+  using namespace Simd;
+  const float4 x = Set1(point[0]);
+  const float4 y = Set1(point[1]);
+  const float4 z = Set1(point[2]);
+
+  // Tests the entries of `bucket` stored for `cell`, or all of them if `cell`
+  // is null.
+  auto scan = [&](const gridbucket_t &bucket, const int32_t *cell) {
+    const auto size = static_cast<uint32_t>(bucket.m_entries.size());
+    for (uint32_t first = 0; first < size; first += 4) {
+      const uint32_t lanes = size - first < 4 ? size - first : 4;
+      int lane_mask = 0;
+      float4 rows[4];
+      for (uint32_t lane = 0; lane < 4; ++lane) {
+        const uint32_t slot = first + (lane < lanes ? lane : lanes - 1);
+        rows[lane] = LoadUnaligned(&bucket.m_spheres[slot * 4]);
+        const int32_t *entry_cell = bucket.m_entries[slot].m_cell;
+        if (lane < lanes &&
+            (cell == nullptr ||
+             (entry_cell[0] == cell[0] && entry_cell[1] == cell[1] &&
+              entry_cell[2] == cell[2]))) {
+          lane_mask |= 1 << lane;
+        }
+      }
+      if (lane_mask == 0) {
+        continue;
+      }
+      Transpose(rows[0], rows[1], rows[2], rows[3]);
+      const float4 dx = Sub(rows[0], x);
+      const float4 dy = Sub(rows[1], y);
+      const float4 dz = Sub(rows[2], z);
+      visit(bucket, first, lane_mask,
+            MulAdd(dx, dx, MulAdd(dy, dy, Mul(dz, dz))), rows[3]);
+    }
+  };
+
+  float low[3], high[3];
+  float cell_count = 1.f;
+  for (uint32_t i = 0; i < 3; ++i) {
+    low[i] = floorf((point[i] - reach) * m_inverseCellSize);
+    high[i] = floorf((point[i] + reach) * m_inverseCellSize);
+    cell_count *= high[i] - low[i] + 1.f;
+  }
+  if (!(cell_count <= static_cast<float>(m_buckets.size()))) {
+    // Cheaper to scan every bucket once than to visit each cell.
+    for (const auto &bucket : m_buckets) {
+      scan(bucket, nullptr);
+    }
+    return true;
+  }
+
+  int32_t first_cell[3], last_cell[3];
+  for (uint32_t i = 0; i < 3; ++i) {
+    first_cell[i] = CellCoordinate(low[i]);
+    last_cell[i] = CellCoordinate(high[i]);
+  }
+  int32_t cell[3];
+  for (cell[2] = first_cell[2]; cell[2] <= last_cell[2]; ++cell[2]) {
+    for (cell[1] = first_cell[1]; cell[1] <= last_cell[1]; ++cell[1]) {
+      for (cell[0] = first_cell[0]; cell[0] <= last_cell[0]; ++cell[0]) {
+        scan(m_buckets[GetBucket(cell)], cell);
+      }
+    }
+  }
+  return false;
+}
+
+uint32_t CSpatialHashGrid::QueryRadius(const vertex_t &point, float radius,
+                                       std::vector<uint32_t> &results) const {
+  using namespace Simd;
+  results.clear();
+  const float4 radius4 = Set1(radius);
+  ForEachCandidate(
+      point, radius + m_maxRadius,
+      [&](const gridbucket_t &bucket, uint32_t first_slot, int lane_mask,
+          float4 distances_squared, float4 radii) {
+        const float4 reach = Add(radius4, radii);
+        int within =
+            MoveMask(CmpLe(distances_squared, Mul(reach, reach))) & lane_mask;
+        for (uint32_t lane = 0; within != 0; ++lane, within >>= 1) {
+          if (within & 1) {
+            results.push_back(bucket.m_entries[first_slot + lane].m_handle);
+          }
+        }
+      });
+  return static_cast<uint32_t>(results.size());
+}
+
+uint32_t CSpatialHashGrid::QueryNearest(const vertex_t &point, uint32_t k,
+                                        std::vector<uint32_t> &results) const {
+  using namespace Simd;
+  results.clear();
+  k = std::min(k, m_objectCount);
+  if (k == 0) {
+    return 0;
+  }
+
+  // Search ever larger spheres until one holds k centers. Nothing outside it
+  // can then be nearer than those.
+  std::vector<std::pair<float, uint32_t>> candidates;
+  float reach = m_cellSize;
+  for (;;) {
+    candidates.clear();
+    const float4 reach_squared = Set1(reach * reach);
+    const bool scanned_all = ForEachCandidate(
+        point, reach,
+        [&](const gridbucket_t &bucket, uint32_t first_slot, int lane_mask,
+            float4 distances_squared, float4) {
+          int within =
+              MoveMask(CmpLe(distances_squared, reach_squared)) & lane_mask;
+          if (within == 0) {
+            return;
+          }
+          float values[4];
+          StoreUnaligned(values, distances_squared);
+          for (uint32_t lane = 0; within != 0; ++lane, within >>= 1) {
+            if (within & 1) {
+              candidates.emplace_back(
+                  values[lane], bucket.m_entries[first_slot + lane].m_handle);
+            }
+          }
+        });
+    if (candidates.size() >= k) {
+      break;
+    }
+    reach = scanned_all ? FLT_MAX : reach * 2.f;
+  }
+
+  std::partial_sort(candidates.begin(), candidates.begin() + k,
+                    candidates.end());
+  for (uint32_t i = 0; i < k; ++i) {
+    results.push_back(candidates[i].second);
+  }
+  return k;
+}
+
+}  // namespace XboxMath
@@ -0,0 +1,104 @@
+#ifndef XBOX_MATH_SPATIAL_HASH_H_
+#define XBOX_MATH_SPATIAL_HASH_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! A uniform grid of cubic cells over unbounded space, hashed into a fixed
+//! number of buckets, for finding the points or spheres near a point.
+//!
+//! Each object is stored in the bucket of the cell containing its center, in
+//! flat per-bucket arrays of centers and radii that queries scan four at a
+//! time. Objects are identified by the handle Insert returns, which stays
+//! valid until the object is removed and may then be reused.
+//!
+//! Queries are fastest when the cell size is close to the typical query radius
+//! and objects are no larger than a cell, and when there are at least as many
+//! buckets as objects.
+class CSpatialHashGrid {
+ public:
+  //! `bucket_count` is rounded up to a power of two.
+  CSpatialHashGrid(float cell_size, uint32_t bucket_count);
+
+  //! Adds a sphere, or a point if `radius` is 0.
+  //! \return the object's handle.
+  uint32_t Insert(const vertex_t &center, float radius = 0.f);
+
+  //! Moves the object to `center`. Moving within a cell is cheapest.
+  void Move(uint32_t handle, const vertex_t &center);
+
+  void Remove(uint32_t handle);
+
+  //! Removes every object.
+  void Clear();
+
+  [[nodiscard]] uint32_t GetObjectCount() const { return m_objectCount; }
+  [[nodiscard]] float GetCellSize() const { return m_cellSize; }
+
+  //! Returns the number of bytes used by the grid.
+  [[nodiscard]] size_t GetMemoryUsage() const;
+
+  //! Replaces `results` with the handles of the objects no farther than
+  //! `radius` from `point`, counting from their surfaces, in no particular
+  //! order.
+  //! \return the number of objects found.
+  uint32_t QueryRadius(const vertex_t &point, float radius,
+                       std::vector<uint32_t> &results) const;
+
+  //! Replaces `results` with the handles of the `k` objects whose centers are
+  //! nearest `point`, nearest first, or of every object if there are fewer.
+  //! Ties are broken arbitrarily.
+  //! \return the number of objects found.
+  uint32_t QueryNearest(const vertex_t &point, uint32_t k,
+                        std::vector<uint32_t> &results) const;
+
+ private:
+  // Where an object is stored.
+  typedef struct gridobject_t {
+    uint32_t m_bucket;  // kFreeHandle if the handle is unused.
+    uint32_t m_slot;
+  } gridobject_t;
+
+  // The cell an entry's center lies in, to tell apart cells sharing a bucket.
+  typedef struct gridentry_t {
+    int32_t m_cell[3];
+    uint32_t m_handle;
+  } gridentry_t;
+
+  typedef struct gridbucket_t {
+    std::vector<float> m_spheres;  // Center x, y, z and radius per entry.
+    std::vector<gridentry_t> m_entries;
+  } gridbucket_t;
+
+  static constexpr uint32_t kFreeHandle = 0xFFFFFFFF;
+
+  void GetCell(const float *point, int32_t (&cell)[3]) const;
+  [[nodiscard]] uint32_t GetBucket(const int32_t (&cell)[3]) const;
+  void AddEntry(uint32_t handle, const int32_t (&cell)[3], const float *center,
+                float radius);
+  void RemoveEntry(uint32_t handle);
+
+  // Calls `visit(bucket, first_slot, lane_mask, distances_squared, radii)`
+  // for groups of up to four entries of a bucket, covering at least every
+  // object whose center is within `reach` of `point`. Bit i of `lane_mask` is
+  // set if entry `first_slot` + i is one of them.
+  // \return true if every bucket was scanned.
+  template <typename Visit>
+  bool ForEachCandidate(const vertex_t &point, float reach, Visit visit) const;
+
+  float m_cellSize;
+  float m_inverseCellSize;
+  float m_maxRadius;  // Of any object inserted since the last Clear.
+  uint32_t m_objectCount;
+  std::vector<gridbucket_t> m_buckets;
+  std::vector<gridobject_t> m_objects;
+  std::vector<uint32_t> m_freeHandles;
+};
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_SPATIAL_HASH_H_
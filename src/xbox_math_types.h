@@ -24,9 +24,31 @@ typedef struct boundingsphere_t {
   float m_radius;
 } boundingsphere_t;
 
+typedef struct aabb_t {
+  vector_t m_minPt;
+  vector_t m_maxPt;
+} aabb_t;
+
+// The screen space extent of a projected volume.
+typedef struct screenrect_t {
+  float m_minX;
+  float m_minY;
+  float m_maxX;
+  float m_maxY;
+  float m_minZ;  // Nearest screen space depth.
+  float m_maxZ;  // Farthest screen space depth.
+} screenrect_t;
+
+//! Prefer this over PointDistancePoint when only comparing distances.
+inline float PointDistanceSquaredPoint(const vertex_t &a, const vertex_t &b) {
+  const float x = b[0] - a[0];
+  const float y = b[1] - a[1];
+  const float z = b[2] - a[2];
+  return x * x + y * y + z * z;
+}
+
 inline float PointDistancePoint(const vertex_t &a, const vertex_t &b) {
-  return (float)sqrt(pow(b[0] - a[0], 2.0f) + pow(b[1] - a[1], 2.0f) +
-                     pow(b[2] - a[2], 2.0f));
+  return sqrtf(PointDistanceSquaredPoint(a, b));
 }
 
 void PlaneFindNormal(const vertex_t &a, const vertex_t &b, const vertex_t &c,
@@ -1,6 +1,10 @@
 #include "xbox_math_util.h"
 
+#include <algorithm>
+#include <cfloat>
+
 #include "xbox_math_matrix.h"
+#include "xbox_math_simd.h"
 
 namespace XboxMath {
 
@@ -14,6 +18,13 @@ void BuildInverseCompositeMatrix(const matrix4_t &composite_matrix,
   MatrixInvert(composite_matrix, result);
 }
 
+void BuildInverseCompositeMatrix(const matrix4_t &inverse_model_view,
+                                 const matrix4_t &inverse_projection,
+                                 matrix4_t &result) {
+  // (model_view * projection)^-1 == projection^-1 * model_view^-1
+  MatrixMultMatrix(inverse_projection, inverse_model_view, result);
+}
+
 void ProjectPoint(const vector_t &world_point,
                   const matrix4_t &composite_matrix, vector_t &result) {
   vector_t screen_point;
@@ -60,4 +71,185 @@ void UnprojectPoint(const vector_t &screen_point,
   result[3] = 1.0f;
 }
 
+bool BoundingBoxScreenRect(const aabb_t &box,
+                           const matrix4_t &composite_matrix,
+                           screenrect_t &result) {
+  screenrect_t rect = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX};
+  for (uint32_t corner = 0; corner < 8; ++corner) {
+    vector_t point = {corner & 1 ? box.m_maxPt[0] : box.m_minPt[0],
+                      corner & 2 ? box.m_maxPt[1] : box.m_minPt[1],
+                      corner & 4 ? box.m_maxPt[2] : box.m_minPt[2], 1.0f};
+    vector_t screen_point;
+    VectorMultMatrix(point, composite_matrix, screen_point);
+    if (screen_point[3] <= 0.0f) {
+      return false;
+    }
+
+    const float inv_w = 1.0f / screen_point[3];
+    const float x = screen_point[0] * inv_w;
+    const float y = screen_point[1] * inv_w;
+    const float z = screen_point[2] * inv_w;
+    rect.m_minX = std::min(rect.m_minX, x);
+    rect.m_minY = std::min(rect.m_minY, y);
+    rect.m_maxX = std::max(rect.m_maxX, x);
+    rect.m_maxY = std::max(rect.m_maxY, y);
+    rect.m_minZ = std::min(rect.m_minZ, z);
+    rect.m_maxZ = std::max(rect.m_maxZ, z);
+  }
+  result = rect;
+  return true;
+}
+
+bool BoundingSphereScreenRect(const boundingsphere_t &sphere,
+                              const matrix4_t &composite_matrix,
+                              screenrect_t &result) {
+  const float radius = sphere.m_radius;
+  const aabb_t box = {{sphere.m_centerPt[0] - radius,
+                       sphere.m_centerPt[1] - radius,
+                       sphere.m_centerPt[2] - radius, 1.0f},
+                      {sphere.m_centerPt[0] + radius,
+                       sphere.m_centerPt[1] + radius,
+                       sphere.m_centerPt[2] + radius, 1.0f}};
+  return BoundingBoxScreenRect(box, composite_matrix, result);
+}
+
+// Finds the two lines of sight tangent to the circle where the plane spanned
+// by the view direction and one screen axis cuts each sphere, returning their
+// slopes (screen axis over depth). `a` and `z` are the sphere centers along
+// the axis and the view direction.
+//
+// Tangent points behind the near plane are replaced by the ends of the chord
+// along which the near plane cuts the circle, as in "2D Polyhedral Bounds of a
+// Clipped, Perspective-Projected 3D Sphere" (Mara and McGuire, 2013).
+static inline void SphereTangentSlopes(Simd::float4 a, Simd::float4 z,
+                                       Simd::float4 radius,
+                                       Simd::float4 z_near,
+                                       Simd::float4 &min_slope,
+                                       Simd::float4 &max_slope) {
+  using namespace Simd;
+  const float4 zero = Zero();
+  const float4 center_length_squared = MulAdd(a, a, Mul(z, z));
+  const float4 t_squared = Sub(center_length_squared, Mul(radius, radius));
+  const float4 inv_center_length_squared =
+      Div(Set1(1.0f), center_length_squared);
+  // cos and sin of the angle between the center and the tangents, scaled by
+  // cos so the rotated center lands on the tangent points.
+  const float4 cos_squared = Mul(t_squared, inv_center_length_squared);
+  const float4 cos_sin = Mul(Sqrt(Max(t_squared, zero)),
+                             Mul(radius, inv_center_length_squared));
+
+  const float4 a_rotated = Mul(cos_squared, a);
+  const float4 z_rotated = Mul(cos_squared, z);
+  const float4 a_offset = Mul(cos_sin, z);
+  const float4 z_offset = Mul(cos_sin, a);
+  float4 a0 = Add(a_rotated, a_offset), z0 = Sub(z_rotated, z_offset);
+  float4 a1 = Sub(a_rotated, a_offset), z1 = Add(z_rotated, z_offset);
+
+  // The near plane only matters for spheres reaching in front of it.
+  const float4 clipped = CmpLt(Sub(z, radius), z_near);
+  const float4 eye_inside = CmpLe(t_squared, zero);
+  const float4 near_offset = Sub(z_near, z);
+  const float4 chord = Sqrt(
+      Max(Sub(Mul(radius, radius), Mul(near_offset, near_offset)), zero));
+  const float4 clip0 = And(clipped, Or(eye_inside, CmpLt(z0, z_near)));
+  const float4 clip1 = And(clipped, Or(eye_inside, CmpLt(z1, z_near)));
+  a0 = Select(clip0, Add(a, chord), a0);
+  z0 = Select(clip0, z_near, z0);
+  a1 = Select(clip1, Sub(a, chord), a1);
+  z1 = Select(clip1, z_near, z1);
+
+  const float4 slope0 = Div(a0, z0);
+  const float4 slope1 = Div(a1, z1);
+  min_slope = Min(slope0, slope1);
+  max_slope = Max(slope0, slope1);
+}
+
+uint32_t BoundingSphereScreenRectsPerspective(const boundingsphere_t *spheres,
+                                              uint32_t count,
+                                              const matrix4_t &view,
+                                              const matrix4_t &projection,
+                                              const matrix4_t &viewport,
+                                              screenrect_t *results) {
+  using namespace Simd;
+  // Screen position = slope * scale * viewport scale + viewport offset, and
+  // screen depth = (z_adjustment - z_near * z_adjustment / view depth) *
+  // viewport depth scale + viewport depth offset.
+  const float x_scale = projection[0][0] * viewport[0][0];
+  const float y_scale = projection[1][1] * viewport[1][1];
+  const float z_near = -projection[3][2] / projection[2][2];
+  const float4 screen_x_scale = Set1(x_scale);
+  const float4 screen_x_offset = Set1(viewport[3][0]);
+  const float4 screen_y_scale = Set1(y_scale);
+  const float4 screen_y_offset = Set1(viewport[3][1]);
+  const float4 depth_offset =
+      Set1(projection[2][2] * viewport[2][2] + viewport[3][2]);
+  const float4 depth_scale = Set1(projection[3][2] * viewport[2][2]);
+  const float4 near4 = Set1(z_near);
+
+  float4 view_rows[4];
+  for (uint32_t i = 0; i < 4; ++i) {
+    view_rows[i] = LoadUnaligned(view[i]);
+  }
+
+  uint32_t ret = 0;
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t lanes = count - first < 4 ? count - first : 4;
+    const boundingsphere_t *s[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      s[i] = &spheres[first + (i < lanes ? i : lanes - 1)];
+    }
+
+    // View space centers, transposed to one axis per register.
+    float4 centers[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      const float *c = s[i]->m_centerPt;
+      float4 center = MulAdd(Set1(c[0]), view_rows[0], view_rows[3]);
+      center = MulAdd(Set1(c[1]), view_rows[1], center);
+      centers[i] = MulAdd(Set1(c[2]), view_rows[2], center);
+    }
+    Transpose(centers[0], centers[1], centers[2], centers[3]);
+    const float4 &x = centers[0];
+    const float4 &y = centers[1];
+    const float4 &z = centers[2];
+    const float4 radius =
+        Set(s[0]->m_radius, s[1]->m_radius, s[2]->m_radius, s[3]->m_radius);
+
+    float4 min_x, max_x, min_y, max_y;
+    SphereTangentSlopes(x, z, radius, near4, min_x, max_x);
+    SphereTangentSlopes(y, z, radius, near4, min_y, max_y);
+    min_x = MulAdd(min_x, screen_x_scale, screen_x_offset);
+    max_x = MulAdd(max_x, screen_x_scale, screen_x_offset);
+    // The viewport flips y.
+    const float4 top = MulAdd(max_y, screen_y_scale, screen_y_offset);
+    const float4 bottom = MulAdd(min_y, screen_y_scale, screen_y_offset);
+    min_y = Min(top, bottom);
+    max_y = Max(top, bottom);
+
+    const float4 near_depth = Max(Sub(z, radius), near4);
+    const float4 far_depth = Add(z, radius);
+    const float4 min_z = Add(depth_offset, Div(depth_scale, near_depth));
+    const float4 max_z = Add(depth_offset, Div(depth_scale, far_depth));
+
+    const int behind = MoveMask(CmpLt(far_depth, near4));
+    float values[6][4];
+    StoreUnaligned(values[0], min_x);
+    StoreUnaligned(values[1], min_y);
+    StoreUnaligned(values[2], max_x);
+    StoreUnaligned(values[3], max_y);
+    StoreUnaligned(values[4], min_z);
+    StoreUnaligned(values[5], max_z);
+    for (uint32_t i = 0; i < lanes; ++i) {
+      screenrect_t &rect = results[first + i];
+      if (behind & (1 << i)) {
+        rect = {FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX};
+        continue;
+      }
+      rect = {values[0][i], values[1][i], values[2][i],
+              values[3][i], values[4][i], values[5][i]};
+      ++ret;
+    }
+  }
+  return ret;
+}
+
 }  // namespace XboxMath
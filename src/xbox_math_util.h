@@ -13,6 +13,14 @@ void BuildCompositeMatrix(const matrix4_t &model_view,
 void BuildInverseCompositeMatrix(const matrix4_t &composite_matrix,
                                  matrix4_t &result);
 
+//! Creates the inverse of the composite matrix built by BuildCompositeMatrix
+//! from the inverses of its factors (e.g., as built by the closed-form
+//! Create*Inverse functions in xbox_math_d3d.h). This avoids a general matrix
+//! inversion and is more precise.
+void BuildInverseCompositeMatrix(const matrix4_t &inverse_model_view,
+                                 const matrix4_t &inverse_projection,
+                                 matrix4_t &result);
+
 //! Projects the given point into screen space using the given composite matrix.
 void ProjectPoint(const vector_t &world_point,
                   const matrix4_t &composite_matrix, vector_t &result);
@@ -30,6 +38,40 @@ void UnprojectPoint(const vector_t &screen_point,
                     const matrix4_t &inverse_composite_matrix, float world_z,
                     vector_t &result);
 
+//! Computes the screen space rectangle and depth range covered by `box` by
+//! projecting its corners.
+//! \return false if part of the box is behind the eye, in which case `result`
+//! is not set.
+bool BoundingBoxScreenRect(const aabb_t &box,
+                           const matrix4_t &composite_matrix,
+                           screenrect_t &result);
+
+//! Computes a conservative screen space rectangle and depth range for `sphere`
+//! by projecting the corners of its bounding box.
+//! \return false if part of the box is behind the eye, in which case `result`
+//! is not set.
+bool BoundingSphereScreenRect(const boundingsphere_t &sphere,
+                              const matrix4_t &composite_matrix,
+                              screenrect_t &result);
+
+//! Computes the exact screen space rectangles and depth ranges of `count`
+//! spheres for a perspective projection built by CreateD3DPerspectiveFOVLH,
+//! four spheres at a time.
+//!
+//! `view` must be a rigid transform (e.g., from CreateD3DLookAtLH) and
+//! `viewport` a matrix built by CreateD3DViewport. The rects bound the lines of
+//! sight tangent to each sphere. Spheres crossing the near plane are clipped
+//! against it, so their rects are bounded by the circle where the sphere cuts
+//! the plane instead of growing without bound. Spheres entirely behind the near
+//! plane get an empty rect (m_minX > m_maxX).
+//! \return the number of spheres at least partly in front of the near plane.
+uint32_t BoundingSphereScreenRectsPerspective(const boundingsphere_t *spheres,
+                                              uint32_t count,
+                                              const matrix4_t &view,
+                                              const matrix4_t &projection,
+                                              const matrix4_t &viewport,
+                                              screenrect_t *results);
+
 }  // namespace XboxMath
 
 #endif  // XBOX_MATH_UTIL_H
@@ -2,6 +2,8 @@
 
 #include <cassert>
 
+#include "xbox_math_simd.h"
+
 namespace XboxMath {
 
 void VectorNormalize(vector_t &v) {
@@ -18,6 +20,49 @@ void VectorNormalize(const vector_t &v, vector_t &ret) {
   ret[2] = v[2] * inv_length;
 }
 
+void VectorNormalizeFast(const vector_t &v, vector_t &ret) {
+  const float inv_length =
+      Simd::GetX(Simd::RsqrtRefined(Simd::Set1(VectorDotVector(v, v))));
+  ret[0] = v[0] * inv_length;
+  ret[1] = v[1] * inv_length;
+  ret[2] = v[2] * inv_length;
+}
+
+void VectorNormalizeFast(vector_t &v) { VectorNormalizeFast(v, v); }
+
+void VectorNormalizeFastSafe(const vector_t &v, vector_t &ret) {
+  const float inv_length =
+      Simd::GetX(Simd::RsqrtRefinedOrZero(Simd::Set1(VectorDotVector(v, v))));
+  ret[0] = v[0] * inv_length;
+  ret[1] = v[1] * inv_length;
+  ret[2] = v[2] * inv_length;
+}
+
+void VectorNormalizeFastSafe(vector_t &v) { VectorNormalizeFastSafe(v, v); }
+
+void VectorsNormalizeFast(const vector_t *vectors, uint32_t count,
+                          vector_t *ret) {
+  using namespace Simd;
+  for (uint32_t first = 0; first < count; first += 4) {
+    const uint32_t lanes = count - first < 4 ? count - first : 4;
+    float4 rows[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      rows[lane] =
+          LoadUnaligned(vectors[first + (lane < lanes ? lane : lanes - 1)]);
+    }
+    Transpose(rows[0], rows[1], rows[2], rows[3]);
+    const float4 inv_length = RsqrtRefinedOrZero(MulAdd(
+        rows[0], rows[0], MulAdd(rows[1], rows[1], Mul(rows[2], rows[2]))));
+    rows[0] = Mul(rows[0], inv_length);
+    rows[1] = Mul(rows[1], inv_length);
+    rows[2] = Mul(rows[2], inv_length);
+    Transpose(rows[0], rows[1], rows[2], rows[3]);
+    for (uint32_t lane = 0; lane < lanes; ++lane) {
+      StoreUnaligned(ret[first + lane], rows[lane]);
+    }
+  }
+}
+
 void VectorAddVector(const vector_t &a, const vector_t &b, vector_t &sum) {
   assert(a[3] == 1.f);
   assert(b[3] == 1.f);
@@ -19,6 +19,24 @@ inline void VectorIdentity(vector_t &v) {
 void VectorNormalize(const vector_t &v, vector_t &ret);
 void VectorNormalize(vector_t &v);
 
+//! Scales `v` to unit length like VectorNormalize, but with a reciprocal
+//! square root estimate (rsqrtss) refined by one Newton-Raphson step instead
+//! of a square root and a divide. The result is within 2^-21 (about 4.8e-7)
+//! relative error of the exact unit vector. `v` must not be zero length.
+void VectorNormalizeFast(const vector_t &v, vector_t &ret);
+void VectorNormalizeFast(vector_t &v);
+
+//! As VectorNormalizeFast, but vectors shorter than sqrt(FLT_MIN), including
+//! zero length ones, become zero rather than NaN. This takes no branch, so
+//! callers need not test for zero length either.
+void VectorNormalizeFastSafe(const vector_t &v, vector_t &ret);
+void VectorNormalizeFastSafe(vector_t &v);
+
+//! Applies VectorNormalizeFastSafe to `count` vectors, four at a time with
+//! rsqrtps. `ret` may be `vectors`.
+void VectorsNormalizeFast(const vector_t *vectors, uint32_t count,
+                          vector_t *ret);
+
 void VectorAddVector(const vector_t &a, const vector_t &b, vector_t &sum);
 inline void VectorAddVector(vector_t &plusEquals, const vector_t &b) {
   plusEquals[0] += b[0];
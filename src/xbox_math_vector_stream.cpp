@@ -0,0 +1,334 @@
+#include "xbox_math_vector_stream.h"
+
+#include <cassert>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "xbox_math_simd.h"
+
+namespace XboxMath {
+
+namespace {
+
+using Simd::float4;
+
+// Room for the component arrays plus enough floats to align their start.
+constexpr uint32_t kAlignmentSlack = 3;
+
+float *AlignUp(float *p) {
+  const auto address = reinterpret_cast<uintptr_t>(p);
+  return p + ((16 - (address & 15)) & 15) / sizeof(float);
+}
+
+// Sets vectors [`first`, `padded_count`) of the component arrays at `data` to
+// (0, 0, 0, 1).
+void ResetVectors(float *data, uint32_t padded_count, uint32_t first) {
+  for (uint32_t axis = 0; axis < 4; ++axis) {
+    float *component = data + axis * padded_count;
+    for (uint32_t i = first; i < padded_count; ++i) {
+      component[i] = axis == 3 ? 1.f : 0.f;
+    }
+  }
+}
+
+// The component arrays of a stream, fetched once so that stores through them
+// don't force the stream's members to be reloaded.
+typedef struct components_t {
+  float *m_axes[4];
+} components_t;
+
+inline components_t Components(CVectorStream &stream) {
+  return {{stream.GetX(), stream.GetY(), stream.GetZ(), stream.GetW()}};
+}
+
+inline components_t Components(const CVectorStream &stream) {
+  return Components(const_cast<CVectorStream &>(stream));
+}
+
+// Loads vectors [`first`, `first` + 4), one component per register.
+inline void LoadGroup(const components_t &stream, uint32_t first,
+                      float4 (&ret)[4]) {
+  for (uint32_t axis = 0; axis < 4; ++axis) {
+    ret[axis] = Simd::Load(stream.m_axes[axis] + first);
+  }
+}
+
+inline void StoreGroup(const float4 (&v)[4], uint32_t first,
+                       const components_t &ret) {
+  for (uint32_t axis = 0; axis < 4; ++axis) {
+    Simd::Store(ret.m_axes[axis] + first, v[axis]);
+  }
+}
+
+// Stores the first `lanes` values of `values` at `ret`.
+inline void StoreLanes(float *ret, uint32_t lanes, float4 values) {
+  if (lanes == 4) {
+    Simd::StoreUnaligned(ret, values);
+    return;
+  }
+  float buffer[4];
+  Simd::StoreUnaligned(buffer, values);
+  for (uint32_t lane = 0; lane < lanes; ++lane) {
+    ret[lane] = buffer[lane];
+  }
+}
+
+inline float4 Dot(const float4 (&a)[4], const float4 (&b)[4]) {
+  using namespace Simd;
+  return MulAdd(a[0], b[0], MulAdd(a[1], b[1], Mul(a[2], b[2])));
+}
+
+}  // namespace
+
+CVectorStream::CVectorStream(uint32_t count) : m_count(0), m_paddedCount(0) {
+  Resize(count);
+}
+
+CVectorStream::CVectorStream(const CVectorStream &other)
+    : m_count(0), m_paddedCount(0) {
+  *this = other;
+}
+
+CVectorStream::CVectorStream(CVectorStream &&other) noexcept
+    : m_count(other.m_count),
+      m_paddedCount(other.m_paddedCount),
+      m_storage(std::move(other.m_storage)) {
+  other.m_count = 0;
+  other.m_paddedCount = 0;
+  other.m_storage.clear();
+}
+
+CVectorStream &CVectorStream::operator=(const CVectorStream &other) {
+  if (this != &other) {
+    // The copy's storage may be aligned differently, so the component arrays
+    // are copied rather than the storage itself.
+    m_count = 0;
+    Resize(other.m_count);
+    if (m_paddedCount > 0) {
+      memcpy(AlignedData(), other.GetX(), m_paddedCount * 4 * sizeof(float));
+    }
+  }
+  return *this;
+}
+
+CVectorStream &CVectorStream::operator=(CVectorStream &&other) noexcept {
+  if (this != &other) {
+    // Moving the storage keeps its address, and so its alignment.
+    m_count = other.m_count;
+    m_paddedCount = other.m_paddedCount;
+    m_storage = std::move(other.m_storage);
+    other.m_count = 0;
+    other.m_paddedCount = 0;
+    other.m_storage.clear();
+  }
+  return *this;
+}
+
+float *CVectorStream::AlignedData() { return AlignUp(m_storage.data()); }
+
+void CVectorStream::Resize(uint32_t count) {
+  const uint32_t padded_count = (count + 3) & ~3u;
+  const uint32_t kept = count < m_count ? count : m_count;
+  if (padded_count != m_paddedCount || m_storage.empty()) {
+    std::vector<float> storage(padded_count * 4 + kAlignmentSlack);
+    float *data = AlignUp(storage.data());
+    for (uint32_t axis = 0; axis < 4 && kept > 0; ++axis) {
+      memcpy(data + axis * padded_count, Component(axis),
+             kept * sizeof(float));
+    }
+    m_storage.swap(storage);
+    m_paddedCount = padded_count;
+  }
+  ResetVectors(AlignedData(), m_paddedCount, kept);
+  m_count = count;
+}
+
+void CVectorStream::GetVector(uint32_t index, vector_t &ret) const {
+  assert(index < m_count);
+  for (uint32_t axis = 0; axis < 4; ++axis) {
+    ret[axis] = Component(axis)[index];
+  }
+}
+
+void CVectorStream::SetVector(uint32_t index, const vector_t &v) {
+  assert(index < m_count);
+  for (uint32_t axis = 0; axis < 4; ++axis) {
+    Component(axis)[index] = v[axis];
+  }
+}
+
+void CVectorStream::SetVectors(const vector_t *vectors, uint32_t count) {
+  using namespace Simd;
+  // Every vector, padding included, is written below, so only reallocate.
+  if (((count + 3) & ~3u) != m_paddedCount || m_storage.empty()) {
+    m_count = 0;
+    Resize(count);
+  }
+  m_count = count;
+  const components_t components = Components(*this);
+  for (uint32_t first = 0; first < m_paddedCount; first += 4) {
+    float4 rows[4];
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      rows[lane] = first + lane < count ? LoadUnaligned(vectors[first + lane])
+                                        : Set(0.f, 0.f, 0.f, 1.f);
+    }
+    Transpose(rows[0], rows[1], rows[2], rows[3]);
+    StoreGroup(rows, first, components);
+  }
+}
+
+void CVectorStream::GetVectors(vector_t *ret) const {
+  using namespace Simd;
+  const components_t components = Components(*this);
+  for (uint32_t first = 0; first < m_count; first += 4) {
+    float4 rows[4];
+    LoadGroup(components, first, rows);
+    Transpose(rows[0], rows[1], rows[2], rows[3]);
+    const uint32_t lanes = m_count - first < 4 ? m_count - first : 4;
+    for (uint32_t lane = 0; lane < lanes; ++lane) {
+      StoreUnaligned(ret[first + lane], rows[lane]);
+    }
+  }
+}
+
+void VectorsAddVectors(const CVectorStream &a, const CVectorStream &b,
+                       CVectorStream &ret) {
+  assert(a.GetCount() == b.GetCount());
+  ret.Resize(a.GetCount());
+  const components_t a_axes = Components(a);
+  const components_t b_axes = Components(b);
+  const components_t ret_axes = Components(ret);
+  const uint32_t padded_count = a.GetPaddedCount();
+  for (uint32_t first = 0; first < padded_count; first += 4) {
+    float4 u[4], v[4];
+    LoadGroup(a_axes, first, u);
+    LoadGroup(b_axes, first, v);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      u[axis] = Simd::Add(u[axis], v[axis]);
+    }
+    StoreGroup(u, first, ret_axes);
+  }
+}
+
+void VectorsSubtractVectors(const CVectorStream &a, const CVectorStream &b,
+                            CVectorStream &ret) {
+  assert(a.GetCount() == b.GetCount());
+  ret.Resize(a.GetCount());
+  const components_t a_axes = Components(a);
+  const components_t b_axes = Components(b);
+  const components_t ret_axes = Components(ret);
+  const uint32_t padded_count = a.GetPaddedCount();
+  for (uint32_t first = 0; first < padded_count; first += 4) {
+    float4 u[4], v[4];
+    LoadGroup(a_axes, first, u);
+    LoadGroup(b_axes, first, v);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      u[axis] = Simd::Sub(u[axis], v[axis]);
+    }
+    StoreGroup(u, first, ret_axes);
+  }
+}
+
+void ScalarMultVectors(const CVectorStream &a, float scalar,
+                       CVectorStream &ret) {
+  ret.Resize(a.GetCount());
+  const components_t a_axes = Components(a);
+  const components_t ret_axes = Components(ret);
+  const uint32_t padded_count = a.GetPaddedCount();
+  const float4 s = Simd::Set1(scalar);
+  for (uint32_t first = 0; first < padded_count; first += 4) {
+    float4 u[4];
+    LoadGroup(a_axes, first, u);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      u[axis] = Simd::Mul(u[axis], s);
+    }
+    StoreGroup(u, first, ret_axes);
+  }
+}
+
+void VectorsCrossVectors(const CVectorStream &a, const CVectorStream &b,
+                         CVectorStream &ret) {
+  using namespace Simd;
+  assert(a.GetCount() == b.GetCount());
+  ret.Resize(a.GetCount());
+  const components_t a_axes = Components(a);
+  const components_t b_axes = Components(b);
+  const components_t ret_axes = Components(ret);
+  const uint32_t padded_count = a.GetPaddedCount();
+  for (uint32_t first = 0; first < padded_count; first += 4) {
+    float4 u[4], v[4];
+    LoadGroup(a_axes, first, u);
+    LoadGroup(b_axes, first, v);
+    const float4 cross[4] = {Sub(Mul(u[1], v[2]), Mul(u[2], v[1])),
+                             Sub(Mul(u[2], v[0]), Mul(u[0], v[2])),
+                             Sub(Mul(u[0], v[1]), Mul(u[1], v[0])), u[3]};
+    StoreGroup(cross, first, ret_axes);
+  }
+}
+
+void VectorsNormalize(const CVectorStream &a, CVectorStream &ret) {
+  using namespace Simd;
+  ret.Resize(a.GetCount());
+  const components_t a_axes = Components(a);
+  const components_t ret_axes = Components(ret);
+  const uint32_t padded_count = a.GetPaddedCount();
+  for (uint32_t first = 0; first < padded_count; first += 4) {
+    float4 u[4];
+    LoadGroup(a_axes, first, u);
+    const float4 length_squared = Dot(u, u);
+    // Divides as VectorNormalize does, masking out zero lengths.
+    const float4 scale =
+        And(CmpGt(length_squared, Zero()),
+            Div(Set1(1.f), Sqrt(Max(length_squared, Set1(FLT_MIN)))));
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      u[axis] = Mul(u[axis], scale);
+    }
+    StoreGroup(u, first, ret_axes);
+  }
+}
+
+void VectorsNormalizeFast(const CVectorStream &a, CVectorStream &ret) {
+  using namespace Simd;
+  ret.Resize(a.GetCount());
+  const components_t a_axes = Components(a);
+  const components_t ret_axes = Components(ret);
+  const uint32_t padded_count = a.GetPaddedCount();
+  for (uint32_t first = 0; first < padded_count; first += 4) {
+    float4 u[4];
+    LoadGroup(a_axes, first, u);
+    const float4 scale = RsqrtRefinedOrZero(Dot(u, u));
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      u[axis] = Mul(u[axis], scale);
+    }
+    StoreGroup(u, first, ret_axes);
+  }
+}
+
+void VectorsDotVectors(const CVectorStream &a, const CVectorStream &b,
+                       float *ret) {
+  assert(a.GetCount() == b.GetCount());
+  const components_t a_axes = Components(a);
+  const components_t b_axes = Components(b);
+  const uint32_t count = a.GetCount();
+  for (uint32_t first = 0; first < count; first += 4) {
+    float4 u[4], v[4];
+    LoadGroup(a_axes, first, u);
+    LoadGroup(b_axes, first, v);
+    StoreLanes(ret + first, count - first < 4 ? count - first : 4, Dot(u, v));
+  }
+}
+
+void VectorsLength(const CVectorStream &a, float *ret) {
+  const components_t a_axes = Components(a);
+  const uint32_t count = a.GetCount();
+  for (uint32_t first = 0; first < count; first += 4) {
+    float4 u[4];
+    LoadGroup(a_axes, first, u);
+    StoreLanes(ret + first, count - first < 4 ? count - first : 4,
+               Simd::Sqrt(Dot(u, u)));
+  }
+}
+
+}  // namespace XboxMath
@@ -0,0 +1,104 @@
+#ifndef XBOX_MATH_VECTOR_STREAM_H_
+#define XBOX_MATH_VECTOR_STREAM_H_
+
+#include <vector>
+
+#include "xbox_math_types.h"
+
+namespace XboxMath {
+
+//! A sequence of vectors in structure of arrays layout, for applying the
+//! operations of xbox_math_vector.h to many vectors four at a time.
+//!
+//! The x, y, z and w components are held in separate 16-byte aligned arrays,
+//! each padded to a multiple of 4 vectors. Padding vectors take part in batch
+//! operations, so every function here processes whole groups of 4 without a
+//! scalar tail, but their values are otherwise unspecified.
+class CVectorStream {
+ public:
+  //! Creates a stream of `count` (0, 0, 0, 1) vectors.
+  explicit CVectorStream(uint32_t count = 0);
+  CVectorStream(const CVectorStream &other);
+  CVectorStream(CVectorStream &&other) noexcept;
+  CVectorStream &operator=(const CVectorStream &other);
+  CVectorStream &operator=(CVectorStream &&other) noexcept;
+
+  //! Changes the number of vectors, keeping the first ones and setting any
+  //! new ones to (0, 0, 0, 1).
+  void Resize(uint32_t count);
+
+  [[nodiscard]] uint32_t GetCount() const { return m_count; }
+  //! Returns the count rounded up to a multiple of 4, the length of each
+  //! component array.
+  [[nodiscard]] uint32_t GetPaddedCount() const { return m_paddedCount; }
+
+  [[nodiscard]] float *GetX() { return Component(0); }
+  [[nodiscard]] float *GetY() { return Component(1); }
+  [[nodiscard]] float *GetZ() { return Component(2); }
+  [[nodiscard]] float *GetW() { return Component(3); }
+  [[nodiscard]] const float *GetX() const { return Component(0); }
+  [[nodiscard]] const float *GetY() const { return Component(1); }
+  [[nodiscard]] const float *GetZ() const { return Component(2); }
+  [[nodiscard]] const float *GetW() const { return Component(3); }
+
+  void GetVector(uint32_t index, vector_t &ret) const;
+  void SetVector(uint32_t index, const vector_t &v);
+
+  //! Converts `count` vectors from array of structures layout, resizing the
+  //! stream to hold them.
+  void SetVectors(const vector_t *vectors, uint32_t count);
+
+  //! Converts the stream to array of structures layout. `ret` must hold
+  //! GetCount() vectors.
+  void GetVectors(vector_t *ret) const;
+
+ private:
+  [[nodiscard]] float *Component(uint32_t axis) {
+    return AlignedData() + axis * m_paddedCount;
+  }
+  [[nodiscard]] const float *Component(uint32_t axis) const {
+    return const_cast<CVectorStream *>(this)->Component(axis);
+  }
+  float *AlignedData();
+
+  uint32_t m_count;
+  uint32_t m_paddedCount;
+  // The four component arrays, from the first 16-byte aligned float on.
+  std::vector<float> m_storage;
+};
+
+// Batch equivalents of the functions in xbox_math_vector.h. Each applies to
+// every vector of its input streams, which must have the same count, and
+// resizes `ret` to match. `ret` may be one of the inputs. Like their single
+// vector counterparts they operate on x, y and z; the w of each result is
+// copied from `a`.
+
+void VectorsAddVectors(const CVectorStream &a, const CVectorStream &b,
+                       CVectorStream &ret);
+void VectorsSubtractVectors(const CVectorStream &a, const CVectorStream &b,
+                            CVectorStream &ret);
+void ScalarMultVectors(const CVectorStream &a, float scalar,
+                       CVectorStream &ret);
+void VectorsCrossVectors(const CVectorStream &a, const CVectorStream &b,
+                         CVectorStream &ret);
+
+//! Scales every vector of `a` to unit length. Unlike VectorNormalize, zero
+//! length vectors are left as zero rather than becoming NaN.
+void VectorsNormalize(const CVectorStream &a, CVectorStream &ret);
+
+//! As VectorsNormalize, with VectorNormalizeFastSafe's reciprocal square root
+//! estimate and error bound.
+void VectorsNormalizeFast(const CVectorStream &a, CVectorStream &ret);
+
+//! Writes the dot product of each pair of vectors to `ret`, which must hold
+//! a.GetCount() floats.
+void VectorsDotVectors(const CVectorStream &a, const CVectorStream &b,
+                       float *ret);
+
+//! Writes the length of each vector to `ret`, which must hold a.GetCount()
+//! floats.
+void VectorsLength(const CVectorStream &a, float *ret);
+
+}  // namespace XboxMath
+
+#endif  // XBOX_MATH_VECTOR_STREAM_H_
@@ -0,0 +1,206 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+#include "xbox_math_animation.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_animation_suite)
+
+#define TOLERANCE 1e-5f
+#define QUANTIZED_TOLERANCE 1e-3f
+
+#define VECTOR_TEST(v, x, y, z, w, t)                         \
+  BOOST_TEST((v)[0] == (x), boost::test_tools::tolerance(t)); \
+  BOOST_TEST((v)[1] == (y), boost::test_tools::tolerance(t)); \
+  BOOST_TEST((v)[2] == (z), boost::test_tools::tolerance(t)); \
+  BOOST_TEST((v)[3] == (w), boost::test_tools::tolerance(t))
+
+// q and -q represent the same rotation.
+#define QUATERNION_ROTATION_TEST(a, b)                        \
+  BOOST_TEST(fabsf(QuaternionDotQuaternion((a), (b))) == 1.f, \
+             boost::test_tools::tolerance(QUANTIZED_TOLERANCE * 0.1f))
+
+static constexpr uint32_t kKeyCount = 5;
+static const float kTimes[kKeyCount] = {0.f, 0.5f, 1.f, 1.5f, 2.f};
+static const vector_t kTranslations[kKeyCount] = {
+    {0.f, 0.f, 0.f, 1.f},
+    {1.f, -2.f, 10.f, 1.f},
+    {2.f, -4.f, 20.f, 1.f},
+    {3.f, -6.f, 30.f, 1.f},
+    {4.f, -8.f, 40.f, 1.f},
+};
+
+static void BuildRotations(CQuaternion (&rotations)[kKeyCount]) {
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    rotations[i].SetEuler(10.f * i, -15.f * i, 5.f * i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(smallest_three_round_trip) {
+  const CQuaternion inputs[] = {
+      CQuaternion(),
+      CQuaternion(0.f, 0.f, 0.f, -1.f),
+      CQuaternion(45.f, 30.f, -60.f),
+      CQuaternion(-170.f, 80.f, 10.f),
+      CQuaternion(0.5f, -0.5f, 0.5f, -0.5f),
+  };
+
+  for (const auto &input : inputs) {
+    uint16_t packed[3];
+    QuaternionPackSmallestThree(input, packed);
+
+    CQuaternion result;
+    QuaternionUnpackSmallestThree(packed, result);
+
+    BOOST_TEST(result.GetLength() == 1.f,
+               boost::test_tools::tolerance(QUANTIZED_TOLERANCE));
+    QUATERNION_ROTATION_TEST(result, input);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(add_track_rejects_unordered_times) {
+  CQuaternion rotations[kKeyCount];
+  BuildRotations(rotations);
+  const float times[kKeyCount] = {0.f, 1.f, 0.5f, 1.5f, 2.f};
+
+  CAnimationClip clip;
+  BOOST_TEST(!clip.AddTrack(times, rotations, kTranslations, kKeyCount));
+  BOOST_TEST(!clip.AddTrack(kTimes, rotations, kTranslations, 0));
+  BOOST_TEST(clip.GetTrackCount() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(sample_track_at_keys) {
+  CQuaternion rotations[kKeyCount];
+  BuildRotations(rotations);
+
+  CAnimationClip clip;
+  BOOST_TEST(clip.AddTrack(kTimes, rotations, kTranslations, kKeyCount));
+  BOOST_TEST(clip.GetDuration() == 2.f);
+
+  animationcursor_t cursor;
+  AnimationCursorReset(cursor);
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    CQuaternion rotation;
+    vector_t translation;
+    clip.SampleTrack(0, kTimes[i], cursor, rotation, translation);
+
+    QUATERNION_ROTATION_TEST(rotation, rotations[i]);
+    VECTOR_TEST(translation, kTranslations[i][0], kTranslations[i][1],
+                kTranslations[i][2], 1.f, QUANTIZED_TOLERANCE);
+    BOOST_TEST(cursor.m_key == i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sample_track_interpolates_between_keys) {
+  CQuaternion rotations[kKeyCount];
+  BuildRotations(rotations);
+
+  CAnimationClip clip;
+  BOOST_TEST(clip.AddTrack(kTimes, rotations, kTranslations, kKeyCount));
+
+  animationcursor_t cursor;
+  AnimationCursorReset(cursor);
+  CQuaternion rotation;
+  vector_t translation;
+  clip.SampleTrack(0, 1.25f, cursor, rotation, translation);
+
+  BOOST_TEST(cursor.m_key == 2);
+  VECTOR_TEST(translation, 2.5f, -5.f, 25.f, 1.f, QUANTIZED_TOLERANCE);
+
+  // Halfway between two keys nlerp and slerp agree.
+  CQuaternion expected = rotations[2] + rotations[3];
+  expected.Normalize();
+  QUATERNION_ROTATION_TEST(rotation, expected);
+}
+
+BOOST_AUTO_TEST_CASE(sample_track_clamps_out_of_range_times) {
+  CQuaternion rotations[kKeyCount];
+  BuildRotations(rotations);
+
+  CAnimationClip clip;
+  BOOST_TEST(clip.AddTrack(kTimes, rotations, kTranslations, kKeyCount));
+
+  animationcursor_t cursor;
+  AnimationCursorReset(cursor);
+  CQuaternion rotation;
+  vector_t translation;
+
+  clip.SampleTrack(0, -1.f, cursor, rotation, translation);
+  BOOST_TEST(cursor.m_key == 0);
+  VECTOR_TEST(translation, 0.f, 0.f, 0.f, 1.f, QUANTIZED_TOLERANCE);
+
+  clip.SampleTrack(0, 10.f, cursor, rotation, translation);
+  BOOST_TEST(cursor.m_key == kKeyCount - 1);
+  VECTOR_TEST(translation, 4.f, -8.f, 40.f, 1.f, QUANTIZED_TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE(sample_track_seeks_with_stale_cursor) {
+  static constexpr uint32_t kLongKeyCount = 64;
+  float times[kLongKeyCount];
+  CQuaternion rotations[kLongKeyCount];
+  vector_t translations[kLongKeyCount];
+  for (uint32_t i = 0; i < kLongKeyCount; ++i) {
+    times[i] = static_cast<float>(i) * 0.25f;
+    rotations[i].SetEuler(static_cast<float>(i), 0.f, 0.f);
+    VectorSetVector(translations[i], static_cast<float>(i), 0.f, 0.f);
+  }
+
+  CAnimationClip clip;
+  BOOST_TEST(clip.AddTrack(times, rotations, translations, kLongKeyCount));
+
+  animationcursor_t cursor;
+  AnimationCursorReset(cursor);
+  CQuaternion rotation;
+  vector_t translation;
+
+  // Jump forward past the linear scan window.
+  clip.SampleTrack(0, 12.1f, cursor, rotation, translation);
+  BOOST_TEST(cursor.m_key == 48);
+  BOOST_TEST(translation[0] == 48.4f,
+             boost::test_tools::tolerance(QUANTIZED_TOLERANCE));
+
+  // Then backwards.
+  clip.SampleTrack(0, 2.6f, cursor, rotation, translation);
+  BOOST_TEST(cursor.m_key == 10);
+  BOOST_TEST(translation[0] == 10.4f,
+             boost::test_tools::tolerance(QUANTIZED_TOLERANCE));
+}
+
+BOOST_AUTO_TEST_CASE(sample_all_tracks_matches_sample_track) {
+  CQuaternion rotations[kKeyCount];
+  BuildRotations(rotations);
+  vector_t offset_translations[kKeyCount];
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    VectorSetVector(offset_translations[i], kTranslations[i][0] + 100.f,
+                    kTranslations[i][1], kTranslations[i][2] * 0.5f);
+  }
+
+  CAnimationClip clip;
+  BOOST_TEST(clip.AddTrack(kTimes, rotations, kTranslations, kKeyCount));
+  BOOST_TEST(
+      clip.AddTrack(kTimes, rotations, offset_translations, kKeyCount));
+
+  animationcursor_t cursors[2];
+  AnimationCursorReset(cursors[0]);
+  AnimationCursorReset(cursors[1]);
+  CQuaternion all_rotations[2];
+  vector_t all_translations[2];
+  clip.SampleAllTracks(0.75f, cursors, all_rotations, all_translations);
+
+  for (uint32_t track = 0; track < 2; ++track) {
+    animationcursor_t cursor;
+    AnimationCursorReset(cursor);
+    CQuaternion rotation;
+    vector_t translation;
+    clip.SampleTrack(track, 0.75f, cursor, rotation, translation);
+
+    BOOST_TEST(cursor.m_key == cursors[track].m_key);
+    VECTOR_TEST(all_translations[track], translation[0], translation[1],
+                translation[2], translation[3], TOLERANCE);
+    QUATERNION_ROTATION_TEST(all_rotations[track], rotation);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
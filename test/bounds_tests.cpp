@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_bounds.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_bounds_suite)
+
+static constexpr auto kTolerance = 1e-4f;
+
+// Not a multiple of 4.
+static constexpr uint32_t kCount = 7;
+
+namespace {
+
+// A non-uniform scale and rotation, in either order, then a translation.
+void RandomMatrix(CRandom &random, bool rotate_first, matrix4_t &ret) {
+  const vector_t scale = {random(0.5f, 2.f), random(0.5f, 2.f),
+                          random(0.5f, 2.f), 1.f};
+  const vector_t rotation = {random(-3.f, 3.f), random(-3.f, 3.f),
+                             random(-3.f, 3.f), 1.f};
+  matrix4_t identity, first, second;
+  MatrixSetIdentity(identity);
+  if (rotate_first) {
+    MatrixRotate(identity, rotation, first);
+    MatrixScale(first, scale, second);
+  } else {
+    MatrixScale(identity, scale, first);
+    MatrixRotate(first, rotation, second);
+  }
+  const vector_t translation = {random(-10.f, 10.f), random(-10.f, 10.f),
+                                random(-10.f, 10.f), 1.f};
+  MatrixTranslate(second, translation, ret);
+}
+
+// Storage for kCount SoA bounds.
+struct SoA {
+  float values[6][kCount];
+
+  boundingspheresoa_t Spheres() {
+    return {values[0], values[1], values[2], values[3]};
+  }
+  aabbsoa_t Boxes() {
+    return {values[0], values[1], values[2],
+            values[3], values[4], values[5]};
+  }
+};
+
+// Checks that each world sphere is centered on the transformed local center
+// and contains transformed points from all over the local sphere's surface.
+void CheckSpheres(const boundingsphere_t *spheres, const matrix4_t *matrices,
+                  uint32_t matrix_stride, SoA &soa) {
+  CRandom random(29);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    const matrix4_t &matrix = matrices[i * matrix_stride];
+    vector_t center;
+    VectorMultMatrix(spheres[i].m_centerPt, matrix, center);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      BOOST_TEST(soa.values[axis][i] == center[axis],
+                 boost::test_tools::tolerance(kTolerance));
+    }
+
+    const vector_t world_center = {soa.values[0][i], soa.values[1][i],
+                                   soa.values[2][i], 1.f};
+    const float world_radius = soa.values[3][i];
+    for (uint32_t sample = 0; sample < 256; ++sample) {
+      vector_t direction = {random(-1.f, 1.f), random(-1.f, 1.f),
+                            random(-1.f, 1.f), 0.f};
+      const float length = VectorLength(direction);
+      if (length < 0.1f) {
+        continue;
+      }
+      vector_t point, transformed;
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        point[axis] = spheres[i].m_centerPt[axis] +
+                      direction[axis] * spheres[i].m_radius / length;
+      }
+      point[3] = 1.f;
+      VectorMultMatrix(point, matrix, transformed);
+      BOOST_TEST(PointDistancePoint(world_center, transformed) <=
+                 world_radius * (1.f + kTolerance));
+    }
+  }
+}
+
+void CheckBoxes(const aabb_t *boxes, const matrix4_t *matrices,
+                uint32_t matrix_stride, SoA &soa) {
+  for (uint32_t i = 0; i < kCount; ++i) {
+    // The box around the transformed corners.
+    float expected[6] = {1e30f, 1e30f, 1e30f, -1e30f, -1e30f, -1e30f};
+    for (uint32_t corner = 0; corner < 8; ++corner) {
+      const vector_t point = {
+          corner & 1 ? boxes[i].m_maxPt[0] : boxes[i].m_minPt[0],
+          corner & 2 ? boxes[i].m_maxPt[1] : boxes[i].m_minPt[1],
+          corner & 4 ? boxes[i].m_maxPt[2] : boxes[i].m_minPt[2], 1.f};
+      vector_t transformed;
+      VectorMultMatrix(point, matrices[i * matrix_stride], transformed);
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        expected[axis] = std::min(expected[axis], transformed[axis]);
+        expected[axis + 3] = std::max(expected[axis + 3], transformed[axis]);
+      }
+    }
+    for (uint32_t j = 0; j < 6; ++j) {
+      BOOST_TEST(soa.values[j][i] == expected[j],
+                 boost::test_tools::tolerance(kTolerance));
+    }
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(transform_bounding_spheres) {
+  CRandom random(13);
+  boundingsphere_t spheres[kCount];
+  matrix4_t matrices[kCount];
+  for (uint32_t i = 0; i < kCount; ++i) {
+    spheres[i] = {{random(-5.f, 5.f), random(-5.f, 5.f), random(-5.f, 5.f),
+                   1.f},
+                  random(0.1f, 3.f)};
+    RandomMatrix(random, i % 2 == 0, matrices[i]);
+  }
+
+  SoA soa;
+  boundingspheresoa_t ret = soa.Spheres();
+  TransformBoundingSpheres(spheres, kCount, matrices, ret);
+  CheckSpheres(spheres, matrices, 1, soa);
+
+  TransformBoundingSpheres(spheres, kCount, matrices[2], ret);
+  CheckSpheres(spheres, &matrices[2], 0, soa);
+}
+
+BOOST_AUTO_TEST_CASE(transform_bounding_spheres_rotate_then_scale) {
+  // A 45 degree turn about z then a stretch along x leaves every row of the
+  // upper 3x3 shorter than the stretch.
+  matrix4_t identity, rotated, matrix;
+  MatrixSetIdentity(identity);
+  const vector_t rotation = {0.f, 0.f, 0.785398163f, 1.f};
+  MatrixRotate(identity, rotation, rotated);
+  const vector_t scale = {2.f, 1.f, 1.f, 1.f};
+  MatrixScale(rotated, scale, matrix);
+
+  boundingsphere_t spheres[kCount];
+  for (uint32_t i = 0; i < kCount; ++i) {
+    spheres[i] = Sphere(static_cast<float>(i), 1.f, -2.f, 1.f + 0.5f * i);
+  }
+  SoA soa;
+  boundingspheresoa_t ret = soa.Spheres();
+  TransformBoundingSpheres(spheres, kCount, matrix, ret);
+  CheckSpheres(spheres, &matrix, 0, soa);
+  BOOST_TEST(soa.values[3][0] == 2.f, boost::test_tools::tolerance(kTolerance));
+
+  // Rotation with uniform scale keeps the bound exact.
+  const vector_t uniform = {1.5f, 1.5f, 1.5f, 1.f};
+  const vector_t turn = {0.3f, -1.2f, 2.f, 1.f};
+  MatrixScale(identity, uniform, rotated);
+  MatrixRotate(rotated, turn, matrix);
+  TransformBoundingSpheres(spheres, kCount, matrix, ret);
+  CheckSpheres(spheres, &matrix, 0, soa);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    BOOST_TEST(soa.values[3][i] == spheres[i].m_radius * 1.5f,
+               boost::test_tools::tolerance(kTolerance));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(transform_aabbs) {
+  CRandom random(13);
+  aabb_t boxes[kCount];
+  matrix4_t matrices[kCount];
+  for (uint32_t i = 0; i < kCount; ++i) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      boxes[i].m_minPt[axis] = random(-5.f, 0.f);
+      boxes[i].m_maxPt[axis] = random(0.f, 5.f);
+    }
+    boxes[i].m_minPt[3] = boxes[i].m_maxPt[3] = 1.f;
+    RandomMatrix(random, i % 2 == 0, matrices[i]);
+  }
+
+  SoA soa;
+  aabbsoa_t ret = soa.Boxes();
+  TransformAABBs(boxes, kCount, matrices, ret);
+  CheckBoxes(boxes, matrices, 1, soa);
+
+  TransformAABBs(boxes, kCount, matrices[4], ret);
+  CheckBoxes(boxes, &matrices[4], 0, soa);
+}
+
+namespace {
+
+// The farthest `points` lie from `sphere`'s surface, negative if inside.
+float MaxOutside(const boundingsphere_t &sphere, const vertex_t *points,
+                 uint32_t count) {
+  float ret = -sphere.m_radius;
+  for (uint32_t i = 0; i < count; ++i) {
+    ret = std::max(ret, PointDistancePoint(sphere.m_centerPt, points[i]) -
+                            sphere.m_radius);
+  }
+  return ret;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(bounding_sphere_from_points) {
+  // Points on the surface of a stretched and offset unit sphere, then a few
+  // inside it. Not a multiple of 4.
+  CRandom random(13);
+  std::vector<float> storage;
+  for (uint32_t i = 0; i < 1001; ++i) {
+    const float z = random(-1.f, 1.f);
+    const float angle = random(0.f, 6.2831853f);
+    const float r = i % 10 == 0 ? random(0.f, 1.f) : 1.f;
+    const float xy = sqrtf(1.f - z * z) * r;
+    storage.insert(storage.end(), {3.f + xy * cosf(angle),
+                                   -2.f + 0.7f * xy * sinf(angle),
+                                   5.f + 0.5f * z * r, 1.f});
+  }
+  const auto *points = reinterpret_cast<const vertex_t *>(storage.data());
+  const auto count = static_cast<uint32_t>(storage.size() / 4);
+
+  boundingsphere_t ritter, epos;
+  BOOST_TEST(BoundingSphereFromPointsRitter(points, count, ritter));
+  BOOST_TEST(BoundingSphereFromPointsEPOS(points, count, epos));
+  BOOST_TEST(MaxOutside(ritter, points, count) <= 1e-5f);
+  BOOST_TEST(MaxOutside(epos, points, count) <= 1e-5f);
+
+  // The minimum sphere has a radius just under 1, as the samples miss the
+  // extremes along x.
+  BOOST_TEST(ritter.m_radius >= 0.99f);
+  BOOST_TEST(ritter.m_radius <= 1.2f);
+  BOOST_TEST(epos.m_radius >= 0.99f);
+  BOOST_TEST(epos.m_radius <= 1.05f);
+  BOOST_TEST(epos.m_radius <= ritter.m_radius);
+  BOOST_TEST(epos.m_centerPt[3] == 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(bounding_sphere_from_few_points) {
+  const vertex_t points[3] = {
+      {1.f, 2.f, 3.f, 1.f}, {3.f, 2.f, 3.f, 1.f}, {2.f, 2.f, 3.5f, 1.f}};
+  boundingsphere_t sphere;
+  BOOST_TEST(!BoundingSphereFromPointsRitter(points, 0, sphere));
+  BOOST_TEST(!BoundingSphereFromPointsEPOS(points, 0, sphere));
+
+  BOOST_TEST(BoundingSphereFromPointsRitter(points, 1, sphere));
+  BOOST_TEST(sphere.m_radius == 0.f);
+  BOOST_TEST(sphere.m_centerPt[0] == 1.f);
+
+  for (uint32_t count = 2; count <= 3; ++count) {
+    BOOST_TEST(BoundingSphereFromPointsEPOS(points, count, sphere));
+    BOOST_TEST(sphere.m_radius == 1.f, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(sphere.m_centerPt[0] == 2.f,
+               boost::test_tools::tolerance(1e-5f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(bounding_sphere_merge) {
+  const boundingsphere_t a = {{0.f, 0.f, 0.f, 1.f}, 1.f};
+  const boundingsphere_t b = {{4.f, 0.f, 0.f, 1.f}, 2.f};
+  const boundingsphere_t inside = {{0.5f, 0.f, 0.f, 1.f}, 0.5f};
+
+  boundingsphere_t merged;
+  BoundingSphereMerge(a, b, merged);
+  // From x = -1 to x = 6.
+  BOOST_TEST(merged.m_radius == 3.5f, boost::test_tools::tolerance(1e-5f));
+  BOOST_TEST(merged.m_centerPt[0] == 2.5f,
+             boost::test_tools::tolerance(1e-5f));
+  BOOST_TEST(merged.m_centerPt[1] == 0.f);
+
+  BoundingSphereMerge(a, inside, merged);
+  BOOST_TEST(merged.m_radius == 1.f);
+  BOOST_TEST(merged.m_centerPt[0] == 0.f);
+  BoundingSphereMerge(inside, a, merged);
+  BOOST_TEST(merged.m_radius == 1.f);
+  BoundingSphereMerge(a, a, merged);
+  BOOST_TEST(merged.m_radius == 1.f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
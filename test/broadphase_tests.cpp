@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <utility>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_broadphase.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_broadphase_suite)
+
+namespace {
+
+typedef std::pair<uint32_t, uint32_t> Pair;
+
+struct Scene {
+  CSweepAndPrune broadphase;
+  std::vector<boundingsphere_t> spheres;  // Indexed by handle.
+  std::vector<bool> live;
+  CRandom random{21};
+
+  boundingsphere_t RandomSphere() {
+    boundingsphere_t ret;
+    ret.m_centerPt[0] = random(-30.f, 30.f);
+    ret.m_centerPt[1] = random(-10.f, 10.f);
+    ret.m_centerPt[2] = random(-10.f, 10.f);
+    ret.m_centerPt[3] = 1.f;
+    ret.m_radius = random(0.5f, 3.f);
+    return ret;
+  }
+
+  void Add(const boundingsphere_t &sphere) {
+    const uint32_t handle = broadphase.Add(sphere);
+    if (handle >= spheres.size()) {
+      spheres.resize(handle + 1);
+      live.resize(handle + 1);
+    }
+    BOOST_TEST(!live[handle]);
+    spheres[handle] = sphere;
+    live[handle] = true;
+  }
+
+  void CheckPairs() {
+    std::vector<broadphasepair_t> pairs;
+    const uint32_t count = broadphase.FindPairs(pairs);
+    BOOST_TEST(count == pairs.size());
+    std::vector<Pair> found;
+    for (const auto &pair : pairs) {
+      BOOST_TEST(pair.m_first < pair.m_second);
+      found.emplace_back(pair.m_first, pair.m_second);
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<Pair> expected;
+    for (uint32_t i = 0; i < spheres.size(); ++i) {
+      for (uint32_t j = i + 1; j < spheres.size(); ++j) {
+        const float reach = spheres[i].m_radius + spheres[j].m_radius;
+        if (live[i] && live[j] &&
+            PointDistanceSquaredPoint(spheres[i].m_centerPt,
+                                      spheres[j].m_centerPt) <=
+                reach * reach) {
+          expected.emplace_back(i, j);
+        }
+      }
+    }
+    BOOST_TEST(found == expected);
+  }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(find_pairs) {
+  Scene scene;
+  for (uint32_t i = 0; i < 150; ++i) {
+    scene.Add(scene.RandomSphere());
+  }
+  BOOST_TEST(scene.broadphase.GetObjectCount() == 150u);
+  scene.CheckPairs();
+}
+
+BOOST_AUTO_TEST_CASE(touching_spheres) {
+  Scene scene;
+  scene.Add(Sphere(0.f, 0.f, 0.f, 1.f));
+  scene.Add(Sphere(2.f, 0.f, 0.f, 1.f));   // Touching the first.
+  scene.Add(Sphere(0.f, 5.f, 0.f, 1.f));   // Overlapping it only along x.
+  scene.Add(Sphere(0.f, 0.f, 0.f, 10.f));  // Containing the others.
+  std::vector<broadphasepair_t> pairs;
+  BOOST_TEST(scene.broadphase.FindPairs(pairs) == 4u);
+  scene.CheckPairs();
+}
+
+BOOST_AUTO_TEST_CASE(moving_spheres) {
+  Scene scene;
+  for (uint32_t i = 0; i < 150; ++i) {
+    scene.Add(scene.RandomSphere());
+  }
+  for (uint32_t frame = 0; frame < 10; ++frame) {
+    for (uint32_t handle = 0; handle < scene.spheres.size(); ++handle) {
+      // Mostly small steps, sometimes jumps across the whole scene.
+      boundingsphere_t &sphere = scene.spheres[handle];
+      if (handle % 10 == frame) {
+        sphere = scene.RandomSphere();
+      } else {
+        sphere.m_centerPt[0] += scene.random(-1.f, 1.f);
+        sphere.m_centerPt[1] += scene.random(-1.f, 1.f);
+      }
+      scene.broadphase.Update(handle, sphere);
+    }
+    scene.CheckPairs();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(add_and_remove) {
+  Scene scene;
+  for (uint32_t i = 0; i < 100; ++i) {
+    scene.Add(scene.RandomSphere());
+  }
+  scene.CheckPairs();
+  for (uint32_t round = 0; round < 3; ++round) {
+    for (uint32_t handle = round; handle < 100; handle += 5) {
+      if (scene.live[handle]) {
+        scene.broadphase.Remove(handle);
+        scene.live[handle] = false;
+      }
+    }
+    // Some handles are reused before the broadphase sorts again.
+    for (uint32_t i = 0; i < 10; ++i) {
+      scene.Add(scene.RandomSphere());
+    }
+    BOOST_TEST(scene.spheres.size() == 100u);
+    BOOST_TEST(scene.broadphase.GetObjectCount() ==
+               std::count(scene.live.begin(), scene.live.end(), true));
+    scene.CheckPairs();
+  }
+
+  scene.broadphase.Clear();
+  std::vector<broadphasepair_t> pairs;
+  BOOST_TEST(scene.broadphase.FindPairs(pairs) == 0u);
+  BOOST_TEST(scene.broadphase.GetObjectCount() == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
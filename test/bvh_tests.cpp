@@ -0,0 +1,129 @@
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_bvh.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_bvh_suite)
+
+namespace {
+
+struct Ray {
+  ray_t value;
+};
+
+struct Mesh {
+  std::vector<float> vertices;  // 4 floats per vertex.
+  std::vector<uint32_t> indices;
+  std::vector<Ray> rays;
+
+  CRandom random{777};
+
+  // Builds a soup of small random triangles plus rays that start outside of
+  // it.
+  explicit Mesh(uint32_t triangle_count) {
+    for (uint32_t i = 0; i < triangle_count; ++i) {
+      const float cx = random(-20.f, 20.f);
+      const float cy = random(-20.f, 20.f);
+      const float cz = random(-20.f, 20.f);
+      for (uint32_t corner = 0; corner < 3; ++corner) {
+        indices.push_back(static_cast<uint32_t>(vertices.size() / 4));
+        vertices.push_back(cx + random(-1.5f, 1.5f));
+        vertices.push_back(cy + random(-1.5f, 1.5f));
+        vertices.push_back(cz + random(-1.5f, 1.5f));
+        vertices.push_back(1.f);
+      }
+    }
+
+    for (uint32_t i = 0; i < 500; ++i) {
+      Ray ray;
+      VectorSetVector(ray.value.m_origin, random(-30.f, 30.f),
+                      random(-30.f, 30.f), -40.f);
+      VectorSetVector(ray.value.m_direction, random(-0.5f, 0.5f),
+                      random(-0.5f, 0.5f), 1.f, 0.f);
+      VectorNormalize(ray.value.m_direction);
+      ray.value.m_direction[3] = 0.f;
+      rays.push_back(ray);
+    }
+  }
+
+  const vertex_t *Vertices() const {
+    return reinterpret_cast<const vertex_t *>(vertices.data());
+  }
+  uint32_t VertexCount() const {
+    return static_cast<uint32_t>(vertices.size() / 4);
+  }
+  uint32_t TriangleCount() const {
+    return static_cast<uint32_t>(indices.size() / 3);
+  }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(bvh_rejects_invalid_meshes) {
+  CTriangleBVH bvh;
+  vertex_t vertices[3] = {{0.f, 0.f, 0.f, 1.f},
+                          {1.f, 0.f, 0.f, 1.f},
+                          {0.f, 1.f, 0.f, 1.f}};
+  uint32_t indices[3] = {0, 1, 3};
+  BOOST_TEST(!bvh.Build(vertices, 3, indices, 0));
+  BOOST_TEST(!bvh.Build(vertices, 3, indices, 1));
+
+  indices[2] = 2;
+  BOOST_TEST(bvh.Build(vertices, 3, indices, 1));
+  BOOST_TEST(bvh.GetNodeCount() == 1u);
+  BOOST_TEST(bvh.GetTriangleCount() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(bvh_closest_hit_matches_brute_force) {
+  Mesh mesh(2000);
+  CTriangleBVH bvh;
+  BOOST_TEST(bvh.Build(mesh.Vertices(), mesh.VertexCount(),
+                       mesh.indices.data(), mesh.TriangleCount()));
+  BOOST_TEST(bvh.GetNodeCount() > 1u);
+
+  uint32_t hit_count = 0;
+  for (const Ray &ray : mesh.rays) {
+    rayhit_t expected;
+    RayHitReset(expected);
+    RayIntersectTriangles(ray.value, mesh.Vertices(), mesh.indices.data(),
+                          mesh.TriangleCount(), expected);
+
+    rayhit_t hit;
+    RayHitReset(hit);
+    const bool updated = bvh.IntersectRay(ray.value, hit);
+    BOOST_TEST(updated == (expected.m_index != kRayHitNone));
+    BOOST_TEST(hit.m_index == expected.m_index);
+    if (updated) {
+      ++hit_count;
+      BOOST_TEST(hit.m_distance == expected.m_distance);
+      BOOST_TEST(hit.m_u == expected.m_u);
+      BOOST_TEST(hit.m_v == expected.m_v);
+    }
+  }
+  BOOST_TEST(hit_count > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(bvh_any_hit_matches_closest_hit) {
+  Mesh mesh(2000);
+  CTriangleBVH bvh;
+  BOOST_TEST(bvh.Build(mesh.Vertices(), mesh.VertexCount(),
+                       mesh.indices.data(), mesh.TriangleCount()));
+
+  for (const Ray &ray : mesh.rays) {
+    rayhit_t hit;
+    RayHitReset(hit);
+    const bool closest = bvh.IntersectRay(ray.value, hit);
+    BOOST_TEST(bvh.IntersectRayAny(ray.value, FLT_MAX) == closest);
+    if (closest) {
+      // Nothing can be hit before the closest hit.
+      BOOST_TEST(!bvh.IntersectRayAny(ray.value, hit.m_distance * 0.999f));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+#include "xbox_math_camera.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_util.h"
+
+using namespace XboxMath;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_camera_suite)
+
+static constexpr auto kTolerance = 1e-4f;
+
+#define VECTOR_TEST(v, e)                                                  \
+  BOOST_TEST((v)[0] == (e)[0], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[1] == (e)[1], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[2] == (e)[2], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[3] == (e)[3], boost::test_tools::tolerance(kTolerance))
+
+#define MATRIX_MATRIX_TEST(m, e) \
+  VECTOR_TEST((m)[0], (e)[0]);   \
+  VECTOR_TEST((m)[1], (e)[1]);   \
+  VECTOR_TEST((m)[2], (e)[2]);   \
+  VECTOR_TEST((m)[3], (e)[3])
+
+static void ConfigureCamera(CCamera &camera) {
+  vector_t eye{-0.3f, 1.25f, -5.f, 1.f};
+  vector_t at{0.f, 0.f, 0.f, 1.f};
+  vector_t up{0.f, 1.f, 0.f, 1.f};
+  camera.SetLookAt(eye, at, up);
+  camera.SetPerspective(static_cast<float>(M_PI) * 0.25f, 640.f / 480.f, 1.f,
+                        200.f);
+  camera.SetViewport(640.f, 480.f, static_cast<float>(0xFFFF));
+}
+
+static void BuildExpectedComposite(const CCamera &camera, matrix4_t &ret) {
+  matrix4_t view;
+  CreateD3DLookAtLH(view, camera.GetEye(), camera.GetAt(), camera.GetUp());
+
+  matrix4_t projection;
+  CreateD3DPerspectiveFOVLH(projection, static_cast<float>(M_PI) * 0.25f,
+                            640.f / 480.f, 1.f, 200.f);
+
+  matrix4_t viewport;
+  CreateD3DViewport(viewport, 640.f, 480.f, static_cast<float>(0xFFFF), 0.f,
+                    1.f);
+
+  matrix4_t projection_viewport;
+  MatrixMultMatrix(projection, viewport, projection_viewport);
+  BuildCompositeMatrix(view, projection_viewport, ret);
+}
+
+BOOST_AUTO_TEST_CASE(camera_matches_direct_construction) {
+  CCamera camera;
+  ConfigureCamera(camera);
+
+  matrix4_t expected;
+  BuildExpectedComposite(camera, expected);
+  MATRIX_MATRIX_TEST(camera.GetComposite(), expected);
+
+  matrix4_t expected_inverse;
+  BuildInverseCompositeMatrix(expected, expected_inverse);
+  MATRIX_MATRIX_TEST(camera.GetInverseComposite(), expected_inverse);
+}
+
+BOOST_AUTO_TEST_CASE(camera_rebuilds_after_setters) {
+  CCamera camera;
+  ConfigureCamera(camera);
+
+  // Populate the caches before changing inputs.
+  matrix4_t stale;
+  MatrixCopyMatrix(stale, camera.GetComposite());
+  (void)camera.GetInverseComposite();
+
+  vector_t eye{10.f, 3.f, 2.f, 1.f};
+  camera.SetEye(eye);
+
+  matrix4_t expected;
+  BuildExpectedComposite(camera, expected);
+  MATRIX_MATRIX_TEST(camera.GetComposite(), expected);
+  BOOST_TEST(camera.GetComposite()[3][0] != stale[3][0]);
+
+  matrix4_t expected_inverse;
+  BuildInverseCompositeMatrix(expected, expected_inverse);
+  MATRIX_MATRIX_TEST(camera.GetInverseComposite(), expected_inverse);
+
+  camera.SetViewport(320.f, 240.f, static_cast<float>(0xFFFF));
+  matrix4_t expected_viewport;
+  CreateD3DViewport(expected_viewport, 320.f, 240.f,
+                    static_cast<float>(0xFFFF), 0.f, 1.f);
+  MATRIX_MATRIX_TEST(camera.GetViewport(), expected_viewport);
+}
+
+BOOST_AUTO_TEST_CASE(camera_project_unproject_round_trip) {
+  CCamera camera;
+  ConfigureCamera(camera);
+
+  vector_t world{1.f, -0.5f, 3.f, 1.f};
+  vector_t screen;
+  camera.Project(world, screen);
+
+  vector_t round_trip;
+  camera.Unproject(screen, round_trip);
+  BOOST_TEST(round_trip[0] == world[0], boost::test_tools::tolerance(1e-3f));
+  BOOST_TEST(round_trip[1] == world[1], boost::test_tools::tolerance(1e-3f));
+  BOOST_TEST(round_trip[2] == world[2], boost::test_tools::tolerance(1e-3f));
+}
+
+BOOST_AUTO_TEST_CASE(camera_frustum_is_in_world_space) {
+  CCamera camera;
+  vector_t eye{5.f, 0.f, 5.f, 1.f};
+  vector_t at{5.f, 0.f, 10.f, 1.f};
+  vector_t up{0.f, 1.f, 0.f, 1.f};
+  camera.SetLookAt(eye, at, up);
+  camera.SetPerspective(static_cast<float>(M_PI) * 0.5f, 1.f, 1.f, 100.f);
+
+  const frustum_t &frustum = camera.GetFrustum();
+
+  vector_t in_front{5.f, 0.f, 20.f, 1.f};
+  BOOST_TEST(frustum.PointInFrustum(in_front));
+
+  vector_t behind{5.f, 0.f, 0.f, 1.f};
+  BOOST_TEST(!frustum.PointInFrustum(behind));
+
+  vector_t beyond_far{5.f, 0.f, 200.f, 1.f};
+  BOOST_TEST(!frustum.PointInFrustum(beyond_far));
+
+  vector_t off_to_the_side{40.f, 0.f, 20.f, 1.f};
+  BOOST_TEST(!frustum.PointInFrustum(off_to_the_side));
+
+  // Turning the camera around must rebuild the frustum.
+  vector_t backwards{5.f, 0.f, 0.f, 1.f};
+  camera.SetAt(backwards);
+  BOOST_TEST(!camera.GetFrustum().PointInFrustum(in_front));
+  vector_t far_behind{5.f, 0.f, -20.f, 1.f};
+  BOOST_TEST(camera.GetFrustum().PointInFrustum(far_behind));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,8 @@
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 
 #include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
 
 using namespace XboxMath;
 
@@ -21,6 +23,18 @@ BOOST_AUTO_TEST_SUITE(xbox_math_d3d_suite)
   VECTOR_TEST((m)[2], m31, m32, m33, m34);                                    \
   VECTOR_TEST((m)[3], m41, m42, m43, m44)
 
+// Checks that `m` * `inverse` is the identity matrix.
+static void TestIsInverse(const matrix4_t &m, const matrix4_t &inverse) {
+  matrix4_t product;
+  MatrixMultMatrix(m, inverse, product);
+  for (uint32_t row = 0; row < 4; ++row) {
+    for (uint32_t column = 0; column < 4; ++column) {
+      const float expected = row == column ? 1.f : 0.f;
+      BOOST_TEST(fabsf(product[row][column] - expected) <= TOLERANCE);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_create_world_view) {
   vector_t translation{10.f, 33.f, -0.1234f, 1.0f};
   vector_t rotation{M_PI * 0.5f, M_PI * 0.25f, M_PI, 0.0};
@@ -34,6 +48,40 @@ BOOST_AUTO_TEST_CASE(test_create_world_view) {
               -33.f, 1.f);
 }
 
+BOOST_AUTO_TEST_CASE(test_create_world_view_matches_translate_rotate) {
+  const vector_t translations[] = {{10.f, 33.f, -0.1234f, 1.f},
+                                   {-4.f, 0.5f, 120.f, 1.f},
+                                   {0.f, 0.f, 0.f, 1.f}};
+  const vector_t rotations[] = {{0.3f, -1.2f, 2.5f, 0.f},
+                                {-3.f, 0.75f, -0.1f, 0.f},
+                                {6.f, 4.f, -5.f, 0.f}};
+
+  for (const vector_t &translation : translations) {
+    for (const vector_t &rotation : rotations) {
+      vector_t inv_translation = {-translation[0], -translation[1],
+                                  -translation[2], translation[3]};
+      vector_t inv_rotation = {-rotation[0], -rotation[1], -rotation[2],
+                               rotation[3]};
+      matrix4_t identity;
+      MatrixSetIdentity(identity);
+      matrix4_t translated;
+      MatrixTranslate(identity, inv_translation, translated);
+      matrix4_t expected;
+      MatrixRotate(translated, inv_rotation, expected);
+
+      matrix4_t result;
+      CreateWorldView(translation, rotation, result);
+
+      for (uint32_t row = 0; row < 4; ++row) {
+        for (uint32_t column = 0; column < 4; ++column) {
+          BOOST_TEST(fabsf(result[row][column] - expected[row][column]) <=
+                     1e-4f);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_create_d3d_look_at_lh) {
   vector_t eye{-0.3f, 1.25f, -5.f, 1.f};
   vector_t at{0.f, 0.f, 0.f, 1.f};
@@ -48,6 +96,20 @@ BOOST_AUTO_TEST_CASE(test_create_d3d_look_at_lh) {
               1.49011612e-08f, 5.16260576f, 1.f);
 }
 
+BOOST_AUTO_TEST_CASE(test_create_d3d_look_at_lh_inverse) {
+  vector_t eye{-0.3f, 1.25f, -5.f, 1.f};
+  vector_t at{0.f, 0.f, 0.f, 1.f};
+  vector_t up{0.24253562503633297f, 0.9701425001453319f, 0.0f, 1.f};
+
+  matrix4_t look_at;
+  CreateD3DLookAtLH(look_at, eye, at, up);
+  matrix4_t result;
+  CreateD3DLookAtLHInverse(result, eye, at, up);
+
+  TestIsInverse(look_at, result);
+  VECTOR_TEST(result[3], eye[0], eye[1], eye[2], 1.f);
+}
+
 BOOST_AUTO_TEST_CASE(test_create_d3d_perspective_fov_lh) {
   float fov = 65.f;
   float width = 640.f;
@@ -62,6 +124,35 @@ BOOST_AUTO_TEST_CASE(test_create_d3d_perspective_fov_lh) {
               0.f, 0.f, 1.00769866f, 1.f, 0.f, 0.f, -1.41077805f, 0.f);
 }
 
+BOOST_AUTO_TEST_CASE(test_create_d3d_perspective_fov_lh_inverse) {
+  float fov = 65.f;
+  float width = 640.f;
+  float height = 480.f;
+  float z_near = 1.4f;
+  float z_far = 183.25f;
+
+  matrix4_t projection;
+  CreateD3DPerspectiveFOVLH(projection, fov, width / height, z_near, z_far);
+  matrix4_t result;
+  CreateD3DPerspectiveFOVLHInverse(result, fov, width / height, z_near, z_far);
+
+  TestIsInverse(projection, result);
+}
+
+BOOST_AUTO_TEST_CASE(test_create_d3d_orthographic_lh_inverse) {
+  matrix4_t ortho;
+  CreateD3DOrthographicLH(ortho, -320.f, 320.f, 240.f, -240.f, 1.4f, 183.25f);
+  matrix4_t result;
+  CreateD3DOrthographicLHInverse(result, -320.f, 320.f, 240.f, -240.f, 1.4f,
+                                 183.25f);
+
+  TestIsInverse(ortho, result);
+
+  CreateD3DOrthographicLH(ortho, 10.f, 50.f, 5.f, -20.f, -3.f, 40.f);
+  CreateD3DOrthographicLHInverse(result, 10.f, 50.f, 5.f, -20.f, -3.f, 40.f);
+  TestIsInverse(ortho, result);
+}
+
 BOOST_AUTO_TEST_CASE(test_create_d3d_viewport) {
   float width = 640.f;
   float height = 480.f;
@@ -76,6 +167,22 @@ BOOST_AUTO_TEST_CASE(test_create_d3d_viewport) {
               11917722.f, 0.f, 320.f, 240.f, 91750.3984f, 1.f);
 }
 
+BOOST_AUTO_TEST_CASE(test_create_d3d_viewport_inverse) {
+  float width = 640.f;
+  float height = 480.f;
+  float max_depth_buffer = 65536.f;
+  float z_min = 0.25f;
+  float z_max = 0.75f;
+
+  matrix4_t viewport;
+  CreateD3DViewport(viewport, width, height, max_depth_buffer, z_min, z_max);
+  matrix4_t result;
+  CreateD3DViewportInverse(result, width, height, max_depth_buffer, z_min,
+                           z_max);
+
+  TestIsInverse(viewport, result);
+}
+
 BOOST_AUTO_TEST_CASE(test_create_d3d_standard_viewport_16_bit) {
   float width = 640.f;
   float height = 480.f;
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_depth.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_util.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_depth_suite)
+
+static constexpr auto kTolerance = 1e-3f;
+static constexpr uint32_t kWidth = 13;  // Not a multiple of 4.
+static constexpr uint32_t kHeight = 7;
+
+namespace {
+
+// Decodes a raw depth value directly from its bit layout.
+float ReferenceDecode(DepthBufferFormat format, uint32_t raw) {
+  switch (format) {
+    case kDepthBuffer16Bit:
+    case kDepthBuffer24Bit:
+      return static_cast<float>(raw);
+    case kDepthBuffer16BitFloat: {
+      const int exponent = static_cast<int>(raw >> 12);
+      const float mantissa = static_cast<float>(raw & 0xFFF) / 4096.f;
+      if (!exponent) {
+        return ldexpf(mantissa, -6);
+      }
+      return ldexpf(1.f + mantissa, exponent - 7);
+    }
+    case kDepthBuffer24BitFloat: {
+      const int exponent = static_cast<int>(raw >> 16);
+      const float mantissa = static_cast<float>(raw & 0xFFFF) / 65536.f;
+      if (!exponent) {
+        return ldexpf(mantissa, -126);
+      }
+      return ldexpf(1.f + mantissa, exponent - 127);
+    }
+  }
+  return 0.f;
+}
+
+void CreateStandardViewport(DepthBufferFormat format, matrix4_t &ret) {
+  switch (format) {
+    case kDepthBuffer16Bit:
+      CreateD3DStandardViewport16Bit(ret, kWidth, kHeight);
+      break;
+    case kDepthBuffer16BitFloat:
+      CreateD3DStandardViewport16BitFloat(ret, kWidth, kHeight);
+      break;
+    case kDepthBuffer24Bit:
+      CreateD3DStandardViewport24Bit(ret, kWidth, kHeight);
+      break;
+    case kDepthBuffer24BitFloat:
+      CreateD3DStandardViewport24BitFloat(ret, kWidth, kHeight);
+      break;
+  }
+}
+
+void BuildInverseComposite(DepthBufferFormat format, matrix4_t &ret) {
+  vector_t eye{2.f, 3.f, -8.f, 1.f};
+  vector_t at{0.f, 0.5f, 0.f, 1.f};
+  vector_t up{0.f, 1.f, 0.f, 1.f};
+  matrix4_t view;
+  CreateD3DLookAtLH(view, eye, at, up);
+
+  matrix4_t projection;
+  CreateD3DPerspectiveFOVLH(projection, M_PI * 0.25f,
+                            static_cast<float>(kWidth) / kHeight, 1.f, 200.f);
+  matrix4_t viewport;
+  CreateStandardViewport(format, viewport);
+
+  matrix4_t projection_viewport;
+  MatrixMultMatrix(projection, viewport, projection_viewport);
+  matrix4_t composite;
+  BuildCompositeMatrix(view, projection_viewport, composite);
+  BuildInverseCompositeMatrix(composite, ret);
+}
+
+const DepthBufferFormat kFormats[] = {kDepthBuffer16Bit, kDepthBuffer16BitFloat,
+                                     kDepthBuffer24Bit, kDepthBuffer24BitFloat};
+
+uint32_t MaxRaw(DepthBufferFormat format) {
+  switch (format) {
+    case kDepthBuffer16Bit:
+    case kDepthBuffer16BitFloat:
+      return 0xFFFF;
+    case kDepthBuffer24Bit:
+      return 0xFFFFFF;
+    case kDepthBuffer24BitFloat:
+      return 0x7149F2CA >> 7;
+  }
+  return 0;
+}
+
+// Packs raw values with the depth buffer layout of `format`.
+std::vector<uint8_t> PackRaw(DepthBufferFormat format,
+                             const std::vector<uint32_t> &raw) {
+  const bool is_16_bit =
+      format == kDepthBuffer16Bit || format == kDepthBuffer16BitFloat;
+  std::vector<uint8_t> ret(raw.size() * (is_16_bit ? 2 : 4));
+  for (size_t i = 0; i < raw.size(); ++i) {
+    if (is_16_bit) {
+      const auto value = static_cast<uint16_t>(raw[i]);
+      memcpy(&ret[i * 2], &value, sizeof(value));
+    } else {
+      const uint32_t value = raw[i] << 8;
+      memcpy(&ret[i * 4], &value, sizeof(value));
+    }
+  }
+  return ret;
+}
+
+std::vector<uint32_t> UnpackRaw(DepthBufferFormat format,
+                                const std::vector<uint8_t> &packed) {
+  const bool is_16_bit =
+      format == kDepthBuffer16Bit || format == kDepthBuffer16BitFloat;
+  std::vector<uint32_t> ret(packed.size() / (is_16_bit ? 2 : 4));
+  for (size_t i = 0; i < ret.size(); ++i) {
+    if (is_16_bit) {
+      uint16_t value;
+      memcpy(&value, &packed[i * 2], sizeof(value));
+      ret[i] = value;
+    } else {
+      uint32_t value;
+      memcpy(&value, &packed[i * 4], sizeof(value));
+      ret[i] = value >> 8;
+    }
+  }
+  return ret;
+}
+
+std::vector<uint32_t> Encode(DepthBufferFormat format,
+                             const std::vector<float> &screen_z) {
+  const bool is_16_bit =
+      format == kDepthBuffer16Bit || format == kDepthBuffer16BitFloat;
+  std::vector<uint8_t> packed(screen_z.size() * (is_16_bit ? 2 : 4));
+  EncodeDepthValues(format, screen_z.data(),
+                    static_cast<uint32_t>(screen_z.size()), packed.data());
+  return UnpackRaw(format, packed);
+}
+
+// Raw values to test: every value of the 16-bit formats, and a stride through
+// the 24-bit formats plus the values around their denormal and max boundaries.
+std::vector<uint32_t> TestRawValues(DepthBufferFormat format) {
+  const uint32_t max_raw = MaxRaw(format);
+  std::vector<uint32_t> ret;
+  const uint32_t stride = max_raw > 0xFFFF ? 251 : 1;
+  for (uint32_t raw = 0; raw <= max_raw; raw += stride) {
+    ret.push_back(raw);
+  }
+  const uint32_t boundaries[] = {1, 2, 0xFFFE, 0xFFFF, 0x10000, 0x10001};
+  for (auto raw : boundaries) {
+    if (raw <= max_raw) {
+      ret.push_back(raw);
+    }
+  }
+  ret.push_back(max_raw - 1);
+  ret.push_back(max_raw);
+  return ret;
+}
+
+// Fills a depth buffer with pseudo random values no larger than the format's
+// maximum and checks the reconstruction against UnprojectPoint.
+void TestReconstruction(DepthBufferFormat format) {
+  const bool is_16_bit =
+      format == kDepthBuffer16Bit || format == kDepthBuffer16BitFloat;
+  const uint32_t pixel_size = is_16_bit ? 2 : 4;
+  const uint32_t pitch = kWidth * pixel_size + 8;  // Padded rows.
+  const uint32_t max_raw = MaxRaw(format);
+
+  std::vector<uint8_t> buffer(pitch * kHeight);
+  std::vector<float> depths(kWidth * kHeight);
+  CRandom random(12345);
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      uint32_t raw = (random.NextBits() >> 8) % (max_raw + 1);
+      if (x == 0 && y == 0) {
+        raw = 1;  // Smallest denormal for the float formats.
+      } else if (x == 1 && y == 0) {
+        raw = max_raw;
+      }
+      depths[y * kWidth + x] = ReferenceDecode(format, raw);
+
+      uint8_t *pixel = &buffer[y * pitch + x * pixel_size];
+      if (is_16_bit) {
+        const auto value = static_cast<uint16_t>(raw);
+        memcpy(pixel, &value, sizeof(value));
+      } else {
+        const uint32_t value = (raw << 8) | 0xA5;  // Arbitrary stencil.
+        memcpy(pixel, &value, sizeof(value));
+      }
+    }
+  }
+
+  matrix4_t inverse_composite;
+  BuildInverseComposite(format, inverse_composite);
+
+  std::vector<float> positions(kWidth * kHeight * 4);
+  DepthBufferToWorldPositions(buffer.data(), pitch, format, kWidth, kHeight,
+                              inverse_composite,
+                              reinterpret_cast<vector_t *>(positions.data()));
+
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      const uint32_t index = y * kWidth + x;
+      vector_t screen_point{static_cast<float>(x), static_cast<float>(y),
+                            depths[index], 1.f};
+      vector_t expected;
+      UnprojectPoint(screen_point, inverse_composite, expected);
+
+      const float *actual = &positions[index * 4];
+      for (uint32_t i = 0; i < 4; ++i) {
+        const float tolerance = kTolerance * std::max(1.f, fabsf(expected[i]));
+        BOOST_TEST(fabsf(actual[i] - expected[i]) <= tolerance);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(depth_buffer_max_value_matches_standard_viewports) {
+  for (auto format : kFormats) {
+    matrix4_t viewport;
+    CreateStandardViewport(format, viewport);
+    BOOST_TEST(DepthBufferMaxValue(format) == viewport[2][2]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(depth_buffer_to_world_positions_16_bit) {
+  TestReconstruction(kDepthBuffer16Bit);
+}
+
+BOOST_AUTO_TEST_CASE(depth_buffer_to_world_positions_16_bit_float) {
+  TestReconstruction(kDepthBuffer16BitFloat);
+}
+
+BOOST_AUTO_TEST_CASE(depth_buffer_to_world_positions_24_bit) {
+  TestReconstruction(kDepthBuffer24Bit);
+}
+
+BOOST_AUTO_TEST_CASE(depth_buffer_to_world_positions_24_bit_float) {
+  TestReconstruction(kDepthBuffer24BitFloat);
+}
+
+BOOST_AUTO_TEST_CASE(decode_depth_values) {
+  for (auto format : kFormats) {
+    const std::vector<uint32_t> raw = TestRawValues(format);
+    const std::vector<uint8_t> packed = PackRaw(format, raw);
+    std::vector<float> screen_z(raw.size());
+    DecodeDepthValues(format, packed.data(), static_cast<uint32_t>(raw.size()),
+                      screen_z.data());
+    for (size_t i = 0; i < raw.size(); ++i) {
+      BOOST_TEST(screen_z[i] == ReferenceDecode(format, raw[i]));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(encode_depth_values_round_trips) {
+  for (auto format : kFormats) {
+    const std::vector<uint32_t> raw = TestRawValues(format);
+    std::vector<float> screen_z(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+      screen_z[i] = ReferenceDecode(format, raw[i]);
+    }
+    BOOST_TEST(Encode(format, screen_z) == raw,
+               boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(encode_depth_values_rounds_to_nearest) {
+  for (auto format : kFormats) {
+    const uint32_t max_raw = MaxRaw(format);
+
+    // Values between every pair of neighbouring test values, weighted towards
+    // either neighbour.
+    std::vector<float> screen_z;
+    for (auto raw : TestRawValues(format)) {
+      if (raw == max_raw) {
+        continue;
+      }
+      const float low = ReferenceDecode(format, raw);
+      const float high = ReferenceDecode(format, raw + 1);
+      screen_z.push_back(low + (high - low) * 0.25f);
+      screen_z.push_back(low + (high - low) * 0.75f);
+    }
+    const std::vector<uint32_t> encoded = Encode(format, screen_z);
+
+    for (size_t i = 0; i < screen_z.size(); ++i) {
+      const uint32_t raw = encoded[i];
+      const float error = fabsf(ReferenceDecode(format, raw) - screen_z[i]);
+      if (raw > 0) {
+        BOOST_TEST(error <=
+                   fabsf(ReferenceDecode(format, raw - 1) - screen_z[i]));
+      }
+      if (raw < max_raw) {
+        BOOST_TEST(error <=
+                   fabsf(ReferenceDecode(format, raw + 1) - screen_z[i]));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(encode_depth_values_clamps) {
+  for (auto format : kFormats) {
+    const float max_value = DepthBufferMaxValue(format);
+    const std::vector<float> screen_z = {-1.f, -0.f, max_value,
+                                         max_value * 2.f};
+    const std::vector<uint32_t> expected = {0, 0, MaxRaw(format),
+                                            MaxRaw(format)};
+    BOOST_TEST(Encode(format, screen_z) == expected,
+               boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(encode_depth_values_preserves_neighbours) {
+  // Partial blocks only write `count` values.
+  std::vector<uint16_t> values(8, 0xABCD);
+  const float screen_z[] = {1.f, 2.f, 3.f, 4.f, 5.f};
+  EncodeDepthValues(kDepthBuffer16Bit, screen_z, 5, values.data());
+  const std::vector<uint16_t> expected = {1, 2, 3, 4, 5, 0xABCD, 0xABCD,
+                                          0xABCD};
+  BOOST_TEST(values == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
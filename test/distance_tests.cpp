@@ -0,0 +1,110 @@
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_distance.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_distance_suite)
+
+static constexpr auto kTolerance = 1e-5f;
+
+// Not a multiple of 4 or 32.
+static constexpr uint32_t kCount = 45;
+
+namespace {
+
+struct Points {
+  std::vector<float> storage;  // 4 floats per point.
+
+  explicit Points(uint32_t count, uint32_t seed) : storage(count * 4) {
+    CRandom random(seed);
+    for (float &value : storage) {
+      value = random(-10.f, 10.f);
+    }
+  }
+
+  [[nodiscard]] const vertex_t *Data() const {
+    return reinterpret_cast<const vertex_t *>(storage.data());
+  }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(one_to_many) {
+  const Points points(kCount, 1);
+  const vertex_t point{1.f, -2.f, 3.f, 1.f};
+  float distances_squared[kCount];
+  float distances[kCount];
+  PointDistancesSquaredPoints(point, points.Data(), kCount, distances_squared);
+  PointDistancesPoints(point, points.Data(), kCount, distances);
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    BOOST_TEST(distances_squared[i] ==
+                   PointDistanceSquaredPoint(point, points.Data()[i]),
+               boost::test_tools::tolerance(kTolerance));
+    BOOST_TEST(distances[i] == PointDistancePoint(point, points.Data()[i]),
+               boost::test_tools::tolerance(kTolerance));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(many_to_many) {
+  const Points a(7, 2);
+  const Points b(kCount, 3);
+  std::vector<float> distances_squared(7 * kCount);
+  std::vector<float> distances(7 * kCount);
+  PointDistancesSquaredPoints(a.Data(), 7, b.Data(), kCount,
+                              distances_squared.data());
+  PointDistancesPoints(a.Data(), 7, b.Data(), kCount, distances.data());
+
+  for (uint32_t i = 0; i < 7; ++i) {
+    for (uint32_t j = 0; j < kCount; ++j) {
+      BOOST_TEST(distances_squared[i * kCount + j] ==
+                     PointDistanceSquaredPoint(a.Data()[i], b.Data()[j]),
+                 boost::test_tools::tolerance(kTolerance));
+      BOOST_TEST(distances[i * kCount + j] ==
+                     PointDistancePoint(a.Data()[i], b.Data()[j]),
+                 boost::test_tools::tolerance(kTolerance));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(points_within_radius) {
+  const Points a(5, 4);
+  const Points b(kCount, 5);
+  constexpr float kRadius = 9.f;
+  const uint32_t words = PointsWithinRadiusMaskWords(kCount);
+  BOOST_TEST(words == 2u);
+
+  // Stale bits must be cleared.
+  std::vector<uint32_t> mask(5 * words, 0xFFFFFFFF);
+  const uint32_t count =
+      PointsWithinRadius(a.Data(), 5, b.Data(), kCount, kRadius, mask.data());
+  std::vector<uint32_t> one_mask(words, 0xFFFFFFFF);
+  uint32_t expected_count = 0;
+  for (uint32_t i = 0; i < 5; ++i) {
+    uint32_t row_count = 0;
+    for (uint32_t j = 0; j < kCount; ++j) {
+      const bool within = PointDistanceSquaredPoint(a.Data()[i],
+                                                    b.Data()[j]) <=
+                          kRadius * kRadius;
+      row_count += within;
+      BOOST_TEST(((mask[i * words + j / 32] >> (j % 32)) & 1) == within);
+    }
+    BOOST_TEST((mask[i * words + words - 1] >> (kCount % 32)) == 0u);
+
+    BOOST_TEST(PointsWithinRadius(a.Data()[i], b.Data(), kCount, kRadius,
+                                  one_mask.data()) == row_count);
+    for (uint32_t word = 0; word < words; ++word) {
+      BOOST_TEST(one_mask[word] == mask[i * words + word]);
+    }
+    expected_count += row_count;
+  }
+  BOOST_TEST(count == expected_count);
+  BOOST_TEST(count > 0u);
+  BOOST_TEST(count < 5 * kCount);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
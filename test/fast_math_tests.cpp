@@ -0,0 +1,72 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+#include "xbox_math_fast_math.h"
+
+using namespace XboxMath;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_fast_math_suite)
+
+#define SINCOS_TOLERANCE 2e-7f
+#define TAN_RELATIVE_TOLERANCE 3e-7f
+#define ACOS_TOLERANCE 3e-7f
+
+BOOST_AUTO_TEST_CASE(fast_sin_cos_matches_libm) {
+  for (float x = -100.f; x <= 100.f; x += 0.0123f) {
+    float sin_result, cos_result;
+    FastSinCos(x, sin_result, cos_result);
+
+    BOOST_TEST(fabs(sin_result - sin(x)) <= SINCOS_TOLERANCE);
+    BOOST_TEST(fabs(cos_result - cos(x)) <= SINCOS_TOLERANCE);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fast_sin_cos_4_matches_scalar) {
+  for (float x = -50.f; x <= 50.f; x += 0.37f) {
+    alignas(16) float input[4] = {x, x + 0.1f, -x * 0.5f, x * 3.f};
+    Simd::float4 sin_result, cos_result;
+    FastSinCos(Simd::Load(input), sin_result, cos_result);
+
+    alignas(16) float sin_values[4];
+    alignas(16) float cos_values[4];
+    Simd::Store(sin_values, sin_result);
+    Simd::Store(cos_values, cos_result);
+
+    for (uint32_t i = 0; i < 4; ++i) {
+      BOOST_TEST(fabs(sin_values[i] - sin(input[i])) <= SINCOS_TOLERANCE);
+      BOOST_TEST(fabs(cos_values[i] - cos(input[i])) <= SINCOS_TOLERANCE);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fast_tan_matches_libm) {
+  for (float x = -100.f; x <= 100.f; x += 0.0123f) {
+    // Skip the immediate neighborhood of the poles.
+    if (fabs(cos(x)) < 1e-3) {
+      continue;
+    }
+    const double expected = tan(x);
+
+    BOOST_TEST(fabs((FastTan(x) - expected) / expected) <=
+               TAN_RELATIVE_TOLERANCE);
+
+    const float result = Simd::GetX(FastTan(Simd::Set1(x)));
+    BOOST_TEST(fabs((result - expected) / expected) <= TAN_RELATIVE_TOLERANCE);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fast_acos_matches_libm) {
+  for (float x = -1.f; x <= 1.f; x += 0.00123f) {
+    const double expected = acos(x);
+
+    BOOST_TEST(fabs(FastAcos(x) - expected) <= ACOS_TOLERANCE);
+
+    const float result = Simd::GetX(FastAcos(Simd::Set1(x)));
+    BOOST_TEST(fabs(result - expected) <= ACOS_TOLERANCE);
+  }
+
+  BOOST_TEST(fabs(FastAcos(1.f)) <= ACOS_TOLERANCE);
+  BOOST_TEST(fabs(FastAcos(-1.f) - M_PI) <= ACOS_TOLERANCE);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_hiz.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_hiz_suite)
+
+// Odd dimensions exercise the clamped reductions.
+static constexpr uint32_t kWidth = 37;
+static constexpr uint32_t kHeight = 23;
+
+namespace {
+
+screenrect_t Rect(float min_x, float min_y, float max_x, float max_y,
+                  float min_z, float max_z) {
+  return {min_x, min_y, max_x, max_y, min_z, max_z};
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(pyramid_levels) {
+  std::vector<uint16_t> depth(kWidth * kHeight);
+  CRandom random(99);
+  for (auto &value : depth) {
+    value = static_cast<uint16_t>(random.NextBits() >> 16);
+  }
+
+  CHiZPyramid pyramid;
+  pyramid.Build(depth.data(), kWidth * sizeof(uint16_t), kDepthBuffer16Bit,
+                kWidth, kHeight);
+  BOOST_TEST(pyramid.GetLevelCount() == 7u);  // 37x23 down to 1x1.
+  BOOST_TEST(pyramid.GetLevelWidth(1) == 19u);
+  BOOST_TEST(pyramid.GetLevelHeight(1) == 12u);
+
+  for (uint32_t level = 0; level < pyramid.GetLevelCount(); ++level) {
+    for (uint32_t y = 0; y < pyramid.GetLevelHeight(level); ++y) {
+      for (uint32_t x = 0; x < pyramid.GetLevelWidth(level); ++x) {
+        // Every level 0 pixel the texel covers.
+        float expected_min = 65535.f, expected_max = 0.f;
+        const uint32_t last_x = std::min(((x + 1) << level) - 1, kWidth - 1);
+        const uint32_t last_y = std::min(((y + 1) << level) - 1, kHeight - 1);
+        for (uint32_t py = y << level; py <= last_y; ++py) {
+          for (uint32_t px = x << level; px <= last_x; ++px) {
+            const auto value = static_cast<float>(depth[py * kWidth + px]);
+            expected_min = std::min(expected_min, value);
+            expected_max = std::max(expected_max, value);
+          }
+        }
+        BOOST_TEST(pyramid.GetMinDepth(level, x, y) == expected_min);
+        BOOST_TEST(pyramid.GetMaxDepth(level, x, y) == expected_max);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(build_decodes_24_bit_float) {
+  std::vector<float> screen_z(kWidth * kHeight);
+  for (uint32_t i = 0; i < screen_z.size(); ++i) {
+    screen_z[i] = static_cast<float>(i) * 1e25f;
+  }
+  std::vector<uint32_t> depth(screen_z.size());
+  EncodeDepthValues(kDepthBuffer24BitFloat, screen_z.data(),
+                    static_cast<uint32_t>(screen_z.size()), depth.data());
+  for (auto &value : depth) {
+    value |= 0x5A;  // Stencil bits are ignored.
+  }
+  std::vector<float> expected(screen_z.size());
+  DecodeDepthValues(kDepthBuffer24BitFloat, depth.data(),
+                    static_cast<uint32_t>(depth.size()), expected.data());
+
+  CHiZPyramid pyramid;
+  pyramid.Build(depth.data(), kWidth * sizeof(uint32_t),
+                kDepthBuffer24BitFloat, kWidth, kHeight);
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      BOOST_TEST(pyramid.GetMaxDepth(0, x, y) == expected[y * kWidth + x]);
+    }
+  }
+  const uint32_t top = pyramid.GetLevelCount() - 1;
+  BOOST_TEST(pyramid.GetMinDepth(top, 0, 0) == expected.front());
+  BOOST_TEST(pyramid.GetMaxDepth(top, 0, 0) == expected.back());
+}
+
+BOOST_AUTO_TEST_CASE(test_rects) {
+  // Far background with a near occluder covering [0, 32) x [0, 16). Coarse
+  // texels straddling its edges see the background as well.
+  std::vector<uint16_t> depth(kWidth * kHeight, 0xFFFF);
+  for (uint32_t y = 0; y < 16; ++y) {
+    for (uint32_t x = 0; x < 32; ++x) {
+      depth[y * kWidth + x] = 1000;
+    }
+  }
+  CHiZPyramid pyramid;
+  pyramid.Build(depth.data(), kWidth * sizeof(uint16_t), kDepthBuffer16Bit,
+                kWidth, kHeight);
+
+  const screenrect_t rects[] = {
+      Rect(10.f, 6.f, 20.f, 14.f, 2000.f, 3000.f),  // Behind the occluder.
+      Rect(0.f, 0.f, 31.9f, 15.9f, 2000.f, 3000.f),  // Exactly covered.
+      Rect(10.f, 6.f, 20.f, 14.f, 500.f, 900.f),     // In front of it.
+      Rect(20.f, 6.f, 34.f, 14.f, 2000.f, 3000.f),   // Past its edge.
+      Rect(-20.f, -20.f, -5.f, -5.f, 2000.f, 3000.f),  // Off screen.
+      Rect(12.5f, 8.5f, 12.7f, 8.7f, 1000.5f, 1001.f),  // A single pixel.
+  };
+  HiZResult results[6];
+  BOOST_TEST(pyramid.TestRects(rects, 6, results) == 3u);
+  BOOST_TEST(results[0] == kHiZOccluded);
+  BOOST_TEST(results[1] == kHiZOccluded);
+  BOOST_TEST(results[2] == kHiZVisible);
+  BOOST_TEST(results[3] == kHiZPartiallyOccluded);
+  BOOST_TEST(results[4] == kHiZVisible);
+  BOOST_TEST(results[5] == kHiZOccluded);
+}
+
+BOOST_AUTO_TEST_CASE(empty_pyramid) {
+  CHiZPyramid pyramid;
+  pyramid.Build(nullptr, 0, kDepthBuffer16Bit, 0, 0);
+  BOOST_TEST(pyramid.GetLevelCount() == 0u);
+
+  const screenrect_t rect = Rect(0.f, 0.f, 1.f, 1.f, 0.f, 1.f);
+  HiZResult result;
+  BOOST_TEST(pyramid.TestRects(&rect, 1, &result) == 0u);
+  BOOST_TEST(result == kHiZVisible);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+#include "test_helpers.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_lod.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_lod_suite)
+
+BOOST_AUTO_TEST_CASE(lod_projection_scale) {
+  matrix4_t projection;
+  CreateD3DPerspectiveFOVLH(projection, M_PI * 0.5f, 4.f / 3.f, 1.f, 100.f);
+  // A 90 degree field of view spans 2 units at distance 1.
+  BOOST_TEST(LodProjectionScale(projection, 480.f) == 240.f,
+             boost::test_tools::tolerance(1e-5f));
+}
+
+BOOST_AUTO_TEST_CASE(select_lods) {
+  const vector_t camera{1.f, 2.f, 3.f, 1.f};
+  constexpr float kScale = 100.f;
+  const lodthresholds_t tables[2] = {
+      {{50.f, 20.f, 5.f}},         // 4 LODs.
+      {{40.f, 0.f, 0.f, 0.f}},     // 2 LODs.
+  };
+
+  // Sphere i projects to 100 * radius / distance pixels.
+  const boundingsphere_t spheres[] = {
+      Sphere(1.f, 2.f, 4.f, 1.f),       // 100 pixels.
+      Sphere(1.f, 2.f, 13.f, 3.f),      // 30.
+      Sphere(1.f, 12.f, 3.f, 1.f),      // 10.
+      Sphere(-99.f, 2.f, 3.f, 1.f),     // 1.
+      Sphere(1.f, 2.f, 3.f, 0.5f),      // Containing the camera.
+      Sphere(1.f, 2.f, 13.f, 3.f),      // 30, with the second table.
+      Sphere(1.f, 2.f, 5.f, 1.f),       // 50, with the second table.
+  };
+  const uint32_t table_indices[] = {0, 0, 0, 0, 0, 1, 1};
+  constexpr uint32_t kCount = sizeof(spheres) / sizeof(spheres[0]);
+  uint32_t lods[kCount];
+  SelectLods(spheres, kCount, camera, kScale, tables, table_indices, lods);
+
+  const uint32_t expected[kCount] = {0, 1, 2, 3, 0, 1, 0};
+  for (uint32_t i = 0; i < kCount; ++i) {
+    BOOST_TEST(lods[i] == expected[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(select_lods_camera_inside_sphere) {
+  // Thresholds above the projection scale, which a sphere off center of the
+  // camera would fall below without the containment test.
+  const vector_t camera{0.f, 0.f, 0.f, 1.f};
+  const lodthresholds_t table = {{500.f, 100.f}};
+  const boundingsphere_t spheres[] = {
+      Sphere(0.5f, 0.f, 0.f, 1.f),
+      Sphere(0.f, -0.9f, 0.3f, 1.f),
+      Sphere(0.f, 0.f, 2.f, 1.f),  // Outside, at 50 pixels.
+  };
+  constexpr uint32_t kCount = sizeof(spheres) / sizeof(spheres[0]);
+  const uint32_t table_indices[kCount] = {};
+  uint32_t lods[kCount];
+  SelectLods(spheres, kCount, camera, 100.f, &table, table_indices, lods);
+
+  const uint32_t expected[kCount] = {0, 0, 2};
+  for (uint32_t i = 0; i < kCount; ++i) {
+    BOOST_TEST(lods[i] == expected[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(select_lods_matches_distance) {
+  const vector_t camera{0.f, 0.f, 0.f, 1.f};
+  const lodthresholds_t table = {{80.f, 40.f, 20.f, 10.f, 5.f, 2.f, 1.f}};
+  constexpr uint32_t kCount = 61;
+  boundingsphere_t spheres[kCount];
+  uint32_t table_indices[kCount] = {};
+  for (uint32_t i = 0; i < kCount; ++i) {
+    const float angle = static_cast<float>(i);
+    const float distance = 1.5f + static_cast<float>(i * i);
+    spheres[i] = Sphere(distance * cosf(angle), 0.3f * distance,
+                        distance * sinf(angle), 1.f + 0.1f * angle);
+  }
+  uint32_t lods[kCount];
+  SelectLods(spheres, kCount, camera, 200.f, &table, table_indices, lods);
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    const float distance =
+        PointDistancePoint(camera, spheres[i].m_centerPt);
+    const float projected = spheres[i].m_radius * 200.f / distance;
+    uint32_t expected = 0;
+    while (expected < kMaxLodCount - 1 &&
+           projected < table.m_screenRadius[expected]) {
+      ++expected;
+    }
+    BOOST_TEST(lods[i] == expected);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -337,10 +337,10 @@ const std::vector<ScalarTestCaseData> kDeterminant4x4TestCases = {
 BOOST_DATA_TEST_CASE(matrix_determinant,
                      boost::unit_test::data::make(kDeterminant4x4TestCases),
                      test_case) {
-  float result;
+  double result;
   MatrixDeterminant(test_case.input, result);
 
-  BOOST_TEST(result == test_case.expected,
+  BOOST_TEST(static_cast<float>(result) == test_case.expected,
              boost::test_tools::tolerance(TOLERANCE));
 }
 
@@ -0,0 +1,375 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+#include "xbox_math_mesh.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_mesh_suite)
+
+static constexpr auto kTolerance = 1e-5f;
+
+#define VECTOR_TEST(v, e)                                                 \
+  BOOST_TEST((v)[0] == (e)[0], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[1] == (e)[1], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[2] == (e)[2], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[3] == (e)[3], boost::test_tools::tolerance(kTolerance))
+
+namespace {
+
+// A bumpy `size` x `size` vertex grid in the xz plane, two triangles per
+// quad.
+struct GridMesh {
+  std::vector<float> vertices;  // 4 floats per vertex.
+  std::vector<uint32_t> indices;
+
+  explicit GridMesh(uint32_t size) {
+    for (uint32_t z = 0; z < size; ++z) {
+      for (uint32_t x = 0; x < size; ++x) {
+        const auto fx = static_cast<float>(x);
+        const auto fz = static_cast<float>(z);
+        vertices.insert(vertices.end(),
+                        {fx, sinf(fx * 0.7f) * cosf(fz * 0.4f), fz, 1.f});
+      }
+    }
+    for (uint32_t z = 0; z + 1 < size; ++z) {
+      for (uint32_t x = 0; x + 1 < size; ++x) {
+        const uint32_t corner = z * size + x;
+        indices.insert(indices.end(), {corner, corner + size, corner + 1,
+                                       corner + 1, corner + size,
+                                       corner + size + 1});
+      }
+    }
+  }
+
+  [[nodiscard]] const vertex_t *Vertices() const {
+    return reinterpret_cast<const vertex_t *>(vertices.data());
+  }
+  [[nodiscard]] uint32_t VertexCount() const {
+    return static_cast<uint32_t>(vertices.size() / 4);
+  }
+  [[nodiscard]] uint32_t TriangleCount() const {
+    return static_cast<uint32_t>(indices.size() / 3);
+  }
+};
+
+// Vertex normals computed by scattering each triangle's weighted normal to its
+// corners.
+std::vector<float> ScatterVertexNormals(const GridMesh &mesh,
+                                        VertexNormalWeighting weighting) {
+  std::vector<float> sums(mesh.vertices.size(), 0.f);
+  auto *normals = reinterpret_cast<vector_t *>(sums.data());
+  for (uint32_t i = 0; i < mesh.TriangleCount(); ++i) {
+    const uint32_t *triangle = &mesh.indices[i * 3];
+    vector_t normal;
+    PlaneFindNormal(mesh.Vertices()[triangle[0]], mesh.Vertices()[triangle[1]],
+                    mesh.Vertices()[triangle[2]], normal);
+    for (uint32_t corner = 0; corner < 3; ++corner) {
+      float weight = 1.f;
+      if (weighting == kVertexNormalWeightAngle) {
+        vector_t a, b;
+        VectorSubtractVector(mesh.Vertices()[triangle[(corner + 1) % 3]],
+                             mesh.Vertices()[triangle[corner]], a);
+        VectorSubtractVector(mesh.Vertices()[triangle[(corner + 2) % 3]],
+                             mesh.Vertices()[triangle[corner]], b);
+        weight = acosf(VectorDotVector(a, b) /
+                       (VectorLength(a) * VectorLength(b))) /
+                 VectorLength(normal);
+      }
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        normals[triangle[corner]][axis] += normal[axis] * weight;
+      }
+    }
+  }
+  for (uint32_t v = 0; v < mesh.VertexCount(); ++v) {
+    VectorNormalize(normals[v], normals[v]);
+    normals[v][3] = 1.f;
+  }
+  return sums;
+}
+
+// Smooth normals and texture coordinates u = `u_scale` * x, v = z for a grid.
+struct TangentInputs {
+  std::vector<float> normal_storage;
+  std::vector<texcoord_t> texcoords;
+  vertexadjacency_t adjacency;
+
+  TangentInputs(const GridMesh &mesh, float u_scale)
+      : normal_storage(mesh.vertices.size()), texcoords(mesh.VertexCount()) {
+    std::vector<float> face_storage(mesh.TriangleCount() * 4);
+    auto *face_normals = reinterpret_cast<vector_t *>(face_storage.data());
+    ComputeFaceNormals(mesh.Vertices(), mesh.VertexCount(),
+                       mesh.indices.data(), mesh.TriangleCount(), false,
+                       face_normals);
+    BuildVertexAdjacency(mesh.indices.data(), mesh.TriangleCount(),
+                         mesh.VertexCount(), adjacency);
+    ComputeVertexNormals(mesh.Vertices(), mesh.indices.data(), face_normals,
+                         adjacency, kVertexNormalWeightArea, 0,
+                         mesh.VertexCount(), Normals());
+    for (uint32_t i = 0; i < mesh.VertexCount(); ++i) {
+      texcoords[i][0] = mesh.Vertices()[i][0] * u_scale;
+      texcoords[i][1] = mesh.Vertices()[i][2];
+      texcoords[i][2] = 0.f;
+    }
+  }
+
+  vector_t *Normals() {
+    return reinterpret_cast<vector_t *>(normal_storage.data());
+  }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(compute_face_normals) {
+  const GridMesh mesh(4);  // 18 triangles, not a multiple of 4.
+  const uint32_t count = mesh.TriangleCount();
+  std::vector<float> storage(count * 4);
+  auto *normals = reinterpret_cast<vector_t *>(storage.data());
+
+  for (bool normalize : {false, true}) {
+    BOOST_TEST(ComputeFaceNormals(mesh.Vertices(), mesh.VertexCount(),
+                                  mesh.indices.data(), count, normalize,
+                                  normals));
+    for (uint32_t i = 0; i < count; ++i) {
+      const uint32_t *triangle = &mesh.indices[i * 3];
+      vector_t expected;
+      if (normalize) {
+        PlaneFindNormalizedNormal(mesh.Vertices()[triangle[0]],
+                                  mesh.Vertices()[triangle[1]],
+                                  mesh.Vertices()[triangle[2]], expected);
+      } else {
+        PlaneFindNormal(mesh.Vertices()[triangle[0]],
+                        mesh.Vertices()[triangle[1]],
+                        mesh.Vertices()[triangle[2]], expected);
+      }
+      VECTOR_TEST(normals[i], expected);
+      // The grid faces up.
+      BOOST_TEST(normals[i][1] > 0.f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compute_face_normals_degenerate) {
+  const vertex_t vertices[3] = {
+      {1.f, 2.f, 3.f, 1.f}, {2.f, 4.f, 6.f, 1.f}, {3.f, 6.f, 9.f, 1.f}};
+  const uint32_t indices[6] = {0, 1, 2, 0, 0, 0};
+  vector_t normals[2];
+  BOOST_TEST(ComputeFaceNormals(vertices, 3, indices, 2, true, normals));
+  const vector_t expected = {0.f, 0.f, 0.f, 1.f};
+  VECTOR_TEST(normals[0], expected);
+  VECTOR_TEST(normals[1], expected);
+}
+
+BOOST_AUTO_TEST_CASE(compute_face_normals_rejects_bad_indices) {
+  const vertex_t vertices[3] = {
+      {0.f, 0.f, 0.f, 1.f}, {1.f, 0.f, 0.f, 1.f}, {0.f, 1.f, 0.f, 1.f}};
+  const uint32_t indices[3] = {0, 1, 3};
+  vector_t normal = {5.f, 5.f, 5.f, 5.f};
+  BOOST_TEST(!ComputeFaceNormals(vertices, 3, indices, 1, true, &normal));
+  BOOST_TEST(normal[0] == 5.f);
+}
+
+BOOST_AUTO_TEST_CASE(compute_vertex_normals) {
+  const GridMesh mesh(7);
+  std::vector<float> face_storage(mesh.TriangleCount() * 4);
+  auto *face_normals = reinterpret_cast<vector_t *>(face_storage.data());
+  BOOST_TEST(ComputeFaceNormals(mesh.Vertices(), mesh.VertexCount(),
+                                mesh.indices.data(), mesh.TriangleCount(),
+                                false, face_normals));
+  vertexadjacency_t adjacency;
+  BOOST_TEST(BuildVertexAdjacency(mesh.indices.data(), mesh.TriangleCount(),
+                                  mesh.VertexCount(), adjacency));
+  BOOST_TEST(adjacency.m_offsets.size() == mesh.VertexCount() + 1u);
+  BOOST_TEST(adjacency.m_corners.size() == mesh.indices.size());
+
+  std::vector<float> storage(mesh.vertices.size());
+  auto *normals = reinterpret_cast<vector_t *>(storage.data());
+  std::vector<float> range_storage(mesh.vertices.size());
+  auto *range_normals = reinterpret_cast<vector_t *>(range_storage.data());
+  for (auto weighting : {kVertexNormalWeightArea, kVertexNormalWeightAngle}) {
+    ComputeVertexNormals(mesh.Vertices(), mesh.indices.data(), face_normals,
+                         adjacency, weighting, 0, mesh.VertexCount(),
+                         normals);
+    const std::vector<float> expected = ScatterVertexNormals(mesh, weighting);
+    for (uint32_t v = 0; v < mesh.VertexCount(); ++v) {
+      VECTOR_TEST(normals[v],
+                  reinterpret_cast<const vector_t *>(expected.data())[v]);
+    }
+
+    // Disjoint vertex ranges give the same result as the whole mesh.
+    const uint32_t half = mesh.VertexCount() / 2;
+    ComputeVertexNormals(mesh.Vertices(), mesh.indices.data(), face_normals,
+                         adjacency, weighting, half,
+                         mesh.VertexCount() - half, range_normals);
+    ComputeVertexNormals(mesh.Vertices(), mesh.indices.data(), face_normals,
+                         adjacency, weighting, 0, half, range_normals);
+    BOOST_TEST(range_storage == storage, boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compute_vertex_normals_angle_weighted_cube) {
+  // Each cube face is split into two triangles, so only angle weighting gives
+  // every corner the symmetric normal.
+  vertex_t vertices[8];
+  for (uint32_t corner = 0; corner < 8; ++corner) {
+    vertices[corner][0] = corner & 1 ? 1.f : -1.f;
+    vertices[corner][1] = corner & 2 ? 1.f : -1.f;
+    vertices[corner][2] = corner & 4 ? 1.f : -1.f;
+    vertices[corner][3] = 1.f;
+  }
+  const uint32_t indices[36] = {0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5,
+                                0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6,
+                                0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+  vector_t face_normals[12];
+  BOOST_TEST(ComputeFaceNormals(vertices, 8, indices, 12, false, face_normals));
+  vertexadjacency_t adjacency;
+  BOOST_TEST(BuildVertexAdjacency(indices, 12, 8, adjacency));
+  vector_t normals[8];
+  ComputeVertexNormals(vertices, indices, face_normals, adjacency,
+                       kVertexNormalWeightAngle, 0, 8, normals);
+
+  for (uint32_t corner = 0; corner < 8; ++corner) {
+    vector_t expected;
+    VectorNormalize(vertices[corner], expected);
+    // The winding faces inward.
+    ScalarMultVector(expected, -1.f);
+    expected[3] = 1.f;
+    VECTOR_TEST(normals[corner], expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compute_vertex_normals_unused_vertex) {
+  const vertex_t vertices[4] = {{0.f, 0.f, 0.f, 1.f},
+                                {1.f, 0.f, 0.f, 1.f},
+                                {0.f, 0.f, 1.f, 1.f},
+                                {5.f, 5.f, 5.f, 1.f}};
+  const uint32_t indices[3] = {0, 2, 1};
+  vector_t face_normal;
+  BOOST_TEST(ComputeFaceNormals(vertices, 4, indices, 1, false, &face_normal));
+  vertexadjacency_t adjacency;
+  BOOST_TEST(BuildVertexAdjacency(indices, 1, 4, adjacency));
+  BOOST_TEST(!BuildVertexAdjacency(indices, 1, 2, adjacency));
+  BOOST_TEST(BuildVertexAdjacency(indices, 1, 4, adjacency));
+
+  vector_t normals[4];
+  ComputeVertexNormals(vertices, indices, &face_normal, adjacency,
+                       kVertexNormalWeightArea, 0, 4, normals);
+  const vector_t zero = {0.f, 0.f, 0.f, 1.f};
+  VECTOR_TEST(normals[3], zero);
+  const vector_t up = {0.f, 1.f, 0.f, 1.f};
+  VECTOR_TEST(normals[0], up);
+}
+
+BOOST_AUTO_TEST_CASE(compute_vertex_tangents) {
+  const GridMesh mesh(6);
+  TangentInputs inputs(mesh, 0.5f);
+  const vector_t *normals = inputs.Normals();
+
+  // Each triangle's tangent and bitangent, summed at its corners.
+  std::vector<float> sums(mesh.vertices.size() * 2, 0.f);
+  auto *tangent_sums = reinterpret_cast<vector_t *>(sums.data());
+  vector_t *bitangent_sums = tangent_sums + mesh.VertexCount();
+  for (uint32_t i = 0; i < mesh.TriangleCount(); ++i) {
+    const uint32_t *triangle = &mesh.indices[i * 3];
+    vector_t e1, e2;
+    VectorSubtractVector(mesh.Vertices()[triangle[1]],
+                         mesh.Vertices()[triangle[0]], e1);
+    VectorSubtractVector(mesh.Vertices()[triangle[2]],
+                         mesh.Vertices()[triangle[0]], e2);
+    const texcoord_t *uv[3] = {&inputs.texcoords[triangle[0]],
+                               &inputs.texcoords[triangle[1]],
+                               &inputs.texcoords[triangle[2]]};
+    const float du1 = (*uv[1])[0] - (*uv[0])[0];
+    const float dv1 = (*uv[1])[1] - (*uv[0])[1];
+    const float du2 = (*uv[2])[0] - (*uv[0])[0];
+    const float dv2 = (*uv[2])[1] - (*uv[0])[1];
+    const float r = 1.f / (du1 * dv2 - du2 * dv1);
+    for (uint32_t corner = 0; corner < 3; ++corner) {
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        tangent_sums[triangle[corner]][axis] +=
+            (e1[axis] * dv2 - e2[axis] * dv1) * r;
+        bitangent_sums[triangle[corner]][axis] +=
+            (e2[axis] * du1 - e1[axis] * du2) * r;
+      }
+    }
+  }
+
+  std::vector<float> storage(mesh.vertices.size());
+  auto *tangents = reinterpret_cast<vector_t *>(storage.data());
+  std::vector<float> range_storage(mesh.vertices.size());
+  auto *range_tangents = reinterpret_cast<vector_t *>(range_storage.data());
+  for (bool orthogonalize : {false, true}) {
+    ComputeVertexTangents(mesh.Vertices(), inputs.texcoords.data(),
+                          mesh.indices.data(), normals, inputs.adjacency,
+                          orthogonalize, 0, mesh.VertexCount(), tangents);
+    for (uint32_t v = 0; v < mesh.VertexCount(); ++v) {
+      vector_t expected;
+      VectorCopyVector(expected, tangent_sums[v]);
+      if (orthogonalize) {
+        vector_t projection;
+        ScalarMultVector(normals[v], VectorDotVector(normals[v], expected),
+                         projection);
+        VectorSubtractVector(expected, projection);
+        BOOST_TEST(VectorDotVector(tangents[v], normals[v]) == 0.f,
+                   boost::test_tools::tolerance(kTolerance));
+      }
+      VectorNormalize(expected);
+      vector_t cross;
+      VectorCrossVector(normals[v], expected, cross);
+      expected[3] =
+          VectorDotVector(cross, bitangent_sums[v]) < 0.f ? -1.f : 1.f;
+      // Components may be close to zero, so compare absolutely.
+      for (uint32_t i = 0; i < 4; ++i) {
+        BOOST_TEST(fabsf(tangents[v][i] - expected[i]) <= kTolerance);
+      }
+    }
+
+    const uint32_t third = mesh.VertexCount() / 3;
+    ComputeVertexTangents(mesh.Vertices(), inputs.texcoords.data(),
+                          mesh.indices.data(), normals, inputs.adjacency,
+                          orthogonalize, third, mesh.VertexCount() - third,
+                          range_tangents);
+    ComputeVertexTangents(mesh.Vertices(), inputs.texcoords.data(),
+                          mesh.indices.data(), normals, inputs.adjacency,
+                          orthogonalize, 0, third, range_tangents);
+    BOOST_TEST(range_storage == storage, boost::test_tools::per_element());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compute_vertex_tangents_handedness) {
+  // A mirrored u flips the tangent and the handedness, leaving the bitangent.
+  // The grid's bumps tilt the frames a little away from the axes.
+  const GridMesh mesh(3);
+  for (float u_scale : {1.f, -1.f}) {
+    TangentInputs inputs(mesh, u_scale);
+    vector_t tangents[9];
+    ComputeVertexTangents(mesh.Vertices(), inputs.texcoords.data(),
+                          mesh.indices.data(), inputs.Normals(),
+                          inputs.adjacency, true, 0, 9, tangents);
+    for (uint32_t v = 0; v < 9; ++v) {
+      BOOST_TEST(tangents[v][0] * u_scale > 0.8f);
+      BOOST_TEST(tangents[v][3] == -u_scale);
+      // The bitangent follows v, which runs along z.
+      vector_t bitangent;
+      VectorCrossVector(inputs.Normals()[v], tangents[v], bitangent);
+      BOOST_TEST(bitangent[2] * tangents[v][3] > 0.8f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compute_vertex_tangents_degenerate_texcoords) {
+  const GridMesh mesh(3);
+  TangentInputs inputs(mesh, 0.f);
+  vector_t tangents[9];
+  ComputeVertexTangents(mesh.Vertices(), inputs.texcoords.data(),
+                        mesh.indices.data(), inputs.Normals(),
+                        inputs.adjacency, true, 0, 9, tangents);
+  const vector_t zero = {0.f, 0.f, 0.f, 1.f};
+  for (const auto &tangent : tangents) {
+    VECTOR_TEST(tangent, zero);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,203 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_occlusion.h"
+#include "xbox_math_util.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_occlusion_suite)
+
+// Not a multiple of the tile size.
+static constexpr uint32_t kWidth = 100;
+static constexpr uint32_t kHeight = 60;
+
+namespace {
+
+// A camera at the origin looking down +z at a 10 x 10 wall 10 units away.
+struct WallScene {
+  matrix4_t view;
+  matrix4_t projection;
+  COcclusionBuffer buffer{kWidth, kHeight};
+
+  WallScene() {
+    vector_t eye{0.f, 0.f, 0.f, 1.f};
+    vector_t at{0.f, 0.f, 1.f, 1.f};
+    vector_t up{0.f, 1.f, 0.f, 1.f};
+    CreateD3DLookAtLH(view, eye, at, up);
+    CreateD3DPerspectiveFOVLH(projection, M_PI * 0.5f,
+                              static_cast<float>(kWidth) / kHeight, 1.f,
+                              100.f);
+    buffer.SetViewProjection(view, projection);
+  }
+
+  void AddWall(float z) {
+    const vertex_t vertices[4] = {{-5.f, -5.f, z, 1.f},
+                                  {5.f, -5.f, z, 1.f},
+                                  {5.f, 5.f, z, 1.f},
+                                  {-5.f, 5.f, z, 1.f}};
+    const uint32_t indices[6] = {0, 1, 2, 0, 2, 3};
+    BOOST_TEST(buffer.AddOccluders(vertices, 4, indices, 2));
+  }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(empty_buffer_occludes_nothing) {
+  WallScene scene;
+  scene.buffer.Rasterize();
+  BOOST_TEST(scene.buffer.GetDepth(0, 0) == 1.f);
+  BOOST_TEST(scene.buffer.GetDepth(kWidth - 1, kHeight - 1) == 1.f);
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, 50.f, 1.f)));
+}
+
+BOOST_AUTO_TEST_CASE(wall_depth) {
+  WallScene scene;
+  scene.AddWall(10.f);
+  scene.buffer.Rasterize();
+
+  // The wall faces the camera, so its depth is constant.
+  matrix4_t viewport;
+  CreateD3DViewport(viewport, kWidth, kHeight, 1.f, 0.f, 1.f);
+  matrix4_t projection_viewport;
+  MatrixMultMatrix(scene.projection, viewport, projection_viewport);
+  matrix4_t composite;
+  BuildCompositeMatrix(scene.view, projection_viewport, composite);
+  vector_t wall_point{0.f, 0.f, 10.f, 1.f};
+  vector_t screen_point;
+  ProjectPoint(wall_point, composite, screen_point);
+
+  BOOST_TEST(fabsf(scene.buffer.GetDepth(kWidth / 2, kHeight / 2) -
+                   screen_point[2]) <= 1e-5f);
+  BOOST_TEST(scene.buffer.GetDepth(0, 0) == 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(spheres_behind_wall) {
+  WallScene scene;
+  scene.AddWall(10.f);
+  scene.buffer.Rasterize();
+
+  BOOST_TEST(scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, 20.f, 1.f)));
+  BOOST_TEST(scene.buffer.IsSphereOccluded(Sphere(2.f, -2.f, 30.f, 2.f)));
+
+  // In front of the wall.
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, 5.f, 1.f)));
+  // Intersecting the wall.
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, 10.f, 1.f)));
+  // Beside the wall.
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(20.f, 0.f, 30.f, 1.f)));
+  // Peeking out past the wall's edge.
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(10.f, 0.f, 20.f, 1.f)));
+  // Crossing the near plane, behind the camera and off screen.
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, 1.f, 1.5f)));
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, -20.f, 1.f)));
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 200.f, 20.f, 1.f)));
+}
+
+BOOST_AUTO_TEST_CASE(spheres_use_exact_screen_rects) {
+  WallScene scene;
+  scene.AddWall(10.f);
+  scene.buffer.Rasterize();
+
+  // Hidden, but the corners of its bounding box reach past the wall's edge.
+  const boundingsphere_t sphere = Sphere(3.3f, 0.f, 14.f, 2.5f);
+  BOOST_TEST(scene.buffer.IsSphereOccluded(sphere));
+  screenrect_t box_rect;
+  BOOST_TEST(BoundingSphereScreenRect(sphere, scene.buffer.GetComposite(),
+                                      box_rect));
+  BOOST_TEST(!scene.buffer.IsScreenRectOccluded(box_rect));
+}
+
+BOOST_AUTO_TEST_CASE(spheres_with_orthographic_projection) {
+  WallScene scene;
+  matrix4_t projection;
+  CreateD3DOrthographicLH(projection, -10.f, 10.f, 6.f, -6.f, 1.f, 100.f);
+  scene.buffer.SetViewProjection(scene.view, projection);
+  scene.AddWall(10.f);
+  scene.buffer.Rasterize();
+
+  BOOST_TEST(scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, 20.f, 1.f)));
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 0.f, 5.f, 1.f)));
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(8.f, 0.f, 20.f, 1.f)));
+}
+
+BOOST_AUTO_TEST_CASE(aabbs_behind_wall) {
+  WallScene scene;
+  scene.AddWall(10.f);
+  scene.buffer.Rasterize();
+
+  const aabb_t hidden = {{-1.f, -1.f, 15.f, 1.f}, {1.f, 1.f, 17.f, 1.f}};
+  BOOST_TEST(scene.buffer.IsAABBOccluded(hidden));
+
+  const aabb_t wide = {{-8.f, -1.f, 15.f, 1.f}, {8.f, 1.f, 17.f, 1.f}};
+  BOOST_TEST(!scene.buffer.IsAABBOccluded(wide));
+
+  const aabb_t straddling = {{-1.f, -1.f, 5.f, 1.f}, {1.f, 1.f, 15.f, 1.f}};
+  BOOST_TEST(!scene.buffer.IsAABBOccluded(straddling));
+}
+
+BOOST_AUTO_TEST_CASE(occluders_crossing_near_plane) {
+  // A floor running from behind the camera into the distance.
+  WallScene scene;
+  const vertex_t vertices[4] = {{-50.f, -1.f, -10.f, 1.f},
+                                {50.f, -1.f, -10.f, 1.f},
+                                {50.f, -1.f, 90.f, 1.f},
+                                {-50.f, -1.f, 90.f, 1.f}};
+  const uint32_t indices[6] = {0, 1, 2, 0, 2, 3};
+  BOOST_TEST(scene.buffer.AddOccluders(vertices, 4, indices, 2));
+  scene.buffer.Rasterize();
+
+  BOOST_TEST(scene.buffer.IsSphereOccluded(Sphere(0.f, -5.f, 20.f, 1.f)));
+  BOOST_TEST(!scene.buffer.IsSphereOccluded(Sphere(0.f, 3.f, 20.f, 1.f)));
+  BOOST_TEST(scene.buffer.GetDepth(kWidth / 2, kHeight - 1) < 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(rasterize_tile_ranges) {
+  WallScene scene;
+  scene.AddWall(10.f);
+  scene.AddWall(12.f);
+  scene.buffer.Rasterize();
+
+  WallScene ranges;
+  ranges.AddWall(10.f);
+  ranges.AddWall(12.f);
+  const uint32_t half = ranges.buffer.GetTileCount() / 2;
+  ranges.buffer.RasterizeTiles(half, ranges.buffer.GetTileCount() - half);
+  ranges.buffer.RasterizeTiles(0, half);
+
+  for (uint32_t y = 0; y < kHeight; ++y) {
+    for (uint32_t x = 0; x < kWidth; ++x) {
+      BOOST_TEST(ranges.buffer.GetDepth(x, y) == scene.buffer.GetDepth(x, y));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_spheres) {
+  WallScene scene;
+  scene.AddWall(10.f);
+  scene.buffer.Rasterize();
+
+  const boundingsphere_t spheres[3] = {Sphere(0.f, 0.f, 20.f, 1.f),
+                                       Sphere(0.f, 0.f, 5.f, 1.f),
+                                       Sphere(-1.f, 1.f, 40.f, 1.f)};
+  bool occluded[3];
+  BOOST_TEST(scene.buffer.TestSpheres(spheres, 3, occluded) == 2u);
+  BOOST_TEST(occluded[0]);
+  BOOST_TEST(!occluded[1]);
+  BOOST_TEST(occluded[2]);
+}
+
+BOOST_AUTO_TEST_CASE(add_occluders_rejects_bad_indices) {
+  WallScene scene;
+  const vertex_t vertices[3] = {
+      {0.f, 0.f, 10.f, 1.f}, {1.f, 0.f, 10.f, 1.f}, {0.f, 1.f, 10.f, 1.f}};
+  const uint32_t indices[3] = {0, 1, 3};
+  BOOST_TEST(!scene.buffer.AddOccluders(vertices, 3, indices, 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
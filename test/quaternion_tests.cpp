@@ -0,0 +1,85 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+#include "xbox_math_quaternion.h"
+
+using namespace XboxMath;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_quaternion_suite)
+
+#define TOLERANCE 1e-5f
+
+#define QUATERNION_TEST(q, e)                                            \
+  BOOST_TEST((q)[0] == (e)[0], boost::test_tools::tolerance(TOLERANCE)); \
+  BOOST_TEST((q)[1] == (e)[1], boost::test_tools::tolerance(TOLERANCE)); \
+  BOOST_TEST((q)[2] == (e)[2], boost::test_tools::tolerance(TOLERANCE)); \
+  BOOST_TEST((q)[3] == (e)[3], boost::test_tools::tolerance(TOLERANCE))
+
+// Deliberately not a multiple of four to exercise the remainder handling.
+static constexpr uint32_t kBatchSize = 7;
+static const vector_t kEulerDegrees[kBatchSize] = {
+    {0.f, 0.f, 0.f, 1.f},      {90.f, 0.f, 0.f, 1.f},
+    {0.f, -45.f, 0.f, 1.f},    {0.f, 0.f, 180.f, 1.f},
+    {33.f, -71.5f, 12.f, 1.f}, {-170.f, 85.f, 359.f, 1.f},
+    {720.f, -360.f, 1e3f, 1.f},
+};
+
+static constexpr float kDegToRad = static_cast<float>(M_PI) / 180.f;
+
+BOOST_AUTO_TEST_CASE(quaternions_from_euler_degrees_matches_set_euler) {
+  CQuaternion result[kBatchSize];
+  QuaternionsFromEulerDegrees(kEulerDegrees, kBatchSize, result);
+
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    CQuaternion expected;
+    expected.SetEuler(kEulerDegrees[i][0], kEulerDegrees[i][1],
+                      kEulerDegrees[i][2]);
+    QUATERNION_TEST(result[i], expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(quaternions_from_euler_matches_set_euler) {
+  vector_t euler_radians[kBatchSize];
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    for (uint32_t axis = 0; axis < 4; ++axis) {
+      euler_radians[i][axis] = kEulerDegrees[i][axis] * kDegToRad;
+    }
+  }
+
+  CQuaternion result[kBatchSize];
+  QuaternionsFromEuler(euler_radians, kBatchSize, result);
+
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    CQuaternion expected(kEulerDegrees[i][0], kEulerDegrees[i][1],
+                         kEulerDegrees[i][2]);
+    QUATERNION_TEST(result[i], expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(quaternions_from_axis_angle_degrees_matches_constructor) {
+  static const vector_t kAxes[kBatchSize] = {
+      {1.f, 0.f, 0.f, 1.f},   {0.f, 2.f, 0.f, 1.f},    {0.f, 0.f, -1.f, 1.f},
+      {1.f, 1.f, 1.f, 1.f},   {0.3f, -0.2f, 5.f, 1.f}, {-4.f, 0.5f, 0.f, 1.f},
+      {0.f, 0.7f, 0.7f, 1.f},
+  };
+  static const float kAngles[kBatchSize] = {0.f,  90.f,  -45.f, 180.f,
+                                            12.f, 300.f, -720.f};
+
+  CQuaternion result[kBatchSize];
+  QuaternionsFromAxisAngleDegrees(kAxes, kAngles, kBatchSize, result);
+
+  float angles_radians[kBatchSize];
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    angles_radians[i] = kAngles[i] * kDegToRad;
+  }
+  CQuaternion result_radians[kBatchSize];
+  QuaternionsFromAxisAngle(kAxes, angles_radians, kBatchSize, result_radians);
+
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    CQuaternion expected(kAxes[i], kAngles[i]);
+    QUATERNION_TEST(result[i], expected);
+    QUATERNION_TEST(result_radians[i], expected);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
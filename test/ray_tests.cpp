@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_d3d.h"
+#include "xbox_math_matrix.h"
+#include "xbox_math_ray.h"
+#include "xbox_math_util.h"
+#include "xbox_math_vector.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_ray_suite)
+
+static constexpr auto kTolerance = 1e-3f;
+
+#define VECTOR_NEAR(v, e)                         \
+  BOOST_TEST(fabsf((v)[0] - (e)[0]) <= kTolerance); \
+  BOOST_TEST(fabsf((v)[1] - (e)[1]) <= kTolerance); \
+  BOOST_TEST(fabsf((v)[2] - (e)[2]) <= kTolerance); \
+  BOOST_TEST(fabsf((v)[3] - (e)[3]) <= kTolerance)
+
+namespace {
+
+struct Ray {
+  ray_t value;
+};
+
+struct PickingSetup {
+  matrix4_t viewport;
+  matrix4_t inverse_composite;
+
+  PickingSetup() {
+    vector_t eye{-0.3f, 1.25f, -5.f, 1.f};
+    vector_t at{0.f, 0.f, 0.f, 1.f};
+    vector_t up{0.f, 1.f, 0.f, 1.f};
+    matrix4_t view;
+    CreateD3DLookAtLH(view, eye, at, up);
+
+    matrix4_t projection;
+    CreateD3DPerspectiveFOVLH(projection, M_PI * 0.25f, 640.f / 480.f, 1.f,
+                              200.f);
+    CreateD3DViewport(viewport, 640.f, 480.f, 65535.f, 0.25f, 0.75f);
+
+    matrix4_t projection_viewport;
+    MatrixMultMatrix(projection, viewport, projection_viewport);
+    matrix4_t composite;
+    BuildCompositeMatrix(view, projection_viewport, composite);
+    BuildInverseCompositeMatrix(composite, inverse_composite);
+  }
+
+  // Computes the expected ray by unprojecting onto the clipping planes.
+  void ExpectedRay(float x, float y, ray_t &ret) const {
+    vector_t screen_near{x, y, 65535.f * 0.25f, 1.f};
+    UnprojectPoint(screen_near, inverse_composite, ret.m_origin);
+
+    vector_t screen_far{x, y, 65535.f * 0.75f, 1.f};
+    vector_t far_point;
+    UnprojectPoint(screen_far, inverse_composite, far_point);
+
+    VectorSubtractVector(far_point, ret.m_origin, ret.m_direction);
+    ret.m_direction[3] = 0.f;
+    VectorNormalize(ret.m_direction);
+    ret.m_direction[3] = 0.f;
+  }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(viewport_depth_range) {
+  matrix4_t viewport;
+  CreateD3DViewport(viewport, 640.f, 480.f, 65535.f, 0.25f, 0.75f);
+
+  float near_screen_z, far_screen_z;
+  ViewportDepthRange(viewport, near_screen_z, far_screen_z);
+  BOOST_TEST(near_screen_z == 65535.f * 0.25f);
+  BOOST_TEST(far_screen_z == 65535.f * 0.75f);
+}
+
+BOOST_AUTO_TEST_CASE(generate_ray_matches_unproject) {
+  PickingSetup setup;
+  CRayGenerator generator(setup.inverse_composite, setup.viewport);
+
+  const float points[][2] = {{320.f, 240.f}, {0.f, 0.f}, {639.f, 479.f},
+                             {12.5f, 400.f}};
+  for (const auto &point : points) {
+    ray_t ray;
+    generator.GenerateRay(point[0], point[1], ray);
+    ray_t expected;
+    setup.ExpectedRay(point[0], point[1], expected);
+
+    VECTOR_NEAR(ray.m_origin, expected.m_origin);
+    VECTOR_NEAR(ray.m_direction, expected.m_direction);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(generate_rays_matches_generate_ray) {
+  PickingSetup setup;
+  CRayGenerator generator(setup.inverse_composite, setup.viewport);
+
+  // Not a multiple of four, to cover the partial batch.
+  static constexpr uint32_t kCount = 11;
+  vector_t points[kCount];
+  for (uint32_t i = 0; i < kCount; ++i) {
+    VectorSetVector(points[i], 13.f * i, 480.f - 29.f * i, 0.f);
+  }
+  std::vector<Ray> rays(kCount);
+  generator.GenerateRays(points, kCount, &rays[0].value);
+
+  for (uint32_t i = 0; i < kCount; ++i) {
+    ray_t expected;
+    setup.ExpectedRay(points[i][0], points[i][1], expected);
+    VECTOR_NEAR(rays[i].value.m_origin, expected.m_origin);
+    VECTOR_NEAR(rays[i].value.m_direction, expected.m_direction);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(generate_grid_matches_generate_ray) {
+  PickingSetup setup;
+  CRayGenerator generator(setup.inverse_composite, setup.viewport);
+
+  static constexpr uint32_t kColumns = 161;
+  static constexpr uint32_t kRows = 7;
+  std::vector<Ray> rays(kColumns * kRows);
+  generator.GenerateGrid(0.5f, 10.5f, 4.f, 64.f, kColumns, kRows,
+                         &rays[0].value);
+
+  for (uint32_t row = 0; row < kRows; ++row) {
+    for (uint32_t column = 0; column < kColumns; ++column) {
+      const ray_t &ray = rays[row * kColumns + column].value;
+      ray_t expected;
+      setup.ExpectedRay(0.5f + 4.f * column, 10.5f + 64.f * row, expected);
+      VECTOR_NEAR(ray.m_origin, expected.m_origin);
+      VECTOR_NEAR(ray.m_direction, expected.m_direction);
+    }
+  }
+}
+
+namespace {
+
+struct Scene {
+  std::vector<boundingsphere_t> spheres;
+  std::vector<aabb_t> boxes;
+  std::vector<Ray> rays;
+  std::vector<float> vertices;  // 4 floats per vertex.
+  std::vector<uint32_t> indices;
+
+  CRandom random{12345};
+
+  Scene() {
+    for (uint32_t i = 0; i < 37; ++i) {
+      boundingsphere_t sphere;
+      VectorSetVector(sphere.m_centerPt, random(-10.f, 10.f),
+                      random(-10.f, 10.f), random(-10.f, 10.f));
+      sphere.m_radius = random(0.2f, 2.f);
+      spheres.push_back(sphere);
+
+      aabb_t box;
+      VectorSetVector(box.m_minPt, random(-10.f, 8.f), random(-10.f, 8.f),
+                      random(-10.f, 8.f));
+      VectorSetVector(box.m_maxPt, box.m_minPt[0] + random(0.1f, 2.f),
+                      box.m_minPt[1] + random(0.1f, 2.f),
+                      box.m_minPt[2] + random(0.1f, 2.f));
+      boxes.push_back(box);
+
+      const float cx = random(-10.f, 10.f);
+      const float cy = random(-10.f, 10.f);
+      const float cz = random(-10.f, 10.f);
+      for (uint32_t v = 0; v < 3; ++v) {
+        indices.push_back(static_cast<uint32_t>(vertices.size() / 4));
+        vertices.push_back(cx + random(-2.f, 2.f));
+        vertices.push_back(cy + random(-2.f, 2.f));
+        vertices.push_back(cz + random(-2.f, 2.f));
+        vertices.push_back(1.f);
+      }
+    }
+
+    for (uint32_t i = 0; i < 203; ++i) {
+      Ray ray;
+      VectorSetVector(ray.value.m_origin, random(-15.f, 15.f),
+                      random(-15.f, 15.f), random(-15.f, 15.f));
+      VectorSetVector(ray.value.m_direction, random(-1.f, 1.f),
+                      random(-1.f, 1.f), random(-1.f, 1.f), 0.f);
+      VectorNormalize(ray.value.m_direction);
+      ray.value.m_direction[3] = 0.f;
+      rays.push_back(ray);
+    }
+  }
+
+  const vertex_t *Vertices() const {
+    return reinterpret_cast<const vertex_t *>(vertices.data());
+  }
+  uint32_t TriangleCount() const {
+    return static_cast<uint32_t>(indices.size() / 3);
+  }
+};
+
+}  // namespace
+
+static float ReferenceSphere(const ray_t &ray, const boundingsphere_t &sphere) {
+  vector_t offset;
+  VectorSubtractVector(ray.m_origin, sphere.m_centerPt, offset);
+  const float b = offset[0] * ray.m_direction[0] +
+                  offset[1] * ray.m_direction[1] +
+                  offset[2] * ray.m_direction[2];
+  const float c = offset[0] * offset[0] + offset[1] * offset[1] +
+                  offset[2] * offset[2] - sphere.m_radius * sphere.m_radius;
+  const float discriminant = b * b - c;
+  if (discriminant < 0.f) {
+    return -1.f;
+  }
+  float t = -b - sqrtf(discriminant);
+  if (t < 0.f) {
+    t = -b + sqrtf(discriminant);
+  }
+  return t;
+}
+
+static float ReferenceAABB(const ray_t &ray, const aabb_t &box) {
+  float t_enter = 0.f;
+  float t_exit = FLT_MAX;
+  for (uint32_t axis = 0; axis < 3; ++axis) {
+    float t0 = (box.m_minPt[axis] - ray.m_origin[axis]) / ray.m_direction[axis];
+    float t1 = (box.m_maxPt[axis] - ray.m_origin[axis]) / ray.m_direction[axis];
+    t_enter = std::max(t_enter, std::min(t0, t1));
+    t_exit = std::min(t_exit, std::max(t0, t1));
+  }
+  return t_enter <= t_exit ? t_enter : -1.f;
+}
+
+static float ReferenceTriangle(const ray_t &ray, const vertex_t &a,
+                               const vertex_t &b, const vertex_t &c) {
+  vector_t edge1, edge2, p, s, q;
+  VectorSubtractVector(b, a, edge1);
+  VectorSubtractVector(c, a, edge2);
+  edge1[3] = edge2[3] = 0.f;
+  vector_t direction;
+  VectorCopyVector(direction, ray.m_direction);
+  VectorCrossVector(direction, edge2, p);
+  const float determinant = edge1[0] * p[0] + edge1[1] * p[1] + edge1[2] * p[2];
+  if (fabsf(determinant) < 1e-12f) {
+    return -1.f;
+  }
+  VectorSubtractVector(ray.m_origin, a, s);
+  const float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / determinant;
+  VectorCrossVector(s, edge1, q);
+  const float v = (direction[0] * q[0] + direction[1] * q[1] +
+                   direction[2] * q[2]) /
+                  determinant;
+  const float t =
+      (edge2[0] * q[0] + edge2[1] * q[1] + edge2[2] * q[2]) / determinant;
+  if (u < 0.f || v < 0.f || u + v > 1.f) {
+    return -1.f;
+  }
+  return t;
+}
+
+// Finds the closest hit by brute force using `reference`.
+template <typename Reference>
+static void ReferenceClosest(uint32_t count, Reference reference,
+                             rayhit_t &hit) {
+  RayHitReset(hit);
+  for (uint32_t i = 0; i < count; ++i) {
+    const float t = reference(i);
+    if (t >= 0.f && t < hit.m_distance) {
+      hit.m_distance = t;
+      hit.m_index = i;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ray_intersect_spheres) {
+  Scene scene;
+  uint32_t hit_count = 0;
+  for (const Ray &ray : scene.rays) {
+    rayhit_t expected;
+    ReferenceClosest(
+        static_cast<uint32_t>(scene.spheres.size()),
+        [&](uint32_t i) {
+          return ReferenceSphere(ray.value, scene.spheres[i]);
+        },
+        expected);
+
+    rayhit_t hit;
+    RayHitReset(hit);
+    const bool updated =
+        RayIntersectSpheres(ray.value, scene.spheres.data(),
+                            static_cast<uint32_t>(scene.spheres.size()), hit);
+    BOOST_TEST(updated == (expected.m_index != kRayHitNone));
+    BOOST_TEST(hit.m_index == expected.m_index);
+    if (updated) {
+      ++hit_count;
+      BOOST_TEST(fabsf(hit.m_distance - expected.m_distance) <= kTolerance);
+    }
+  }
+  BOOST_TEST(hit_count > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(ray_intersect_aabbs) {
+  Scene scene;
+  uint32_t hit_count = 0;
+  for (const Ray &ray : scene.rays) {
+    rayhit_t expected;
+    ReferenceClosest(
+        static_cast<uint32_t>(scene.boxes.size()),
+        [&](uint32_t i) { return ReferenceAABB(ray.value, scene.boxes[i]); },
+        expected);
+
+    rayhit_t hit;
+    RayHitReset(hit);
+    const bool updated =
+        RayIntersectAABBs(ray.value, scene.boxes.data(),
+                          static_cast<uint32_t>(scene.boxes.size()), hit);
+    BOOST_TEST(updated == (expected.m_index != kRayHitNone));
+    BOOST_TEST(hit.m_index == expected.m_index);
+    if (updated) {
+      ++hit_count;
+      BOOST_TEST(fabsf(hit.m_distance - expected.m_distance) <= kTolerance);
+    }
+  }
+  BOOST_TEST(hit_count > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(ray_intersect_triangles) {
+  Scene scene;
+  const vertex_t *vertices = scene.Vertices();
+  uint32_t hit_count = 0;
+  for (const Ray &ray : scene.rays) {
+    rayhit_t expected;
+    ReferenceClosest(
+        scene.TriangleCount(),
+        [&](uint32_t i) {
+          const uint32_t *tri = &scene.indices[i * 3];
+          return ReferenceTriangle(ray.value, vertices[tri[0]],
+                                   vertices[tri[1]], vertices[tri[2]]);
+        },
+        expected);
+
+    rayhit_t hit;
+    RayHitReset(hit);
+    const bool updated =
+        RayIntersectTriangles(ray.value, vertices, scene.indices.data(),
+                              scene.TriangleCount(), hit);
+    BOOST_TEST(updated == (expected.m_index != kRayHitNone));
+    BOOST_TEST(hit.m_index == expected.m_index);
+    if (updated) {
+      ++hit_count;
+      BOOST_TEST(fabsf(hit.m_distance - expected.m_distance) <= kTolerance);
+
+      // The barycentric coordinates must reproduce the hit point.
+      const uint32_t *tri = &scene.indices[hit.m_index * 3];
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        const float from_barycentric =
+            vertices[tri[0]][axis] * (1.f - hit.m_u - hit.m_v) +
+            vertices[tri[1]][axis] * hit.m_u + vertices[tri[2]][axis] * hit.m_v;
+        const float from_ray = ray.value.m_origin[axis] +
+                               ray.value.m_direction[axis] * hit.m_distance;
+        BOOST_TEST(fabsf(from_barycentric - from_ray) <= kTolerance);
+      }
+    }
+  }
+  BOOST_TEST(hit_count > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(ray_hit_respects_max_distance) {
+  boundingsphere_t sphere;
+  VectorSetVector(sphere.m_centerPt, 0.f, 0.f, 10.f);
+  sphere.m_radius = 1.f;
+  ray_t ray = {{0.f, 0.f, 0.f, 1.f}, {0.f, 0.f, 1.f, 0.f}};
+
+  rayhit_t hit;
+  RayHitReset(hit, 5.f);
+  BOOST_TEST(!RayIntersectSpheres(ray, &sphere, 1, hit));
+  BOOST_TEST(hit.m_index == kRayHitNone);
+
+  RayHitReset(hit, 50.f);
+  BOOST_TEST(RayIntersectSpheres(ray, &sphere, 1, hit));
+  BOOST_TEST(hit.m_distance == 9.f, boost::test_tools::tolerance(1e-5f));
+}
+
+BOOST_AUTO_TEST_CASE(ray_packets_match_single_rays) {
+  Scene scene;
+  const vertex_t *vertices = scene.Vertices();
+  const uint32_t ray_count = static_cast<uint32_t>(scene.rays.size());
+
+  for (uint32_t first = 0; first < ray_count; first += 4) {
+    const uint32_t lanes = ray_count - first < 4 ? ray_count - first : 4;
+    ray_t rays[4];
+    for (uint32_t i = 0; i < lanes; ++i) {
+      rays[i] = scene.rays[first + i].value;
+    }
+    raypacket_t packet;
+    RayPacketFromRays(rays, lanes, packet);
+
+    rayhit_t sphere_hits[4], box_hits[4], triangle_hits[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+      RayHitReset(sphere_hits[i]);
+      RayHitReset(box_hits[i]);
+      RayHitReset(triangle_hits[i]);
+    }
+    for (uint32_t i = 0; i < scene.spheres.size(); ++i) {
+      RayPacketIntersectSphere(packet, scene.spheres[i], i, sphere_hits);
+      RayPacketIntersectAABB(packet, scene.boxes[i], i, box_hits);
+    }
+    for (uint32_t i = 0; i < scene.TriangleCount(); ++i) {
+      const uint32_t *tri = &scene.indices[i * 3];
+      RayPacketIntersectTriangle(packet, vertices[tri[0]], vertices[tri[1]],
+                                 vertices[tri[2]], i, triangle_hits);
+    }
+
+    for (uint32_t i = 0; i < lanes; ++i) {
+      rayhit_t hit;
+      RayHitReset(hit);
+      RayIntersectSpheres(rays[i], scene.spheres.data(),
+                          static_cast<uint32_t>(scene.spheres.size()), hit);
+      BOOST_TEST(sphere_hits[i].m_index == hit.m_index);
+
+      RayHitReset(hit);
+      RayIntersectAABBs(rays[i], scene.boxes.data(),
+                        static_cast<uint32_t>(scene.boxes.size()), hit);
+      BOOST_TEST(box_hits[i].m_index == hit.m_index);
+
+      RayHitReset(hit);
+      RayIntersectTriangles(rays[i], vertices, scene.indices.data(),
+                            scene.TriangleCount(), hit);
+      BOOST_TEST(triangle_hits[i].m_index == hit.m_index);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "test_helpers.h"
+#include "xbox_math_spatial_hash.h"
+
+using namespace XboxMath;
+using namespace XboxMathTest;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_spatial_hash_suite)
+
+namespace {
+
+// Objects tracked alongside a grid, for brute force comparisons.
+struct Scene {
+  CSpatialHashGrid grid{2.f, 64};  // Few buckets, so cells share them.
+  std::vector<float> centers;      // 4 floats per handle.
+  std::vector<float> radii;
+  std::vector<bool> live;
+  CRandom random{7};
+
+  void RandomPoint(vertex_t &point) {
+    point[0] = random(-20.f, 20.f);
+    point[1] = random(-20.f, 20.f);
+    point[2] = random(-5.f, 5.f);
+    point[3] = 1.f;
+  }
+
+  const vertex_t &Center(uint32_t handle) const {
+    return *reinterpret_cast<const vertex_t *>(&centers[handle * 4]);
+  }
+
+  void Insert(float radius) {
+    vertex_t center;
+    RandomPoint(center);
+    const uint32_t handle = grid.Insert(center, radius);
+    if (handle >= live.size()) {
+      centers.resize((handle + 1) * 4);
+      radii.resize(handle + 1);
+      live.resize(handle + 1);
+    }
+    BOOST_TEST(!live[handle]);
+    std::copy_n(center, 4, &centers[handle * 4]);
+    radii[handle] = radius;
+    live[handle] = true;
+  }
+
+  void Move(uint32_t handle) {
+    vertex_t center;
+    std::copy_n(Center(handle), 4, center);
+    // Mostly small steps within a cell, sometimes jumps.
+    const float step = handle % 3 == 0 ? 10.f : 0.3f;
+    for (uint32_t i = 0; i < 3; ++i) {
+      center[i] += random(-step, step);
+    }
+    grid.Move(handle, center);
+    std::copy_n(center, 4, &centers[handle * 4]);
+  }
+
+  void CheckQueries(const vertex_t &point) {
+    std::vector<uint32_t> results;
+    std::vector<uint32_t> expected;
+    for (float radius : {0.f, 0.5f, 3.f, 12.f, 100.f}) {
+      grid.QueryRadius(point, radius, results);
+      expected.clear();
+      for (uint32_t handle = 0; handle < live.size(); ++handle) {
+        const float reach = radius + radii[handle];
+        if (live[handle] && PointDistanceSquaredPoint(point, Center(handle)) <=
+                                reach * reach) {
+          expected.push_back(handle);
+        }
+      }
+      std::sort(results.begin(), results.end());
+      BOOST_TEST(results == expected);
+    }
+
+    std::vector<std::pair<float, uint32_t>> by_distance;
+    for (uint32_t handle = 0; handle < live.size(); ++handle) {
+      if (live[handle]) {
+        by_distance.emplace_back(
+            PointDistanceSquaredPoint(point, Center(handle)), handle);
+      }
+    }
+    std::sort(by_distance.begin(), by_distance.end());
+    for (uint32_t k : {1u, 5u, 40u, 1000u}) {
+      const uint32_t found = grid.QueryNearest(point, k, results);
+      BOOST_TEST(found == std::min<size_t>(k, by_distance.size()));
+      BOOST_TEST(results.size() == found);
+      for (uint32_t i = 0; i < results.size(); ++i) {
+        // Compare distances, since ties may be ordered either way.
+        BOOST_TEST(PointDistanceSquaredPoint(point, Center(results[i])) ==
+                   by_distance[i].first);
+      }
+    }
+  }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(points) {
+  Scene scene;
+  for (uint32_t i = 0; i < 300; ++i) {
+    scene.Insert(0.f);
+  }
+  BOOST_TEST(scene.grid.GetObjectCount() == 300u);
+  vertex_t point;
+  for (uint32_t i = 0; i < 10; ++i) {
+    scene.RandomPoint(point);
+    scene.CheckQueries(point);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(spheres) {
+  Scene scene;
+  for (uint32_t i = 0; i < 200; ++i) {
+    scene.Insert(scene.random(0.f, 3.f));
+  }
+  vertex_t point;
+  for (uint32_t i = 0; i < 10; ++i) {
+    scene.RandomPoint(point);
+    scene.CheckQueries(point);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(move_and_remove) {
+  Scene scene;
+  for (uint32_t i = 0; i < 200; ++i) {
+    scene.Insert(0.5f);
+  }
+  for (uint32_t frame = 0; frame < 5; ++frame) {
+    for (uint32_t handle = 0; handle < scene.live.size(); ++handle) {
+      if (scene.live[handle]) {
+        scene.Move(handle);
+      }
+    }
+    for (uint32_t handle = frame; handle < scene.live.size(); handle += 7) {
+      if (scene.live[handle]) {
+        scene.grid.Remove(handle);
+        scene.live[handle] = false;
+      }
+    }
+    // Reuses the removed handles.
+    for (uint32_t i = 0; i < 10; ++i) {
+      scene.Insert(0.5f);
+    }
+    BOOST_TEST(scene.live.size() == 200u);
+    BOOST_TEST(scene.grid.GetObjectCount() ==
+               std::count(scene.live.begin(), scene.live.end(), true));
+
+    vertex_t point;
+    scene.RandomPoint(point);
+    scene.CheckQueries(point);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(far_from_everything) {
+  Scene scene;
+  for (uint32_t i = 0; i < 50; ++i) {
+    scene.Insert(0.f);
+  }
+  const vertex_t point{1e6f, -1e6f, 3e5f, 1.f};
+  scene.CheckQueries(point);
+}
+
+BOOST_AUTO_TEST_CASE(clear) {
+  Scene scene;
+  for (uint32_t i = 0; i < 50; ++i) {
+    scene.Insert(1.f);
+  }
+  scene.grid.Clear();
+  BOOST_TEST(scene.grid.GetObjectCount() == 0u);
+  std::vector<uint32_t> results;
+  const vertex_t point{0.f, 0.f, 0.f, 1.f};
+  BOOST_TEST(scene.grid.QueryRadius(point, 100.f, results) == 0u);
+  BOOST_TEST(scene.grid.QueryNearest(point, 3, results) == 0u);
+  BOOST_TEST(scene.grid.Insert(point) == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
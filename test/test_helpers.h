@@ -0,0 +1,48 @@
+#ifndef XBOX_MATH_TEST_HELPERS_H_
+#define XBOX_MATH_TEST_HELPERS_H_
+
+#include <cstdint>
+
+#include "xbox_math_types.h"
+
+//! Helpers shared by the test suites.
+namespace XboxMathTest {
+
+//! A linear congruential generator, so that randomized tests see the same
+//! values with every compiler and standard library.
+class CRandom {
+ public:
+  explicit CRandom(uint32_t seed) : m_seed(seed) {}
+
+  //! Advances the generator and returns its state. The high bits are the most
+  //! random.
+  uint32_t NextBits() {
+    m_seed = m_seed * 1664525u + 1013904223u;
+    return m_seed;
+  }
+
+  //! Returns a value in [`low`, `high`).
+  float operator()(float low, float high) {
+    return low +
+           (high - low) * static_cast<float>(NextBits() >> 8) / 16777216.f;
+  }
+
+ private:
+  uint32_t m_seed;
+};
+
+//! Returns the sphere of `radius` about (`x`, `y`, `z`).
+inline XboxMath::boundingsphere_t Sphere(float x, float y, float z,
+                                         float radius) {
+  XboxMath::boundingsphere_t ret;
+  ret.m_centerPt[0] = x;
+  ret.m_centerPt[1] = y;
+  ret.m_centerPt[2] = z;
+  ret.m_centerPt[3] = 1.f;
+  ret.m_radius = radius;
+  return ret;
+}
+
+}  // namespace XboxMathTest
+
+#endif  // XBOX_MATH_TEST_HELPERS_H_
@@ -24,6 +24,15 @@ BOOST_AUTO_TEST_CASE(point_distance_point) {
              boost::test_tools::tolerance(TOLERANCE));
 }
 
+BOOST_AUTO_TEST_CASE(point_distance_squared_point) {
+  vector_t vec1{1.f, 0.2f, 0.3f, 1.f};
+  vector_t vec2{-0.75f, 0.124f, -0.99f, 1.f};
+
+  float result = PointDistanceSquaredPoint(vec1, vec2);
+
+  BOOST_TEST(result == 4.732376f, boost::test_tools::tolerance(TOLERANCE));
+}
+
 BOOST_AUTO_TEST_CASE(plane_find_normal) {
   vector_t vec1{0.9517f, 0.3829f, -0.987f, 1.f};
   vector_t vec2{-0.8828f, 0.5937f, 0.620f, 1.f};
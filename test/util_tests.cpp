@@ -1,6 +1,7 @@
 #include <boost/test/data/monomorphic.hpp>
 #include <boost/test/data/test_case.hpp>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <cmath>
 
 #include "xbox_math_d3d.h"
@@ -322,6 +323,34 @@ BOOST_DATA_TEST_CASE(unproject_point,
               test_case.world_point[2], test_case.world_point[3]);
 }
 
+BOOST_DATA_TEST_CASE(unproject_point_closed_form_inverse,
+                     boost::unit_test::data::make(kUnprojectPointTestCases),
+                     test_case) {
+  matrix4_t inverse_model_view;
+  CreateD3DLookAtLHInverse(inverse_model_view, test_case.eye, test_case.at,
+                           test_case.up);
+
+  matrix4_t inverse_projection;
+  CreateD3DPerspectiveFOVLHInverse(inverse_projection, M_PI * 0.25f,
+                                   640.f / 480.f, 1.0f, 200.0f);
+  matrix4_t inverse_viewport;
+  CreateD3DViewportInverse(inverse_viewport, 640.f, 480.f, (float)0xFFFF, 0.0f,
+                           1.0f);
+  matrix4_t inverse_projection_viewport;
+  MatrixMultMatrix(inverse_viewport, inverse_projection,
+                   inverse_projection_viewport);
+
+  matrix4_t inverse;
+  BuildInverseCompositeMatrix(inverse_model_view, inverse_projection_viewport,
+                              inverse);
+
+  vector_t result;
+  UnprojectPoint(test_case.screen_point, inverse, result);
+
+  VECTOR_TEST(result, test_case.world_point[0], test_case.world_point[1],
+              test_case.world_point[2], test_case.world_point[3]);
+}
+
 const std::vector<ProjectUnprojectTestCase> kUnprojectPointWithZTestCases = {
     {{-0.3f, 1.25f, -5.f, 1.f},
      {0.f, 0.f, 0.f, 1.f},
@@ -363,4 +392,139 @@ BOOST_DATA_TEST_CASE(
               test_case.world_point[2], test_case.world_point[3]);
 }
 
+namespace {
+
+// Screen position of the view space point (`x`, `y`, `z`).
+void ProjectViewPoint(const matrix4_t &projection_viewport, float x, float y,
+                      float z, float &screen_x, float &screen_y,
+                      float &screen_z) {
+  vector_t point{x, y, z, 1.f};
+  vector_t result;
+  VectorMultMatrix(point, projection_viewport, result);
+  screen_x = result[0] / result[3];
+  screen_y = result[1] / result[3];
+  screen_z = result[2] / result[3];
+}
+
+// Bounds the projections of points sampled over the part of a view space
+// sphere in front of the near plane, including the circle where the near
+// plane cuts it.
+screenrect_t SampleSphereScreenRect(const matrix4_t &projection_viewport,
+                                    const float (&center)[3], float radius,
+                                    float z_near) {
+  screenrect_t ret = {1e30f, 1e30f, -1e30f, -1e30f, 1e30f, -1e30f};
+  auto add = [&](float x, float y, float z) {
+    float screen_x, screen_y, screen_z;
+    ProjectViewPoint(projection_viewport, x, y, z, screen_x, screen_y,
+                     screen_z);
+    ret.m_minX = std::min(ret.m_minX, screen_x);
+    ret.m_minY = std::min(ret.m_minY, screen_y);
+    ret.m_maxX = std::max(ret.m_maxX, screen_x);
+    ret.m_maxY = std::max(ret.m_maxY, screen_y);
+    ret.m_minZ = std::min(ret.m_minZ, screen_z);
+    ret.m_maxZ = std::max(ret.m_maxZ, screen_z);
+  };
+  constexpr uint32_t kSteps = 720;
+  const float near_offset = z_near - center[2];
+  const float near_radius =
+      sqrtf(std::max(radius * radius - near_offset * near_offset, 0.f));
+  for (uint32_t i = 0; i <= kSteps; ++i) {
+    const float theta = M_PI * static_cast<float>(i) / kSteps;
+    for (uint32_t j = 0; j < 2 * kSteps; ++j) {
+      const float phi = M_PI * static_cast<float>(j) / kSteps;
+      const float z = center[2] + radius * cosf(theta);
+      if (z >= z_near) {
+        add(center[0] + radius * sinf(theta) * cosf(phi),
+            center[1] + radius * sinf(theta) * sinf(phi), z);
+      }
+      if (i == 0 && near_radius > 0.f) {
+        add(center[0] + near_radius * cosf(phi),
+            center[1] + near_radius * sinf(phi), z_near);
+      }
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(bounding_sphere_screen_rects_perspective) {
+  constexpr float kNear = 1.f;
+  vector_t eye{1.f, 2.f, -3.f, 1.f};
+  vector_t at{0.f, 0.f, 10.f, 1.f};
+  vector_t up{0.f, 1.f, 0.f, 1.f};
+  matrix4_t view;
+  CreateD3DLookAtLH(view, eye, at, up);
+  matrix4_t inverse_view;
+  MatrixInvert(view, inverse_view);
+  matrix4_t projection;
+  CreateD3DPerspectiveFOVLH(projection, M_PI / 3.f, 640.f / 480.f, kNear,
+                            100.f);
+  matrix4_t viewport;
+  CreateD3DViewport(viewport, 640, 480, 1.f, 0.f, 1.f);
+  matrix4_t projection_viewport;
+  MatrixMultMatrix(projection, viewport, projection_viewport);
+  matrix4_t composite;
+  BuildCompositeMatrix(view, projection_viewport, composite);
+
+  // View space centers and radii.
+  const float kSpheres[][4] = {
+      {0.f, 0.f, 10.f, 1.f},    // Straight ahead.
+      {6.f, -3.f, 12.f, 2.f},   // Off axis.
+      {-30.f, 5.f, 8.f, 3.f},   // Off screen.
+      {0.5f, 0.5f, 1.5f, 1.f},  // Crossing the near plane.
+      {3.f, 1.f, 0.f, 1.5f},    // Crossing the near plane beside the eye.
+      {0.f, 0.f, 0.5f, 2.f},    // Containing the eye.
+      {0.f, 1.f, -5.f, 2.f},    // Behind the near plane.
+  };
+  constexpr uint32_t kCount = sizeof(kSpheres) / sizeof(kSpheres[0]);
+  boundingsphere_t spheres[kCount];
+  for (uint32_t i = 0; i < kCount; ++i) {
+    vector_t center{kSpheres[i][0], kSpheres[i][1], kSpheres[i][2], 1.f};
+    vector_t world;
+    VectorMultMatrix(center, inverse_view, world);
+    std::copy(world, world + 4, spheres[i].m_centerPt);
+    spheres[i].m_radius = kSpheres[i][3];
+  }
+
+  screenrect_t rects[kCount];
+  BOOST_TEST(BoundingSphereScreenRectsPerspective(spheres, kCount, view,
+                                                  projection, viewport,
+                                                  rects) == kCount - 1);
+
+  for (uint32_t i = 0; i + 1 < kCount; ++i) {
+    const float center[3] = {kSpheres[i][0], kSpheres[i][1], kSpheres[i][2]};
+    const screenrect_t expected = SampleSphereScreenRect(
+        projection_viewport, center, kSpheres[i][3], kNear);
+    const screenrect_t &rect = rects[i];
+    // Conservative, and tight up to the sampling density.
+    const float tolerance =
+        0.01f * std::max(expected.m_maxX - expected.m_minX, 1.f);
+    BOOST_TEST(rect.m_minX <= expected.m_minX + 1e-3f);
+    BOOST_TEST(rect.m_minY <= expected.m_minY + 1e-3f);
+    BOOST_TEST(rect.m_maxX >= expected.m_maxX - 1e-3f);
+    BOOST_TEST(rect.m_maxY >= expected.m_maxY - 1e-3f);
+    BOOST_TEST(rect.m_minX >= expected.m_minX - tolerance);
+    BOOST_TEST(rect.m_minY >= expected.m_minY - tolerance);
+    BOOST_TEST(rect.m_maxX <= expected.m_maxX + tolerance);
+    BOOST_TEST(rect.m_maxY <= expected.m_maxY + tolerance);
+    BOOST_TEST(rect.m_minZ == expected.m_minZ,
+               boost::test_tools::tolerance(kTolerance));
+    BOOST_TEST(rect.m_maxZ == expected.m_maxZ,
+               boost::test_tools::tolerance(kTolerance));
+  }
+  BOOST_TEST(rects[kCount - 1].m_minX > rects[kCount - 1].m_maxX);
+  BOOST_TEST(rects[kCount - 1].m_minY > rects[kCount - 1].m_maxY);
+
+  // Never looser than the rect of the sphere's bounding box.
+  for (uint32_t i = 0; i < 3; ++i) {
+    screenrect_t box_rect;
+    BOOST_TEST(BoundingSphereScreenRect(spheres[i], composite, box_rect));
+    BOOST_TEST(rects[i].m_minX >= box_rect.m_minX - 1e-3f);
+    BOOST_TEST(rects[i].m_minY >= box_rect.m_minY - 1e-3f);
+    BOOST_TEST(rects[i].m_maxX <= box_rect.m_maxX + 1e-3f);
+    BOOST_TEST(rects[i].m_maxY <= box_rect.m_maxY + 1e-3f);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,231 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "xbox_math_vector.h"
+#include "xbox_math_vector_stream.h"
+
+using namespace XboxMath;
+
+BOOST_AUTO_TEST_SUITE(xbox_math_vector_stream_suite)
+
+static constexpr auto kTolerance = 1e-5f;
+// Not a multiple of 4.
+static constexpr uint32_t kCount = 7;
+
+#define VECTOR_TEST(v, e)                                                 \
+  BOOST_TEST((v)[0] == (e)[0], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[1] == (e)[1], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[2] == (e)[2], boost::test_tools::tolerance(kTolerance)); \
+  BOOST_TEST((v)[3] == (e)[3], boost::test_tools::tolerance(kTolerance))
+
+namespace {
+
+// Vectors with w = 1, as the single vector functions expect.
+std::vector<float> TestVectors(float offset) {
+  std::vector<float> ret;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    const auto f = static_cast<float>(i) + offset;
+    ret.insert(ret.end(), {sinf(f) * 3.f, cosf(f * 1.3f) * 2.f, f * 0.5f, 1.f});
+  }
+  return ret;
+}
+
+const vector_t *Vectors(const std::vector<float> &storage) {
+  return reinterpret_cast<const vector_t *>(storage.data());
+}
+
+bool IsAligned(const float *p) {
+  return (reinterpret_cast<uintptr_t>(p) & 15) == 0;
+}
+
+void TestLayout(const CVectorStream &stream) {
+  BOOST_TEST(stream.GetPaddedCount() % 4 == 0u);
+  BOOST_TEST(stream.GetPaddedCount() >= stream.GetCount());
+  BOOST_TEST(IsAligned(stream.GetX()));
+  BOOST_TEST(IsAligned(stream.GetY()));
+  BOOST_TEST(IsAligned(stream.GetZ()));
+  BOOST_TEST(IsAligned(stream.GetW()));
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(convert_vectors) {
+  const std::vector<float> input = TestVectors(0.f);
+  CVectorStream stream;
+  stream.SetVectors(Vectors(input), kCount);
+  BOOST_TEST(stream.GetCount() == kCount);
+  BOOST_TEST(stream.GetPaddedCount() == 8u);
+  TestLayout(stream);
+  BOOST_TEST(stream.GetY()[3] == Vectors(input)[3][1]);
+
+  std::vector<float> output(input.size());
+  stream.GetVectors(reinterpret_cast<vector_t *>(output.data()));
+  BOOST_TEST(output == input, boost::test_tools::per_element());
+
+  const vector_t v = {1.f, 2.f, 3.f, 4.f};
+  stream.SetVector(5, v);
+  vector_t ret;
+  stream.GetVector(5, ret);
+  VECTOR_TEST(ret, v);
+  BOOST_TEST(stream.GetW()[5] == 4.f);
+}
+
+BOOST_AUTO_TEST_CASE(resize_copy_and_move) {
+  const std::vector<float> input = TestVectors(1.f);
+  CVectorStream stream(2);
+  const vector_t identity = {0.f, 0.f, 0.f, 1.f};
+  vector_t ret;
+  stream.GetVector(1, ret);
+  VECTOR_TEST(ret, identity);
+
+  stream.SetVectors(Vectors(input), kCount);
+  stream.Resize(kCount + 6);
+  TestLayout(stream);
+  for (uint32_t i = 0; i < kCount + 6; ++i) {
+    stream.GetVector(i, ret);
+    VECTOR_TEST(ret, i < kCount ? Vectors(input)[i] : identity);
+  }
+  stream.Resize(3);
+  stream.GetVector(2, ret);
+  VECTOR_TEST(ret, Vectors(input)[2]);
+
+  CVectorStream copy(stream);
+  TestLayout(copy);
+  BOOST_TEST(copy.GetCount() == 3u);
+  copy.GetVector(2, ret);
+  VECTOR_TEST(ret, Vectors(input)[2]);
+
+  CVectorStream moved(std::move(copy));
+  TestLayout(moved);
+  moved.GetVector(1, ret);
+  VECTOR_TEST(ret, Vectors(input)[1]);
+  BOOST_TEST(copy.GetCount() == 0u);
+
+  copy = moved;
+  copy.GetVector(0, ret);
+  VECTOR_TEST(ret, Vectors(input)[0]);
+}
+
+BOOST_AUTO_TEST_CASE(batch_operations) {
+  const std::vector<float> a_input = TestVectors(0.f);
+  const std::vector<float> b_input = TestVectors(5.f);
+  const vector_t *a_vectors = Vectors(a_input);
+  const vector_t *b_vectors = Vectors(b_input);
+  CVectorStream a, b, ret;
+  a.SetVectors(a_vectors, kCount);
+  b.SetVectors(b_vectors, kCount);
+
+  vector_t expected, actual;
+  VectorsAddVectors(a, b, ret);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    VectorAddVector(a_vectors[i], b_vectors[i], expected);
+    expected[3] = a_vectors[i][3];
+    ret.GetVector(i, actual);
+    VECTOR_TEST(actual, expected);
+  }
+
+  VectorsSubtractVectors(a, b, ret);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    VectorSubtractVector(a_vectors[i], b_vectors[i], expected);
+    expected[3] = a_vectors[i][3];
+    ret.GetVector(i, actual);
+    VECTOR_TEST(actual, expected);
+  }
+
+  ScalarMultVectors(a, -2.5f, ret);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    ScalarMultVector(a_vectors[i], -2.5f, expected);
+    expected[3] = a_vectors[i][3];
+    ret.GetVector(i, actual);
+    VECTOR_TEST(actual, expected);
+  }
+
+  VectorsCrossVectors(a, b, ret);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    VectorCrossVector(a_vectors[i], b_vectors[i], expected);
+    expected[3] = a_vectors[i][3];
+    ret.GetVector(i, actual);
+    VECTOR_TEST(actual, expected);
+  }
+
+  VectorsNormalize(a, ret);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    VectorNormalize(a_vectors[i], expected);
+    expected[3] = a_vectors[i][3];
+    ret.GetVector(i, actual);
+    VECTOR_TEST(actual, expected);
+  }
+
+  float values[kCount];
+  VectorsDotVectors(a, b, values);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    BOOST_TEST(values[i] == VectorDotVector(a_vectors[i], b_vectors[i]),
+               boost::test_tools::tolerance(kTolerance));
+  }
+  VectorsLength(a, values);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    BOOST_TEST(values[i] == VectorLength(a_vectors[i]),
+               boost::test_tools::tolerance(kTolerance));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batch_operations_in_place) {
+  const std::vector<float> a_input = TestVectors(0.f);
+  const std::vector<float> b_input = TestVectors(2.f);
+  CVectorStream a, b;
+  a.SetVectors(Vectors(a_input), kCount);
+  b.SetVectors(Vectors(b_input), kCount);
+
+  VectorsCrossVectors(a, b, a);
+  VectorsNormalize(a, a);
+  vector_t expected, actual;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    VectorCrossVector(Vectors(a_input)[i], Vectors(b_input)[i], expected);
+    VectorNormalize(expected);
+    expected[3] = 1.f;
+    a.GetVector(i, actual);
+    VECTOR_TEST(actual, expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(normalize_zero_length) {
+  CVectorStream stream(5);
+  const vector_t v = {3.f, 0.f, 4.f, 1.f};
+  stream.SetVector(4, v);
+  VectorsNormalize(stream, stream);
+
+  vector_t ret;
+  stream.GetVector(0, ret);
+  const vector_t zero = {0.f, 0.f, 0.f, 1.f};
+  VECTOR_TEST(ret, zero);
+  stream.GetVector(4, ret);
+  const vector_t expected = {0.6f, 0.f, 0.8f, 1.f};
+  VECTOR_TEST(ret, expected);
+}
+
+BOOST_AUTO_TEST_CASE(normalize_fast) {
+  const std::vector<float> input = TestVectors(3.f);
+  CVectorStream stream(kCount + 1);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    stream.SetVector(i, Vectors(input)[i]);
+  }
+  CVectorStream ret;
+  VectorsNormalizeFast(stream, ret);
+
+  vector_t expected, actual;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    VectorNormalize(Vectors(input)[i], expected);
+    expected[3] = 1.f;
+    ret.GetVector(i, actual);
+    VECTOR_TEST(actual, expected);
+  }
+  // The last vector is zero length.
+  ret.GetVector(kCount, actual);
+  const vector_t zero = {0.f, 0.f, 0.f, 1.f};
+  VECTOR_TEST(actual, zero);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
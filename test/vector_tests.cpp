@@ -1,9 +1,12 @@
 #include <boost/test/unit_test.hpp>
 #include <cmath>
+#include <vector>
 
+#include "test_helpers.h"
 #include "xbox_math_vector.h"
 
 using namespace XboxMath;
+using namespace XboxMathTest;
 
 BOOST_AUTO_TEST_SUITE(xbox_math_vector_suite)
 
@@ -97,6 +100,87 @@ BOOST_AUTO_TEST_CASE(vector_normalize_inplace) {
               -0.793149058366139f, 1.f);
 }
 
+BOOST_AUTO_TEST_CASE(vector_normalize_fast) {
+  vector_t vec2{-0.75f, 0.124f, -0.99f, 1.f};
+
+  vector_t result{0.f, 0.f, 0.f, 1.f};
+  VectorNormalizeFast(vec2, result);
+  VECTOR_TEST(result, -0.6008704987622265f, 0.09934392246202145f,
+              -0.793149058366139f, 1.f);
+
+  VectorNormalizeFastSafe(vec2, result);
+  VECTOR_TEST(result, -0.6008704987622265f, 0.09934392246202145f,
+              -0.793149058366139f, 1.f);
+
+  VectorNormalizeFast(vec2);
+  VECTOR_TEST(vec2, -0.6008704987622265f, 0.09934392246202145f,
+              -0.793149058366139f, 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(vector_normalize_fast_error_bound) {
+  // Vectors of lengths across most of the float range, against unit vectors
+  // computed in double precision.
+  CRandom random(5);
+  const double bound = ldexp(1.0, -21);
+  for (uint32_t i = 0; i < 100000; ++i) {
+    const float scale = powf(10.f, random(-15.f, 15.f));
+    vector_t v{random(-scale, scale), random(-scale, scale),
+               random(-scale, scale), 1.f};
+    const double length =
+        sqrt(static_cast<double>(v[0]) * v[0] +
+             static_cast<double>(v[1]) * v[1] +
+             static_cast<double>(v[2]) * v[2]);
+    vector_t result;
+    VectorNormalizeFast(v, result);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      BOOST_TEST(fabs(result[axis] - v[axis] / length) <= bound);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(vector_normalize_fast_safe_zero_length) {
+  vector_t zero{0.f, 0.f, 0.f, 1.f};
+  VectorNormalizeFastSafe(zero);
+  VECTOR_TEST(zero, 0.f, 0.f, 0.f, 1.f);
+
+  // Its squared length underflows.
+  const vector_t tiny{1e-30f, -1e-30f, 0.f, 1.f};
+  vector_t result{5.f, 5.f, 5.f, 1.f};
+  VectorNormalizeFastSafe(tiny, result);
+  VECTOR_TEST(result, 0.f, 0.f, 0.f, 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(vectors_normalize_fast) {
+  // Not a multiple of 4, with a zero vector.
+  std::vector<float> storage = {3.f,  0.f,  4.f,   1.f, 0.f,   0.f, 0.f,
+                                1.f,  1.f,  2.f,   2.f, 1.f,   -5.f, 0.f,
+                                0.f,  1.f,  0.1f, -0.2f, 0.3f, 1.f, 1e3f,
+                                1e4f, 1e5f, 1.f,  7.f,  -1.f,  2.f, 1.f};
+  const auto *vectors = reinterpret_cast<const vector_t *>(storage.data());
+  std::vector<float> ret_storage(storage.size());
+  auto *ret = reinterpret_cast<vector_t *>(ret_storage.data());
+  VectorsNormalizeFast(vectors, 7, ret);
+  // Against unit vectors computed in double precision, as in
+  // vector_normalize_fast_error_bound.
+  const double bound = ldexp(1.0, -21);
+  for (uint32_t i = 0; i < 7; ++i) {
+    const double length =
+        sqrt(static_cast<double>(vectors[i][0]) * vectors[i][0] +
+             static_cast<double>(vectors[i][1]) * vectors[i][1] +
+             static_cast<double>(vectors[i][2]) * vectors[i][2]);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      const double expected = length > 0.0 ? vectors[i][axis] / length : 0.0;
+      BOOST_TEST(fabs(ret[i][axis] - expected) <= bound);
+    }
+    BOOST_TEST(ret[i][3] == vectors[i][3]);
+  }
+
+  // In place.
+  VectorsNormalizeFast(reinterpret_cast<vector_t *>(storage.data()), 7,
+                       reinterpret_cast<vector_t *>(storage.data()));
+  BOOST_TEST(storage == ret_storage, boost::test_tools::per_element());
+}
+
 BOOST_AUTO_TEST_CASE(vector_dot_vector) {
   vector_t vec1{1.f, 0.2f, 0.3f, 1.f};
   vector_t vec2{-0.75f, 0.124f, -0.99f, 1.f};